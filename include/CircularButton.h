@@ -5,6 +5,7 @@
 #include <wx/dcbuffer.h>
 #include <functional>
 #include <string>
+#include "dwelldetector.h"
 
 /**
  * @brief Circular button with dwell-time progress arc (mimics HeyEyeControl EyeButton)
@@ -35,7 +36,7 @@ public:
     std::function<void()> OnActivated;
 
     // Properties
-    wxString GetLabel() const { return m_label; }
+    const wxString& GetLabel() const { return m_label; }
     void SetLabel(const wxString& label) { m_label = label; }
 
     wxPoint GetPosition() const { return m_position; }
@@ -44,7 +45,7 @@ public:
     wxSize GetSize() const { return m_size; }
     void SetSize(const wxSize& size) { m_size = size; }
 
-    float GetProgress() const { return m_progress; }
+    float GetProgress() const { return m_progress.Get(); }
 
     bool IsSelected() const { return m_isSelected; }
     void SetSelected(bool selected) { m_isSelected = selected; }
@@ -53,7 +54,7 @@ private:
     wxString m_label;
     wxPoint m_position;  // Center of the circle
     wxSize m_size;       // Default 120x120 like EyeButton
-    float m_progress;    // 0.0 to 1.0
+    DwellProgress m_progress;  // 0.0 to 1.0
     bool m_isSelected;   // For special highlighting (e.g., scroll mode)
 };
 
@@ -0,0 +1,67 @@
+#ifndef AUDIOSTREAM_H
+#define AUDIOSTREAM_H
+
+#include <wx/wx.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Streaming 16-bit mono PCM output (waveOut on Windows)
+ *
+ * Samples are copied into a small ring of device buffers and queued as soon
+ * as a buffer is full, so playback starts with the first synthesized chunk
+ * instead of after the whole utterance. At most BUFFER_COUNT * BUFFER_MS of
+ * audio is queued ahead: Write() blocks the producer while every buffer is
+ * playing, which keeps memory bounded and makes Reset() cut off quickly.
+ *
+ * Features:
+ * - No temporary files, no per-utterance allocation
+ * - Reset() from any thread stops playback immediately and releases a
+ *   blocked Write()
+ *
+ * One producer thread calls Write/Flush, Reset may come from another one.
+ */
+class AudioStream
+{
+public:
+    static const int BUFFER_MS = 20;
+    static const size_t BUFFER_COUNT = 16;  // 320 ms queued ahead at most
+
+    AudioStream();
+    ~AudioStream();
+
+    // False on platforms without a streaming backend
+    static bool IsSupported();
+
+    bool Open(int sampleRate);
+    void Close();  // The producer must be stopped first
+    bool IsOpen() const;
+
+    // Generation of the current utterance, captured by the producer before it
+    // starts writing (serialized with Reset by the caller)
+    uint64_t GetGeneration() const { return m_generation.load(); }
+
+    // Queue samples for playback. Returns false, queuing nothing more, once a
+    // Reset() came after generation was captured.
+    bool Write(const int16_t* samples, size_t count, uint64_t generation);
+
+    // Queue the partially filled buffer (end of an utterance), unless reset
+    void Flush(uint64_t generation);
+
+    // Stop playback now and drop everything queued
+    void Reset();
+
+private:
+    struct Device;  // Platform handles and buffers
+
+    bool SubmitCurrent();  // Queue the buffer being filled (m_deviceMutex held)
+
+    std::unique_ptr<Device> m_device;
+    std::mutex m_deviceMutex;            // Serializes device calls between Write and Reset
+    std::atomic<uint64_t> m_generation;  // Incremented by Reset, aborts blocked writers
+};
+
+#endif // AUDIOSTREAM_H
@@ -0,0 +1,94 @@
+#ifndef CANDIDATEBATCH_H
+#define CANDIDATEBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ranker input columns. CRITICAL: order must match feature_list.json from training EXACTLY!
+enum RankingFeature {
+    FEATURE_DTW_RAW = 0,
+    FEATURE_DTW_NORMALIZED_BY_MAX,
+    FEATURE_DTW_NORMALIZED_BY_MIN,
+    FEATURE_DTW_NORMALIZED_BY_SUM,
+    FEATURE_LEN_SWIPE,
+    FEATURE_LEN_WORD,
+    FEATURE_PATH_LENGTH_RATIO,
+    FEATURE_WORD_LENGTH,
+    FEATURE_LM_SCORE,
+    FEATURE_FAISS_DISTANCE,
+    FEATURE_FAISS_RANK,              // 10
+    FEATURE_DTW_DISTANCE,
+    FEATURE_DTW_RANK,
+    FEATURE_LM_NORMALIZED,
+    FEATURE_FAISS_NORMALIZED,
+    FEATURE_DTW_NORMALIZED,
+    FEATURE_LM_ZSCORE,
+    FEATURE_FAISS_ZSCORE,
+    FEATURE_DTW_ZSCORE,
+    FEATURE_LM_GAP_TO_BEST,
+    FEATURE_FAISS_GAP_TO_BEST,       // 20
+    FEATURE_DTW_GAP_TO_BEST,
+    FEATURE_LM_PERCENTILE,
+    FEATURE_FAISS_PERCENTILE,
+    FEATURE_DTW_PERCENTILE,
+    FEATURE_RANK_AGREEMENT,
+    FEATURE_MIN_RANK,
+    FEATURE_IS_TOP_FAISS,
+    FEATURE_IS_TOP_DTW,
+    FEATURE_IS_TOP_IN_BOTH,
+    FEATURE_LOG_FAISS_DISTANCE,      // 30
+    FEATURE_LOG_DTW_DISTANCE,
+    FEATURE_INV_FAISS_DISTANCE,
+    FEATURE_INV_DTW_DISTANCE,
+    FEATURE_FAISS_RANK_RECIPROCAL,
+    FEATURE_DTW_RANK_RECIPROCAL,
+    FEATURE_LM_FAISS_INTERACTION,
+    FEATURE_LM_DTW_INTERACTION,
+    FEATURE_FAISS_DTW_INTERACTION,
+    FEATURE_COUNT                    // 39
+};
+
+/**
+ * @brief Ranker input of one swipe: a row-major float32 feature matrix
+ *
+ * One row of FEATURE_COUNT values per candidate word, in the column order
+ * of the trained model, so the matrix goes to the ranker as is. Integer
+ * features (lengths, ranks) are stored as floats, exact in this range.
+ *
+ * Features:
+ * - compute_all_features() writes the rows in place, no per-candidate objects
+ * - Clear() keeps the capacity: a batch reused across swipes stops allocating
+ *   once it has seen the largest candidate count
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class CandidateBatch
+{
+public:
+    CandidateBatch() {}
+
+    // Remove all rows, keep the memory
+    void Clear();
+
+    // Append a zeroed row for a vocabulary word, returns its index
+    size_t AddRow(uint32_t wordId);
+
+    size_t GetRowCount() const { return m_wordIds.size(); }
+    bool IsEmpty() const { return m_wordIds.empty(); }
+
+    uint32_t GetWordId(size_t row) const { return m_wordIds[row]; }
+
+    float* GetRow(size_t row) { return &m_values[row * FEATURE_COUNT]; }
+    const float* GetRow(size_t row) const { return &m_values[row * FEATURE_COUNT]; }
+    float Get(size_t row, RankingFeature feature) const { return m_values[row * FEATURE_COUNT + feature]; }
+
+    // GetRowCount() x FEATURE_COUNT, row-major
+    const float* GetData() const { return m_values.data(); }
+
+private:
+    std::vector<float> m_values;
+    std::vector<uint32_t> m_wordIds;
+};
+
+#endif // CANDIDATEBATCH_H
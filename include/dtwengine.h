@@ -0,0 +1,86 @@
+#ifndef DTWENGINE_H
+#define DTWENGINE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief DTW between one swipe (the query) and many keyboard word paths
+ *
+ * Computes the same distance as dtw_multivariate(): Euclidean point cost,
+ * steps (1,0), (0,1), (1,1), Sakoe-Chiba band of max(window, |n - m|).
+ *
+ * Features:
+ * - Anti-diagonal kernel: the cells of one anti-diagonal are independent and
+ *   computed with SIMD (AVX2, SSE2 or NEON, scalar otherwise). Same operations
+ *   per cell as the scalar DP, so results are bit-identical when the compiler
+ *   does not contract a*a + b*b into FMA (MSVC /fp:precise, -ffp-contract=off)
+ * - The band really bounds the work (window < 0 keeps the legacy full matrix)
+ * - LB_Kim (first/last points) and LB_Keogh (per-column envelope of the query)
+ *   lower bounds to reject candidates before the DP
+ * - Early abandoning once two consecutive anti-diagonals exceed the threshold
+ *
+ * Not thread safe (scratch buffers are reused), use one engine per thread.
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class DtwEngine
+{
+public:
+    // Same "infinity" as dtw_multivariate, returned for rejected candidates
+    static const float INF;
+
+    struct Stats {
+        size_t computed;      // Full DP runs to the end
+        size_t prunedKim;     // Rejected by LB_Kim
+        size_t prunedKeogh;   // Rejected by LB_Keogh
+        size_t abandoned;     // DP stopped early
+
+        Stats() : computed(0), prunedKim(0), prunedKeogh(0), abandoned(0) {}
+    };
+
+    DtwEngine();
+
+    // Set the swipe all following distances are computed against.
+    // window is the Sakoe-Chiba half width in points, < 0 = unbounded.
+    void SetQuery(const std::vector<std::pair<float, float>>& query, int window = -1);
+    size_t GetQueryLength() const { return m_queryLength; }
+
+    // path holds m interleaved x, y points (Vocabulary::GetKeyPath layout)
+    float LowerBoundKim(const float* path, int m) const;
+    float LowerBoundKeogh(const float* path, int m);
+
+    // DTW distance, or INF as soon as it is known to exceed threshold
+    float Distance(const float* path, int m, float threshold = INF);
+
+    // Lower bounds first, then Distance(); INF when the candidate cannot beat threshold
+    float DistanceIfBelow(const float* path, int m, float threshold);
+
+    const Stats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = Stats(); }
+
+    // Instruction set of the compiled kernel ("AVX2", "SSE2", "NEON", "scalar")
+    static const char* GetKernelName();
+
+private:
+    // Query bounding boxes of every column j of a path of length m
+    const std::vector<float>& GetEnvelope(int m);
+    int GetBand(int m) const;
+
+    size_t m_queryLength;
+    int m_window;
+    std::vector<float> m_queryX;  // Padded for full-width vector loads
+    std::vector<float> m_queryY;
+
+    // Scratch (reused between candidates)
+    std::vector<float> m_pathX;   // Reversed path, padded
+    std::vector<float> m_pathY;
+    std::vector<float> m_diagonals[3];
+
+    // m -> 4 floats per column (min x, max x, min y, max y), built lazily
+    std::vector<std::vector<float>> m_envelopes;
+
+    Stats m_stats;
+};
+
+#endif // DTWENGINE_H
@@ -0,0 +1,62 @@
+#ifndef DTWPREFIXCACHE_H
+#define DTWPREFIXCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Last DTW row of every word path against a swipe that is still growing
+ *
+ * The unbounded DTW of dtw_multivariate() fills its matrix one swipe point
+ * (row) at a time, so the distance of a longer swipe continues from the last
+ * row of a shorter prefix. Partial predictions during the gesture leave their
+ * rows here; the final prediction only runs the rows of the points added
+ * since. Distances are bit-identical to dtw_multivariate() (same scalar DP).
+ *
+ * Features:
+ * - Prepare() checks that the swipe extends the cached prefix, the cache
+ *   resets itself on a new swipe
+ * - GetEntry() is serial; Extend() on distinct entries can run on several
+ *   threads (entries do not move when the map grows)
+ * - Banded DTW is not cached: its band depends on the final length
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class DtwPrefixCache
+{
+public:
+    // DP state of one word path after the first `points` swipe points
+    struct Entry {
+        std::vector<float> row;  // m + 1 cells of the last computed swipe row
+        size_t points;           // Swipe points the row has consumed
+        Entry() : points(0) {}
+    };
+
+    DtwPrefixCache() {}
+
+    // Forget every row (new swipe)
+    void Reset();
+
+    // Make the cache follow swipe: kept when swipe starts with the cached
+    // prefix, reset otherwise
+    void Prepare(const std::vector<std::pair<float, float>>& swipe);
+
+    // Entry of a word key, created on first use (not thread safe)
+    Entry& GetEntry(int64_t key) { return m_entries[key]; }
+
+    // Run the rows of the swipe points the entry has not seen yet. path holds
+    // m interleaved x, y points; returns the DTW distance of the whole swipe.
+    static float Extend(Entry& entry, const std::vector<std::pair<float, float>>& swipe, const float* path, int m);
+
+    size_t GetEntryCount() const { return m_entries.size(); }
+    size_t GetPrefixLength() const { return m_swipe.size(); }
+
+private:
+    std::vector<std::pair<float, float>> m_swipe;  // Points the entries were computed on
+    std::unordered_map<int64_t, Entry> m_entries;
+};
+
+#endif // DTWPREFIXCACHE_H
@@ -0,0 +1,124 @@
+#ifndef DWELLDETECTOR_H
+#define DWELLDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Sliding-window fixation detector for gaze dwell
+ *
+ * Keeps the samples of the last wait-time window and answers "did the gaze
+ * stay inside a radius x radius box for the whole window" in O(1).
+ *
+ * Features:
+ * - Ring buffer, no allocation while the window fits in it
+ * - Monotonic deques for running min/max on both axes (amortized O(1) per sample)
+ * - Time-based window (samples with age >= window are evicted)
+ * - A window holding more samples than the capacity doubles the ring instead
+ *   of dropping samples, so any tracker rate gives the exact result; size
+ *   the capacity for sample rate x longest wait time (CapacityFor) to keep
+ *   that off the gaze path
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class DwellDetector
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit DwellDetector(size_t capacity = 2048);
+
+    // Ring capacity holding windowUs of samples at sampleRateHz (with margin)
+    static size_t CapacityFor(uint64_t windowUs, float sampleRateHz);
+
+    // Window length in microseconds (usually the wait time setting)
+    void SetWindow(uint64_t windowUs) { m_windowUs = windowUs; }
+    uint64_t GetWindow() const { return m_windowUs; }
+
+    // Maximum extent (pixels) on each axis for the window to count as stable
+    void SetRadius(float pixels) { m_radius = pixels; }
+    float GetRadius() const { return m_radius; }
+
+    // Add a sample (timestamps in microseconds, non-decreasing) and evict expired ones
+    void AddSample(float x, float y, uint64_t timestamp);
+
+    // True when the window holds more than two samples and its bounding box
+    // is smaller than the radius on both axes
+    bool IsStable() const;
+
+    // Bounding box of the current window (undefined when empty)
+    float GetMinX() const;
+    float GetMaxX() const;
+    float GetMinY() const;
+    float GetMaxY() const;
+
+    // Time between the two newest samples (0 with fewer than two samples)
+    uint64_t GetLastDelta() const;
+
+    size_t GetSampleCount() const { return static_cast<size_t>(m_end - m_begin); }
+    size_t GetCapacity() const { return m_mask + 1; }
+    void Reset();
+
+private:
+    struct Sample {
+        float x;
+        float y;
+        uint64_t timestamp;
+    };
+
+    // Deque of sample sequence numbers whose values are monotonic
+    struct MonotonicQueue {
+        std::vector<uint64_t> seq;
+        uint64_t head;
+        uint64_t tail;
+    };
+
+    const Sample& At(uint64_t seq) const { return m_samples[seq & m_mask]; }
+    void EvictOldest();
+    void Grow();
+
+    static void QueueReset(MonotonicQueue& q);
+    template <typename Compare>
+    void QueuePush(MonotonicQueue& q, uint64_t seq, float value, float Sample::*axis, Compare dominated);
+    void QueueExpire(MonotonicQueue& q);
+
+    std::vector<Sample> m_samples;
+    size_t m_mask;
+    uint64_t m_begin;  // Sequence number of the oldest live sample
+    uint64_t m_end;    // One past the newest sample
+    uint64_t m_windowUs;
+    float m_radius;
+
+    MonotonicQueue m_minX;
+    MonotonicQueue m_maxX;
+    MonotonicQueue m_minY;
+    MonotonicQueue m_maxY;
+};
+
+/**
+ * @brief Dwell progress accumulator shared by buttons, keys and the cursor arc
+ *
+ * Progress is advanced by elapsed time over hold time and reports when the
+ * displayed value crossed a 5% step, so callers only repaint when needed.
+ */
+class DwellProgress
+{
+public:
+    DwellProgress() : m_progress(0.0f) {}
+
+    // Add elapsed/hold (same unit). Returns true if a 5% step was crossed
+    // or the progress completed.
+    bool Advance(float elapsed, float hold);
+
+    // Returns true if progress was non-zero (visual state changed)
+    bool Reset();
+
+    float Get() const { return m_progress; }
+    void Set(float progress) { m_progress = progress; }
+    bool IsComplete() const { return m_progress >= 1.0f; }
+
+private:
+    float m_progress;  // 0.0 to 1.0
+};
+
+#endif // DWELLDETECTOR_H
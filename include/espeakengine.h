@@ -3,14 +3,22 @@
 
 #include <wx/wx.h>
 #include <wx/thread.h>
-#include <vector>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <string>
+#include <thread>
+#include "audiostream.h"
 
 /**
  * @brief Text-to-speech engine using espeak-ng
  *
  * Provides French language speech synthesis for typed text.
- * Audio is generated by espeak-ng and played back through wxWidgets audio system.
+ * Synthesis runs on a worker thread. Where AudioStream is supported
+ * (Windows) each PCM chunk espeak produces is queued to the device as it
+ * arrives, so speech starts after the first chunk rather than at the end
+ * of the utterance; elsewhere espeak plays through its own audio output.
+ * No temporary files are written.
  */
 class ESpeakEngine
 {
@@ -27,13 +35,13 @@ public:
     // Check if initialized
     bool IsInitialized() const { return m_initialized; }
 
-    // Speak text (non-blocking)
+    // Speak text (non-blocking, replaces what is being spoken)
     void Speak(const wxString& text);
 
-    // Stop current speech
+    // Stop current speech (playback is cut immediately)
     void Stop();
 
-    // Settings
+    // Settings (applied from the next utterance)
     void SetVoice(const wxString& voiceName);
     void SetRate(int rate);  // 80-450 (default 175)
     void SetPitch(int pitch); // 0-99 (default 50)
@@ -44,26 +52,34 @@ private:
     // Note: espeak callback signature is: int callback(short *wav, int numsamples, espeak_EVENT *events)
     static int SynthCallback(short *wav, int numsamples, void* events);
 
-    // Instance callback handler
-    void HandleSynthCallback(short *wav, int numsamples);
+    // Instance callback handler, returns 1 to abort the synthesis
+    int HandleSynthCallback(short *wav, int numsamples);
 
-    // Audio playback
-    void PlayAudio();
+    void SpeechWorkerLoop();
+    void StopSpeechWorker();
 
     bool m_initialized;
+    bool m_streamOutput;  // Chunks go to m_audioStream, otherwise espeak plays them
 
-    // Audio buffer (PCM data from espeak)
-    std::vector<char> m_audioData;
-    std::mutex m_audioLock;
-
-    // Complete WAV file data (header + PCM data) - must persist during playback
-    std::vector<char> m_wavData;
+    // Audio output (PCM chunks from espeak, Windows)
+    AudioStream m_audioStream;
 
     // Audio format parameters
     int m_sampleRate;
 
     // Thread safety for espeak calls
     std::mutex m_espeakLock;
+
+    // Speech worker: only the latest Speak() text is kept
+    std::thread m_speechThread;
+    std::mutex m_requestLock;
+    std::condition_variable m_requestCondition;
+    std::string m_pendingText;             // UTF-8
+    bool m_hasPendingText;
+    bool m_stopWorker;
+    std::atomic<uint64_t> m_generation;    // Incremented by Speak/Stop, cancels the utterance in progress
+    std::atomic<uint64_t> m_synthGeneration;  // Generation of the utterance being synthesized
+    std::atomic<uint64_t> m_streamGeneration; // m_audioStream generation captured with it
 };
 
 #endif // ESPEAKENGINE_H
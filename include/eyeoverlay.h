@@ -3,14 +3,22 @@
 
 #include <wx/wx.h>
 #include <wx/geometry.h>
+#include <wx/graphics.h>
 #include <cstdint>
 #include <vector>
 #include <memory>
 #include "gazetracker.h"
 #include "keyboardview.h"
+#include "keygrid.h"
 #include "textinputengine.h"
 #include "CircularButton.h"
 #include "settings.h"
+#include "dwelldetector.h"
+#include "keycapatlas.h"
+#include "framescheduler.h"
+#include "screencapture.h"
+#include "sessionrecorder.h"
+#include "trace.h"
 #ifdef USE_ESPEAK
 #include "espeakengine.h"
 #endif
@@ -24,6 +32,11 @@
  * - Circular buttons in radial pattern (mimics HeyEyeControl)
  * - Buttons appear on dwell at center screen
  * - Keyboard toggle button in top-left corner
+ * - Candidate bar: alternates of the last swipe, dwell one to replace the inserted word
+ * - Optional session recording (gaze, swipes, committed words) for offline replay
+ * - Optional hot-path tracing: rolling latency panel, Chrome trace written on exit
+ * - Partial repaint: only damaged rectangles are redrawn and pushed to the layered window
+ * - Repaints coalesced and paced to the display refresh (FrameScheduler)
  */
 class EyeOverlay : public wxFrame
 {
@@ -38,17 +51,31 @@ public:
     // Text engine access
     TextInputEngine* GetTextEngine() { return m_textEngine; }
 
+    // Records the damaged area (nullptr = whole overlay) before scheduling a repaint
+    void Refresh(bool eraseBackground = true, const wxRect* rect = nullptr) override;
+
+    // Frame pacing statistics (rendered/skipped frames, intervals, render time)
+    FrameStats GetFrameStats() const { return m_frameScheduler.GetStats(); }
+
 protected:
     void OnPaint(wxPaintEvent& event);
     void OnEraseBackground(wxEraseEvent& event);
     void OnSize(wxSizeEvent& event);
     void OnClose(wxCloseEvent& event);
+    void OnDisplayChanged(wxDisplayChangedEvent& event);
+    void OnFrameTick(wxThreadEvent& event);
 
 private:
     // Event handlers
     void OnGazePositionUpdated(float x, float y, uint64_t timestamp);
     void OnLetterSelected(wxChar letter);
     void OnSwipeCompleted(const std::vector<std::pair<float, float>>& path);
+    void OnSwipeProgress(const std::vector<std::pair<float, float>>& path);
+    void OnSwipeCancelled();
+    void OnPredictionReady(const wxString& prediction);
+    void OnProvisionalPrediction(const wxString& prediction);
+    void OnCandidatesReady(const std::vector<wxString>& words);
+    void OnTextEngineInitialized(bool ready);
     void OnSpacePressed();
     void OnBackspacePressed();
     void OnDeleteWordPressed();
@@ -61,6 +88,7 @@ private:
 
     void SetupUI();
     void UpdateButtonPositions();
+    void PlaceOnTrackedDisplay();
 
     GazeTracker* m_gazeTracker;
     KeyboardView* m_keyboard;
@@ -79,33 +107,126 @@ private:
     struct KeyboardKey {
         wxString label;
         wxRect bounds;
-        float dwellProgress;  // 0.0 to 1.0
-        KeyboardKey(const wxString& lbl, const wxRect& r) : label(lbl), bounds(r), dwellProgress(0.0f) {}
+        DwellProgress dwell;
+        KeyboardKey(const wxString& lbl, const wxRect& r) : label(lbl), bounds(r) {}
     };
     std::vector<KeyboardKey> m_keyboardKeys;  // Workflow buttons only
+    KeyGrid m_keyboardKeyGrid;                // Cell -> m_keyboardKeys index
+    int m_hoveredKeyboardKey;                 // Index being dwelt on, KeyGrid::NOT_FOUND = none
+
+    // Candidate bar (alternates of the last swipe, between control buttons and keyboard)
+    wxString m_insertedPrediction;            // Word the last swipe inserted, "" = bar hidden
+    std::vector<KeyboardKey> m_candidateKeys; // One per alternate, label = word
+    KeyGrid m_candidateKeyGrid;               // Cell -> m_candidateKeys index
+    int m_hoveredCandidateKey;
 
     // Gaze tracking state
     bool m_visible;  // Like HeyEyeControl - when false, window doesn't draw anything
     bool m_keyboardVisible;
-    wxPoint2DDouble m_gazePosition;
+    wxPoint m_screenOrigin;  // Overlay top-left on the virtual desktop (tracked display origin)
+    wxPoint2DDouble m_gazePosition;  // Overlay client coordinates
     uint64_t m_lastGazeTimestamp;
+    wxString m_provisionalWord;      // Partial prediction shown while swiping
     uint64_t m_previousTimestamp;
 
-    // Screenshot state
-    wxBitmap m_screenshot;
+    // Partial repaint state
+    wxBitmap m_backBuffer;        // Persistent 32-bit ARGB surface (kept between paints)
+    wxRegion m_damage;            // Areas invalidated since the last paint
+    bool m_fullDamage;            // Whole overlay must be redrawn
+    wxRect m_paintedCursorRect;   // Where the gaze cursor was last drawn
+    wxRect m_paintDirtyRect;      // Rectangle of the damage being drawn
+    static const size_t MAX_DAMAGE_RECTS = 8;  // More are drawn as their bounding box
+
+    // Retained render resources (rebuilt on resize or color change, not per frame)
+    wxMemoryDC m_backBufferDC;            // Keeps m_backBuffer selected between paints
+    wxGraphicsContext* m_backBufferGC;    // GDI+ context on m_backBufferDC
+    struct RenderResources {
+        bool valid;
+        wxColour color;
+        int backgroundOpacity;
+        wxGraphicsPen pen1, pen2, pen3;     // Outlines (cursor, keys, selected buttons)
+        wxGraphicsPen arcPen5, arcPen6;     // Dwell progress arcs
+        wxGraphicsPen trailPen;             // Swipe trail
+        wxGraphicsPen transparentPen;
+        wxGraphicsBrush backgroundBrush;    // Dimmed screen behind buttons/keyboard
+        wxGraphicsBrush textBoxBrush;
+        wxGraphicsBrush transparentBrush;
+        wxGraphicsFont textFont;            // Text box content
+        wxGraphicsFont provisionalFont;     // Word of the swipe in progress
+        wxGraphicsFont statsFont;           // Latency panel (monospace)
+        RenderResources() : valid(false), backgroundOpacity(0) {}
+    } m_renderResources;
+    KeyCapAtlas m_keyCapAtlas;                  // Pre-rendered static key and button caps
+    // Label cap slots of m_keyCapAtlas: workflow keys, candidate bar, radial menu
+    static const size_t LABEL_SLOTS_WORKFLOW = 0;
+    static const size_t LABEL_SLOTS_CANDIDATES = 16;
+    static const size_t LABEL_SLOTS_MENU = 32;
+    static const int DWELL_ARC_STEPS = 64;      // Progress resolution of the cached dwell arcs
+    struct DwellArcs {
+        int radius;
+        std::vector<wxGraphicsPath> steps;      // [step], built on first use, centered on (0, 0)
+    };
+    struct TextExtent {                         // Last measured string of a font
+        wxString text;
+        double width;
+        double height;
+        bool valid;
+        TextExtent() : width(0.0), height(0.0), valid(false) {}
+    };
+    struct StaticPaths {                        // Paths kept between frames
+        bool valid;                             // Built against the current context
+        wxGraphicsPath cursor;                  // Gaze circle, centered on (0, 0)
+        wxGraphicsPath crosshair;               // Screenshot crosshair, centered on (0, 0)
+        wxRect textBoxRect;                     // Layout textBox was built for
+        wxGraphicsPath textBox;
+        wxRect traceStatsRect;                  // Layout traceStats was built for
+        wxGraphicsPath traceStats;
+        std::vector<DwellArcs> dwellArcs;       // One entry per arc radius in use
+        wxGraphicsPath swipeTrail;              // Trail of the swipe in progress, extended per frame
+        size_t swipeTrailPoints;                // Swipe path points already in swipeTrail
+        std::pair<float, float> swipeTrailStart;  // First point, tells a new swipe apart
+        wxPoint swipeTrailOrigin;               // Keyboard position swipeTrail was built at
+        StaticPaths() : valid(false), swipeTrailPoints(0) {}
+    } m_staticPaths;
+    TextExtent m_textBoxExtent;                 // Text box content (textFont)
+    std::vector<KeyRenderInfo> m_keyRenderInfo; // Reused by DrawKeyboardWithGC
+    wxGraphicsBitmap m_screenshotGraphicsBitmap;  // Converted screenshot sub-bitmap
+    wxRect m_screenshotGraphicsRect;              // Source rect of m_screenshotGraphicsBitmap
+
+    // Frame pacing
+    FrameScheduler m_frameScheduler;
+    uint64_t m_lastFrameStatsLog;  // Last frame stats summary (us)
+
+    // Screenshot state (only the selection region is captured)
+    ScreenCapture m_screenCapture;
+    wxBitmap m_screenshot;          // Pixels of m_screenshotCaptureRect
     bool m_hasScreenshot;
     wxPoint m_screenshotPosition;  // Current target position (gets refined during zoom)
     wxRect m_screenshotSourceRect;  // Actual area captured in screenshot (for crosshair calculation)
+    wxRect m_screenshotCaptureRect; // Area held by m_screenshot (overlay client coordinates)
     bool m_isZoomed;                // Whether in zoomed view mode
     float m_settingZoomFactor;      // Zoom magnification (default: 3.0)
     bool m_isScrollMode;            // Whether in scroll mode (from HeyEyeControl)
     bool m_isDragMode;              // Whether in drag mode (mouse button held down)
     bool m_isHiddenMode;            // Whether in hidden mode (minimal UI, UnHide at top)
 
+    // Session recording (/debug/record_session), opened on the first gaze sample
+    bool m_recordSession;
+    SessionRecorder m_sessionRecorder;
+    bool m_swipeLabelPending;      // Last recorded swipe has no committed word yet
+    bool m_swipeLabelShown;        // A word follows m_swipeLabelContext in the text
+    wxString m_swipeLabelContext;  // Text before that swipe
+
+    // Hot-path tracing (/debug/trace, /debug/show_stats)
+    bool m_traceExport;                       // Write the collected trace when closing
+    bool m_showTraceStats;
+    uint64_t m_pendingGazeArrival;            // Oldest sample not pushed to the screen yet (TRACE_NOW), 0 = none
+    uint64_t m_lastTraceDrain;                // Last time the trace rings were drained (us)
+    std::vector<wxString> m_traceStatsLines;  // Panel text, formatted when drained rather than per paint
+
     // Dwell detection
-    std::vector<wxPoint2DDouble> m_positionHistory;
-    std::vector<uint64_t> m_timestampHistory;
-    float m_dwellProgress;  // 0.0 to 1.0
+    DwellDetector m_dwellDetector;  // Sliding wait-time window over gaze samples
+    DwellProgress m_dwellProgress;  // Cursor arc, 0.0 to 1.0
 
     // Z-order management (keep overlay on top)
     uint64_t m_lastBringToFrontTimestamp;  // Throttle SetWindowPos calls (only when no buttons visible)
@@ -122,12 +243,43 @@ private:
     int m_settingSelectionHeight;       // Default 300
 
     // Helper methods
+    void StartSessionRecording();  // Open a new recording with the current overlay geometry
+    void UpdateSwipeLabel(const wxString& text);  // Follow edits of the last swipe's word, record it once the user moves on
+    void CommitSwipeLabel();       // Record the word now (next swipe, speak, submit, exit)
+    void UpdateTraceStats();       // Drain the trace rings, reformat and repaint the panel
+    void ExportTrace();            // Chrome trace of the collected events to <user data>/traces
     void CaptureScreenshotIfNeeded();  // Capture screenshot at current gaze position if not already captured
+    void CaptureScreenshotRegion(const wxRect& rect);  // Grab rect (client coordinates) into m_screenshot
+    wxRect GetSelectionRect(const wxPoint& center) const;  // Selection-sized rect around center, clamped to the overlay
     void CreateButtonsAtCenter();
     void ClearAllButtons();
     bool UpdateDwellDetection(float x, float y, uint64_t timestamp);  // Returns true if visual state changed
-    void DrawButtonWithGC(wxGraphicsContext* gc, CircularButton* button, const wxColour& color);
-    void DrawKeyboardWithGC(wxGraphicsContext* gc, const wxColour& color);  // Draw keyboard from KeyboardView + workflow buttons
+    void DrawButtonWithGC(wxGraphicsContext* gc, CircularButton* button);
+    void DrawKeyboardWithGC(wxGraphicsContext* gc);  // Draw keyboard from KeyboardView + workflow buttons
+    void DrawSwipeTrailWithGC(wxGraphicsContext* gc, int keyboardX, int keyboardY);
+    bool PrepareBackBuffer(const wxSize& size);  // (Re)create the back buffer, DC and context on size change
+    void UpdateRenderResources(const wxColour& color);  // Rebuild cached pens/brushes/fonts if the color changed
+    void UpdateStaticPaths(wxGraphicsContext* gc);       // Rebuild the kept paths after a context change
+    void StrokeDwellArc(wxGraphicsContext* gc, int centerX, int centerY, int radius, float progress);
+    void DrawLabelCap(wxGraphicsContext* gc, size_t slot, const wxString& label, const wxRect& bounds,
+                      KeyCapAtlas::LabelCapStyle style);
+    static const TextExtent& MeasureText(wxGraphicsContext* gc, TextExtent& cache, const wxString& text);
+    bool RenderFrame();  // Draw pending damage, returns false if there was nothing to draw
+    void DrawDamage(wxGraphicsContext* gc, const wxRect& dirty);  // Clear and redraw one damaged rectangle
+    void RenderNow();    // Render pending damage immediately instead of on the next tick
+    void PushToScreen(const wxRect& dirty);  // Copy the dirty part of the back buffer to the layered window
+    wxRect GetCursorRect() const;            // Area covered by the gaze cursor and its dwell arc
+    bool CursorMoved(const wxPoint2DDouble& oldPosition) const;  // More than 5 px, worth a frame
+    wxRect GetButtonRect(CircularButton* button) const;
+    wxRect GetTextBoxRect() const;
+    void SetProvisionalWord(const wxString& word);  // Repaints the text box when it changes
+    void SetCandidates(const wxString& inserted, const std::vector<wxString>& alternates);  // Rebuilds and repaints the bar
+    void ClearCandidates();
+    void SelectCandidate(size_t index);  // Replace the inserted word by an alternate
+    wxRect GetCandidateBarRect() const;  // Area covered by m_candidateKeys
+    static void BuildKeyGrid(const std::vector<KeyboardKey>& keys, KeyGrid& grid);  // After keys changed
+    wxRect GetTraceStatsRect() const;    // Latency panel, empty when hidden
+    void DrawTraceStatsWithGC(wxGraphicsContext* gc);
     void HandleKeyActivation(const wxString& keyLabel);  // Handle workflow button press (UNDO/SUBMIT)
     void EnsureOnTop();  // Bring window to topmost position (throttled)
     bool IsTextCursorAtPosition(int x, int y);  // Check if cursor at position is I-beam (text edit cursor)
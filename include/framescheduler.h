@@ -0,0 +1,107 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <wx/wx.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Posted to the target handler when a requested frame should be rendered
+wxDECLARE_EVENT(wxEVT_FRAME_TICK, wxThreadEvent);
+
+/**
+ * @brief Frame timing statistics (GUI thread)
+ *
+ * Intervals are measured between consecutive rendered frames, so idle
+ * periods show up as long intervals rather than as missed frames.
+ */
+struct FrameStats {
+    uint64_t framesRendered;     // Ticks that produced a frame
+    uint64_t framesSkipped;      // Ticks with nothing visible to update
+    uint64_t requestsCoalesced;  // RequestFrame calls merged into an already pending frame
+    double lastIntervalMs;
+    double averageIntervalMs;    // Exponential moving average
+    double maxIntervalMs;
+    double lastRenderMs;
+    double averageRenderMs;      // Exponential moving average
+    double maxRenderMs;
+
+    FrameStats()
+        : framesRendered(0)
+        , framesSkipped(0)
+        , requestsCoalesced(0)
+        , lastIntervalMs(0.0)
+        , averageIntervalMs(0.0)
+        , maxIntervalMs(0.0)
+        , lastRenderMs(0.0)
+        , averageRenderMs(0.0)
+        , maxRenderMs(0.0)
+    {}
+
+    // Frame rate implied by the average interval (0 before two frames)
+    double GetAverageFps() const { return averageIntervalMs > 0.0 ? 1000.0 / averageIntervalMs : 0.0; }
+};
+
+/**
+ * @brief Coalesces repaint requests and paces them to the display refresh
+ *
+ * Any number of RequestFrame() calls between two vertical blanks result in a
+ * single wxEVT_FRAME_TICK on the target handler. When nothing is requested
+ * the scheduler thread sleeps, so an idle overlay costs no frames at all.
+ *
+ * Features:
+ * - Vsync pacing through DwmFlush (Windows, composition enabled)
+ * - Timestamp-based fallback tick at the display refresh rate otherwise
+ * - At most one tick in flight: the next vblank wait starts after BeginFrame()
+ * - Frame interval and render time statistics
+ */
+class FrameScheduler
+{
+public:
+    explicit FrameScheduler(wxEvtHandler* target);
+    ~FrameScheduler();
+
+    void Start();
+    void Stop();
+    bool IsRunning() const { return m_running.load(); }
+
+    // Refresh rate used when DWM pacing is not available (default 60 Hz)
+    void SetFallbackRate(int hz);
+    int GetFallbackRate() const { return m_fallbackRateHz.load(); }
+
+    // Ask for a frame at the next vblank (any thread, cheap when already pending)
+    void RequestFrame();
+    bool IsFramePending() const { return m_framePending.load(); }
+
+    // Called by the target when handling wxEVT_FRAME_TICK (GUI thread).
+    // Requests made after BeginFrame() schedule the next frame.
+    void BeginFrame();
+    void EndFrame(bool rendered);
+
+    FrameStats GetStats() const;
+    void ResetStats();
+
+private:
+    void ThreadLoop();
+    void WaitForVBlank();
+
+    wxEvtHandler* m_target;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_framePending;  // A frame was requested and not started yet
+    bool m_tickInFlight;               // Tick posted, BeginFrame not called yet (guarded by m_mutex)
+    std::atomic<int> m_fallbackRateHz;
+
+    // Statistics (GUI thread, except the coalesced counter)
+    std::atomic<uint64_t> m_requestsCoalesced;
+    FrameStats m_stats;
+    int64_t m_lastFrameStartUs;  // Steady clock, 0 before the first frame
+    int64_t m_frameStartUs;
+};
+
+#endif // FRAMESCHEDULER_H
@@ -6,6 +6,10 @@
 #include <wx/display.h>
 #include <functional>
 #include <cstdint>
+#include <thread>
+#include <atomic>
+#include "spscringbuffer.h"
+#include "trace.h"
 
 // Forward declaration for Tobii types
 struct tobii_api_t;
@@ -16,13 +20,37 @@ struct tobii_device_t;
  *
  * Features:
  * - Automatic device discovery and connection
- * - High-frequency gaze updates (~120Hz)
+ * - High-frequency gaze updates (~120Hz and above)
+ * - Optional dedicated acquisition thread feeding a lock-free sample ring
  * - Screen coordinate mapping
  * - Connection state management
+ * - Background device discovery: mouse control works while the device connects
  */
 class GazeTracker : public wxEvtHandler
 {
 public:
+    /**
+     * How Tobii callbacks are pumped:
+     * - Timer: wait/process callbacks from the GUI timer (legacy behaviour)
+     * - Thread: a dedicated thread waits on the device and queues samples,
+     *   the GUI timer only drains the queue in batches
+     */
+    enum class CaptureMode {
+        Timer,
+        Thread
+    };
+
+    // Raw sample as delivered by the device, coordinates normalized to 0..1
+    struct GazeSample {
+        float x;
+        float y;
+        uint64_t timestamp;  // Microseconds
+        uint64_t queuedAt;   // TRACE_NOW() when queued, 0 = not traced
+    };
+
+    // Fastest stream of the supported trackers, sizes per-sample windows
+    static const int MAX_SAMPLE_RATE_HZ = 250;
+
     explicit GazeTracker();
     ~GazeTracker();
 
@@ -30,24 +58,64 @@ public:
     bool Initialize();
     bool IsConnected() const { return m_connected; }
 
+    // Start tracking in manual (mouse) mode right away and discover the device
+    // on a background thread; switches to the device when it is connected.
+    void InitializeAsync();
+    bool IsDiscovering() const { return m_discovering.load(); }
+
     // Tracking control
     void StartTracking();
     void StopTracking();
 
+    // Capture mode (applied on the next StartTracking if already running)
+    void SetCaptureMode(CaptureMode mode);
+    CaptureMode GetCaptureMode() const { return m_captureMode; }
+
+    // Samples lost because the UI did not drain the ring in time
+    uint64_t GetDroppedSampleCount() const { return m_samples.GetDroppedCount(); }
+
+    // Display mapping. Gaze samples are normalized to the tracked monitor and
+    // reported in virtual-desktop coordinates (display origin included).
+    // index -1 picks the display under the mouse when the geometry is refreshed.
+    void SetTrackedDisplay(int index);
+    int GetTrackedDisplay() const { return m_trackedDisplay; }
+    wxRect GetTrackedDisplayRect() const { return m_displayRect; }
+
+    // Re-query monitor geometry (call on display configuration changes)
+    void RefreshDisplayGeometry();
+
     // Device info
     wxString GetDeviceUrl() const { return m_deviceUrl; }
 
-    // Manual position update (for testing without Tobii)
-    void SetManualPosition(float x, float y);
+    // Manual position update (for testing without Tobii or replaying a
+    // recorded session), timestamp in microseconds, 0 = now
+    void SetManualPosition(float x, float y, uint64_t timestamp = 0);
+
+    // TRACE_NOW() of the sample being delivered to OnGazePositionUpdated
+    // (arrival side of the gaze to screen latency), 0 when not traced
+    uint64_t GetCurrentSampleArrival() const { return m_currentSampleArrival; }
 
     // Callback for gaze position updates (replaces Qt signal)
     std::function<void(float x, float y, uint64_t timestamp)> OnGazePositionUpdated;
 
+    // Called from the Tobii callback (capture thread or GUI thread)
+    void QueueSample(float x, float y, uint64_t timestamp);
+
 private:
+    // 256 samples ~= 1s at 250Hz, far more than one drain interval
+    static const size_t SAMPLE_RING_SIZE = 256;
+
     void OnTimer(wxTimerEvent& event);
     void UpdateCallbacks();
+    void ProcessDeviceCallbacks();
+    void DrainSamples();
+
+    void StartCaptureThread();
+    void StopCaptureThread();
+    void CaptureThreadLoop();
 
     bool DiscoverDevice();
+    void OnDeviceDiscovered(wxThreadEvent& event);
 
     bool m_connected;
     wxString m_deviceUrl;
@@ -58,11 +126,28 @@ private:
     tobii_api_t* m_api;
     tobii_device_t* m_device;
 
+    // Acquisition
+    CaptureMode m_captureMode;
+    std::thread m_captureThread;
+    std::atomic<bool> m_captureRunning;
+    SpscRingBuffer<GazeSample, SAMPLE_RING_SIZE> m_samples;
+    GazeSample m_drainBuffer[SAMPLE_RING_SIZE];
+
+    // Discovery thread (m_api, m_device and m_deviceUrl belong to it while running)
+    std::thread m_discoveryThread;
+    std::atomic<bool> m_discovering;
+
+    // Cached tracked-display geometry (GUI thread only)
+    int m_trackedDisplay;
+    wxRect m_displayRect;
+
     // Manual control for testing
     bool m_manualMode;
     float m_manualX;
     float m_manualY;
 
+    uint64_t m_currentSampleArrival;
+
     wxDECLARE_EVENT_TABLE();
 };
 
@@ -0,0 +1,53 @@
+#ifndef KENLMUTIL_H
+#define KENLMUTIL_H
+
+#ifdef USE_KENLM
+#include "languagecontext.h"
+#include "lm/model.hh"
+#include <cstring>
+#include <string>
+
+// The model is held through the virtual interface so ARPA and every binary
+// layout (probing, trie, quantized trie) load the same way. All of them use
+// lm::ngram::State, these helpers keep the call sites readable.
+inline lm::ngram::State kenlm_begin_state(const lm::base::Model* model) {
+    lm::ngram::State state;
+    model->BeginSentenceWrite(&state);
+    return state;
+}
+
+inline lm::WordIndex kenlm_index(const lm::base::Model* model, const std::string& word) {
+    return model->BaseVocabulary().Index(word);
+}
+
+inline lm::WordIndex kenlm_end_sentence(const lm::base::Model* model) {
+    return model->BaseVocabulary().EndSentence();
+}
+
+inline lm::FullScoreReturn kenlm_full_score(const lm::base::Model* model, const lm::ngram::State& in_state,
+                                            lm::WordIndex word, lm::ngram::State& out_state) {
+    return model->BaseFullScore(&in_state, word, &out_state);
+}
+
+// LmState is lm::ngram::State without the KenLM headers
+static_assert(sizeof(LmState) == sizeof(lm::ngram::State) && LmState::MAX_WORDS == KENLM_MAX_ORDER - 1,
+              "LmState must match lm::ngram::State (KENLM_MAX_ORDER 6)");
+
+inline LmState kenlm_to_lm_state(const lm::ngram::State& state) {
+    LmState result;
+    std::memcpy(result.words, state.words, sizeof(result.words));
+    std::memcpy(result.backoff, state.backoff, sizeof(result.backoff));
+    result.length = state.length;
+    return result;
+}
+
+inline lm::ngram::State kenlm_from_lm_state(const LmState& state) {
+    lm::ngram::State result;
+    std::memcpy(result.words, state.words, sizeof(result.words));
+    std::memcpy(result.backoff, state.backoff, sizeof(result.backoff));
+    result.length = state.length;
+    return result;
+}
+#endif
+
+#endif // KENLMUTIL_H
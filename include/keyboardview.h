@@ -7,7 +7,10 @@
 #include <map>
 #include <utility>
 #include <functional>
+#include <cstdint>
 #include "keybutton.h"
+#include "keygrid.h"
+#include "swipepathfilter.h"
 
 /**
  * @brief Key rendering information for manual rendering on overlay
@@ -51,7 +54,8 @@ struct KeyRenderInfo {
  * - Letter-by-letter dwell (always active)
  * - Optional swipe ML (can be enabled/disabled)
  * - Gaze position tracking and visualization
- * - Swipe path recording and rendering
+ * - Swipe path recording (smoothed and resampled as captured) and rendering
+ * - Progress notifications every N recorded points (speculative prediction)
  */
 class KeyboardView : public wxPanel
 {
@@ -63,14 +67,26 @@ public:
     bool IsSwipeEnabled() const { return m_swipeEnabled; }
     void SetSwipeEnabled(bool enabled);
 
-    // Gaze tracking
-    void UpdateGazePosition(float x, float y);
+    // Gaze tracking. Dwell time advances by the sample timestamps
+    // (microseconds), or by the wall clock when timestamp is 0.
+    void UpdateGazePosition(float x, float y, uint64_t timestamp = 0);
 
     // Swipe recording (automatically managed by vertical position)
     bool IsRecordingSwipe() const { return m_recordingSwipe; }
     const std::vector<std::pair<float, float>>& GetSwipePath() const { return m_swipePath; }
     void ClearSwipePath();
 
+    // OnSwipeProgress fires every interval recorded points, 0 = never
+    void SetSwipeProgressInterval(int points) { m_swipeProgressInterval = points; }
+    int GetSwipeProgressInterval() const { return m_swipeProgressInterval; }
+
+    // Capture-time smoothing and resampling of the recorded path
+    void SetSwipeFilterOptions(const SwipePathFilterOptions& options) { m_swipeFilter.SetOptions(options); }
+    const SwipePathFilterOptions& GetSwipeFilterOptions() const { return m_swipeFilter.GetOptions(); }
+
+    // Convert a recorded (model-normalized) swipe point back to keyboard-local pixels
+    wxPoint2DDouble SwipePointToLocal(const std::pair<float, float>& point) const;
+
     // Settings
     void SetDwellTime(int milliseconds) { m_dwellTimeMs = milliseconds; }
     int GetDwellTime() const { return m_dwellTimeMs; }
@@ -88,10 +104,18 @@ public:
 
     // Get all keys for manual rendering with wxGraphicsContext
     std::vector<KeyRenderInfo> GetKeysForRendering() const;
+    // Same, reusing the caller's vector (no allocation once it reached its full size)
+    void GetKeysForRendering(std::vector<KeyRenderInfo>& renderInfo) const;
+
+    // Damage tracking for the overlay renderer: returns the keyboard-local area whose
+    // appearance changed since the last call (hover, progress, modifiers, swipe trail)
+    bool TakeDamage(wxRect& rect);
 
     // Callbacks (replace Qt signals)
     std::function<void(wxChar)> OnLetterSelected;
     std::function<void(const std::vector<std::pair<float, float>>&)> OnSwipeCompleted;
+    std::function<void(const std::vector<std::pair<float, float>>&)> OnSwipeProgress;  // Path so far
+    std::function<void()> OnSwipeCancelled;
     std::function<void()> OnSpacePressed;
     std::function<void()> OnBackspacePressed;
     std::function<void()> OnDeleteWordPressed;
@@ -105,8 +129,11 @@ protected:
 private:
     void CreateKeyboard();
     void UpdateKeyGeometries();
-    void UpdateDwellProgress(KeyButton *key, float deltaMs);
-    KeyButton* FindKeyAtPosition(const wxPoint2DDouble &pos);
+    bool UpdateDwellProgress(KeyButton *key, float deltaMs);  // Returns true if visual state changed
+    void AddDamage(const wxRect2DDouble& area);
+    void AddFullDamage();
+    KeyButton* FindKeyAtPosition(const wxPoint2DDouble &pos) const;
+    bool IsInSwipeZone(const wxPoint2DDouble &pos) const;
     void ToggleShift();
     void ToggleCapsLock();
     void ToggleAltGr();
@@ -115,6 +142,7 @@ private:
     // Swipe detection helpers
     void StartSwipeRecording();
     void StopSwipeRecording();
+    void CancelSwipeRecording();
 
     // Swipe mode (LetterByLetter is always active)
     bool m_swipeEnabled;
@@ -132,6 +160,13 @@ private:
     KeyButton* m_speakKey;
     std::map<wxChar, KeyButton*> m_keyMap;
 
+    // Hit-testing, rebuilt by UpdateKeyGeometries (cell -> key)
+    KeyGrid m_keyGrid;
+    std::vector<KeyButton*> m_gridKeys;  // KeyGrid index -> key
+    bool m_layoutValid;                  // False until the widget has a size
+    float m_keyboardOffsetX;             // Left edge of the centered 12-key rows
+    wxRect2DDouble m_swipeZone;          // Rows 0-3 (character keys, not the spacebar row)
+
     // Modifier states
     bool m_shiftActive;
     bool m_capsLockActive;
@@ -141,6 +176,7 @@ private:
     wxPoint2DDouble m_gazePosition;
     KeyButton* m_currentHoveredKey;
     wxLongLong m_lastUpdateTime;
+    uint64_t m_lastTimestamp;  // Last sample timestamp (us), 0 = none yet
 
     // Dwell-time settings
     int m_dwellTimeMs;
@@ -149,6 +185,11 @@ private:
     bool m_recordingSwipe;
     std::vector<std::pair<float, float>> m_swipePath;
     wxPoint2DDouble m_previousGazePosition;  // Track previous position for exit detection
+    int m_swipeProgressInterval;             // Points between OnSwipeProgress calls, 0 = off
+    SwipePathFilter m_swipeFilter;           // Raw gaze -> m_swipePath points
+
+    // Pending damage (keyboard-local), consumed by TakeDamage
+    wxRect m_damage;
 
     // Visual settings
     wxColour m_normalColor;
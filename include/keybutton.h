@@ -4,6 +4,7 @@
 #include <wx/wx.h>
 #include <wx/geometry.h>
 #include <functional>
+#include "dwelldetector.h"
 
 /**
  * @brief Type of key (regular character or modifier)
@@ -42,16 +43,17 @@ public:
     wxChar GetPrimaryCharacter() const { return m_primaryChar; }
     wxChar GetShiftCharacter() const { return m_shiftChar; }
     wxChar GetAltGrCharacter() const { return m_altgrChar; }
-    wxString GetLabel() const { return m_label; }
+    const wxString& GetLabel() const { return m_label; }
     wxRect2DDouble GetGeometry() const { return m_geometry; }
     bool IsHovered() const { return m_hovered; }
-    float GetProgress() const { return m_progress; }
+    float GetProgress() const { return m_progress.Get(); }
     bool IsModifierActive() const { return m_modifierActive; }
 
     // Setters
     void SetGeometry(const wxRect2DDouble& rect) { m_geometry = rect; }
     void SetHovered(bool hovered);
     void SetProgress(float progress); // 0.0 to 1.0
+    bool AdvanceProgress(float elapsed, float dwellTime); // Returns true on a 5% step or activation
     void SetModifierActive(bool active) { m_modifierActive = active; }
 
     // Drawing
@@ -72,7 +74,7 @@ private:
     wxString m_label;  // For modifier keys
     wxRect2DDouble m_geometry;
     bool m_hovered;
-    float m_progress; // 0.0 to 1.0 for dwell-time progress
+    DwellProgress m_progress; // 0.0 to 1.0 for dwell-time progress
     bool m_modifierActive; // For visual feedback on modifier keys
 };
 
@@ -0,0 +1,96 @@
+#ifndef KEYCAPATLAS_H
+#define KEYCAPATLAS_H
+
+#include <wx/wx.h>
+#include <wx/graphics.h>
+#include <vector>
+#include "keyboardview.h"
+
+/**
+ * @brief Cache of pre-rendered key caps for the overlay keyboard
+ *
+ * A key cap is the static part of a key: outline, background (none, hover,
+ * active modifier) and the three character layers with the active one
+ * emphasized. Label caps are the same for the overlay's own buttons
+ * (workflow keys, candidate bar, radial menu): outline and one label.
+ * Only dwell progress and the swipe trail are drawn per frame.
+ *
+ * Features:
+ * - One slot per key (index in KeyboardView::GetKeysForRendering order)
+ * - Up to 3 x 3 variants per slot (active layer x background state)
+ * - Label caps have their own slots (chosen by the caller), one variant per style
+ * - A slot is re-rendered only when its size or labels change
+ * - Changing the color drops every cached cap
+ *
+ * Lookups compare in place and do not allocate once all variants are rendered.
+ */
+class KeyCapAtlas
+{
+public:
+    // Extra pixels around the key rect so the outline pen is not cut
+    static const int MARGIN = 2;
+
+    enum LabelCapStyle {
+        LabelCapButton,          // Rounded rectangle outline
+        LabelCapButtonActive,    // Rounded rectangle with a filled background
+        LabelCapCircle,          // Circle outline (radial menu)
+        LabelCapCircleSelected,  // Circle with a thicker outline
+        LabelCapStyleCount
+    };
+
+    KeyCapAtlas();
+
+    void SetColor(const wxColour& color);
+    void Clear();
+
+    // Returns the cap for the key in its current state, rendering it with
+    // gc's renderer on a miss. Draw it at (keyX - MARGIN, keyY - MARGIN).
+    const wxGraphicsBitmap& GetKeyCap(wxGraphicsContext* gc, size_t slot, const KeyRenderInfo& info, int width, int height);
+
+    // Same for a button label centered in a width x height outline (label
+    // slots are separate from key slots)
+    const wxGraphicsBitmap& GetLabelCap(wxGraphicsContext* gc, size_t slot, const wxString& label,
+                                        int width, int height, LabelCapStyle style);
+
+    size_t GetRenderedCount() const { return m_renderedCount; }
+
+private:
+    enum Background {
+        BackgroundNone,
+        BackgroundHover,
+        BackgroundModifier,
+        BackgroundCount
+    };
+
+    struct Slot {
+        int width;
+        int height;
+        KeyType keyType;
+        wxString primaryLabel;
+        wxString shiftLabel;
+        wxString altgrLabel;
+        wxGraphicsBitmap caps[3][BackgroundCount];  // [activeLayer][background]
+
+        Slot() : width(0), height(0), keyType(KeyType::Character) {}
+    };
+
+    struct LabelSlot {
+        int width;
+        int height;
+        wxString label;
+        wxGraphicsBitmap caps[LabelCapStyleCount];
+
+        LabelSlot() : width(0), height(0) {}
+    };
+
+    bool Matches(const Slot& slot, const KeyRenderInfo& info, int width, int height) const;
+    wxGraphicsBitmap RenderKeyCap(wxGraphicsContext* gc, const KeyRenderInfo& info, int width, int height, Background background) const;
+    wxGraphicsBitmap RenderLabelCap(wxGraphicsContext* gc, const wxString& label, int width, int height, LabelCapStyle style) const;
+
+    wxColour m_color;
+    std::vector<Slot> m_slots;
+    std::vector<LabelSlot> m_labelSlots;
+    size_t m_renderedCount;
+};
+
+#endif // KEYCAPATLAS_H
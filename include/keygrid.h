@@ -0,0 +1,63 @@
+#ifndef KEYGRID_H
+#define KEYGRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Uniform grid (cell -> rectangles) for O(1) hit-testing of a key layout
+ *
+ * Rectangles are added once per layout change and Build() buckets each of
+ * them into every cell it overlaps. Find() maps a point to its cell and
+ * tests only the one or two rectangles stored there instead of the whole
+ * layout, so the cost per gaze sample no longer grows with the key count.
+ *
+ * Features:
+ * - Half-open rectangles [x, x + width) x [y, y + height), like wxRect::Contains
+ * - Where rectangles overlap the first one added wins
+ * - At most MAX_CELLS cells, sparse layouts get coarser cells
+ * - Flat arrays, Find() never allocates
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class KeyGrid
+{
+public:
+    static const int NOT_FOUND = -1;
+    static const size_t MAX_CELLS = 4096;
+
+    KeyGrid();
+
+    void Clear();
+
+    // Returns the index Find() reports for this rectangle (insertion order)
+    int Add(float x, float y, float width, float height);
+
+    // Bucket the rectangles, cellSize is typically the key pitch
+    void Build(float cellSize);
+
+    // Index of the rectangle containing (x, y), NOT_FOUND when none does
+    int Find(float x, float y) const;
+
+    size_t GetCount() const { return m_rects.size(); }
+
+private:
+    struct Rect {
+        float left;
+        float top;
+        float right;
+        float bottom;
+    };
+
+    std::vector<Rect> m_rects;
+    std::vector<uint32_t> m_cellStart;  // columns * rows + 1 offsets into m_cellItems
+    std::vector<uint32_t> m_cellItems;  // Rectangle indices, ascending within a cell
+    float m_originX;
+    float m_originY;
+    float m_cellSize;
+    int m_columns;  // 0 = nothing built
+    int m_rows;
+};
+
+#endif // KEYGRID_H
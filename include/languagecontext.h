@@ -0,0 +1,145 @@
+#ifndef LANGUAGECONTEXT_H
+#define LANGUAGECONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lm {
+namespace base {
+class Model;
+}
+}
+
+/**
+ * @brief KenLM n-gram state held by value
+ *
+ * Same layout as lm::ngram::State built with KENLM_MAX_ORDER 6 (checked
+ * where KenLM is included), so it can be stored and copied without the
+ * KenLM headers and without the heap.
+ */
+struct LmState {
+    static const size_t MAX_WORDS = 5;  // KENLM_MAX_ORDER - 1
+
+    uint32_t words[MAX_WORDS];  // Most recent first, only the first length are used
+    float backoff[MAX_WORDS];
+    unsigned char length;
+
+    LmState() : length(0)
+    {
+        std::memset(words, 0, sizeof(words));
+        std::memset(backoff, 0, sizeof(backoff));
+    }
+};
+
+// Same state equality as lm::ngram::State (the words decide the backoffs)
+inline bool operator==(const LmState& a, const LmState& b)
+{
+    return a.length == b.length && std::memcmp(a.words, b.words, a.length * sizeof(uint32_t)) == 0;
+}
+inline bool operator!=(const LmState& a, const LmState& b) { return !(a == b); }
+
+/**
+ * @brief Context the candidate words of a swipe are scored in
+ *
+ * <s> followed by the last LanguageContext::CONTEXT_WORDS words of the text.
+ */
+struct LmContext {
+    LmState state;
+    float logProb;  // Log probability of the context words
+    bool valid;     // False without a language model (begin state, 0)
+
+    LmContext() : logProb(0.0f), valid(false) {}
+};
+
+inline bool operator==(const LmContext& a, const LmContext& b)
+{
+    return a.valid == b.valid && a.state == b.state && std::memcmp(&a.logProb, &b.logProb, sizeof(float)) == 0;
+}
+inline bool operator!=(const LmContext& a, const LmContext& b) { return !(a == b); }
+
+// Score of one candidate word after a context state: the word, then </s>
+struct LmScoreKey {
+    LmState context;
+    uint32_t word;  // lm::WordIndex
+};
+
+inline bool operator==(const LmScoreKey& a, const LmScoreKey& b)
+{
+    return a.word == b.word && a.context == b.context;
+}
+
+struct LmScoreKeyHash {
+    size_t operator()(const LmScoreKey& key) const
+    {
+        size_t hash = std::hash<uint32_t>()(key.word) ^ (static_cast<size_t>(key.context.length) << 24);
+        for (unsigned char i = 0; i < key.context.length; ++i) {
+            hash = hash * 1000003u ^ key.context.words[i];
+        }
+        return hash;
+    }
+};
+
+struct LmWordScore {
+    float word;         // log10 p(word | context)
+    float endSentence;  // log10 p(</s> | context word)
+};
+
+/**
+ * @brief LM context of the text being typed, kept up to date edit by edit
+ *
+ * Mirrors the space-separated words of the text as a stack. Edits only ever
+ * touch the end of the text, so appending a character extends or pushes the
+ * last word and deleting one shrinks or pops it; the text is never split
+ * again. Each word caches the context state that ends with it, so undoing a
+ * word (DeleteLastWord) gives back the previous state for free.
+ *
+ * Features:
+ * - Same context as a full re-split: <s> then the last CONTEXT_WORDS words
+ * - States are computed on demand (GetContext), at most CONTEXT_WORDS
+ *   FullScore calls after an edit, none when only spaces changed
+ * - Words are UTF-8, as in the vocabulary and the KenLM model
+ *
+ * Not thread safe: owned by the GUI thread, GetContext() results are values
+ * that can be handed to the prediction worker.
+ */
+class LanguageContext
+{
+public:
+    static const size_t CONTEXT_WORDS = 4;
+
+    LanguageContext();
+
+    // Edits at the end of the text. A character is one UTF-8 code point.
+    void AppendCharacter(const std::string& character);
+    void AppendText(const std::string& text);
+    void DeleteLastCharacter();
+    void DeleteLastWord();  // Same as the text: drops a word not followed by a space
+    void Clear();
+
+    size_t GetWordCount() const { return m_words.size(); }
+    const std::string& GetWord(size_t index) const { return m_words[index].text; }
+
+    // State and log probability of the current context, null model = invalid
+    LmContext GetContext(const lm::base::Model* model);
+
+private:
+    struct Word {
+        std::string text;
+        size_t spacesAfter;  // Spaces typed after the word, 0 = still being typed
+        bool scored;         // context is up to date
+        LmContext context;   // Context made of the words up to and including this one
+        Word() : spacesAfter(0), scored(false) {}
+    };
+
+    void InvalidateLastWord();
+
+    std::vector<Word> m_words;
+    size_t m_leadingSpaces;
+    const lm::base::Model* m_model;  // Model the cached states belong to
+};
+
+#endif // LANGUAGECONTEXT_H
@@ -5,7 +5,7 @@
 #include <vector>
 
 // Forward declaration - no includes needed!
-struct CandidateFeatures;
+class CandidateBatch;
 
 // Pimpl pattern to completely hide LightGBM implementation
 class LightGBMRanker {
@@ -14,21 +14,34 @@ private:
     Impl* pimpl; // Pointer to implementation
 
 public:
+    // Inference implementation, chosen when the model is loaded
+    enum Backend {
+        BACKEND_AUTO = 0,      // Compiled trees when they match the C API (or without it)
+        BACKEND_C_API = 1,     // LGBM_BoosterPredictForMat (needs USE_LIGHTGBM)
+        BACKEND_COMPILED = 2   // TreeEnsemble, no LightGBM runtime needed
+    };
+
     LightGBMRanker();
     ~LightGBMRanker();
 
-    // Load the trained LightGBM model from file
-    bool load_model(const std::string& model_path);
+    // Load the trained LightGBM model from file. With both backends available
+    // the compiled trees are validated against the C API on probe rows.
+    bool load_model(const std::string& model_path, Backend backend = BACKEND_AUTO);
+
+    // Backend in use after load_model(), and why the other one was not used
+    Backend get_backend() const;
+    const char* get_backend_name() const;
+    const std::string& get_load_message() const;
 
-    // Predict scores for a vector of candidates
-    // Returns a vector of scores (same length as candidates)
-    std::vector<float> predict(const std::vector<CandidateFeatures>& candidates);
+    // Predict one score per batch row. The batch matrix is passed to
+    // LightGBM as is (float32, row-major); scores keeps its capacity, reuse it.
+    void predict(const CandidateBatch& batch, std::vector<double>& scores);
 
-    // Convenience method: rank candidates and return the best word
-    std::string get_best_candidate(const std::vector<CandidateFeatures>& candidates);
+    // Convenience method: row of the best candidate (batch must not be empty)
+    size_t get_best_candidate(const CandidateBatch& batch);
 
-    // Rank candidates and return sorted indices (best first)
-    std::vector<size_t> rank_candidates(const std::vector<CandidateFeatures>& candidates);
+    // Rank candidates: row indices sorted by score (best first)
+    void rank_candidates(const CandidateBatch& batch, std::vector<size_t>& order);
 
     // Check if model is loaded
     bool is_model_loaded() const;
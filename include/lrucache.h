@@ -0,0 +1,85 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Fixed capacity map that evicts the least recently used entry
+ *
+ * Features:
+ * - O(1) Get/Put (hash index into a recency list)
+ * - Get() marks the entry as used, Put() of an existing key replaces it
+ * - Hit/miss counters for the log
+ *
+ * Not thread safe.
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache
+{
+public:
+    explicit LruCache(size_t capacity)
+        : m_capacity(capacity > 0 ? capacity : 1)
+        , m_hits(0)
+        , m_misses(0)
+    {
+        m_index.reserve(m_capacity);
+    }
+
+    // Copies the value and marks the entry as most recent, false if absent
+    bool Get(const Key& key, Value& value)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) {
+            m_misses++;
+            return false;
+        }
+        m_items.splice(m_items.begin(), m_items, it->second);
+        value = it->second->second;
+        m_hits++;
+        return true;
+    }
+
+    void Put(const Key& key, const Value& value)
+    {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            it->second->second = value;
+            m_items.splice(m_items.begin(), m_items, it->second);
+            return;
+        }
+
+        if (m_items.size() >= m_capacity) {
+            m_index.erase(m_items.back().first);
+            m_items.pop_back();
+        }
+        m_items.emplace_front(key, value);
+        m_index[key] = m_items.begin();
+    }
+
+    void Clear()
+    {
+        m_items.clear();
+        m_index.clear();
+    }
+
+    size_t GetSize() const { return m_items.size(); }
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetHits() const { return m_hits; }
+    size_t GetMisses() const { return m_misses; }
+
+private:
+    typedef std::list<std::pair<Key, Value>> ItemList;
+
+    size_t m_capacity;
+    ItemList m_items;  // Most recent first
+    std::unordered_map<Key, typename ItemList::iterator, Hash> m_index;
+    size_t m_hits;
+    size_t m_misses;
+};
+
+#endif // LRUCACHE_H
@@ -0,0 +1,43 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Pages are loaded by the OS on first access and shared between processes
+ * mapping the same file. The data stays valid until Close() or destruction.
+ *
+ * No wxWidgets dependency so it can be used by the asset tools.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map filepath (replaces any previous mapping). Empty files fail.
+    bool Open(const std::string& filepath);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_fileHandle;
+    void* m_mappingHandle;
+#else
+    int m_fd;
+#endif
+};
+
+#endif // MAPPEDFILE_H
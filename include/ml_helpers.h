@@ -17,12 +17,21 @@ namespace faiss {
 std::pair<std::map<int, std::vector<std::string>>*, std::vector<std::string>*>
 load_vocab(const std::string& filepath);
 
-// FAISS index loading
+// FAISS index loading. Any index type is accepted (flat, IVF flat / PQ /
+// scalar quantizer, HNSW); returns nullptr if the file cannot be read.
 faiss::Index* load_faiss_index(const std::string& filepath);
 
+// Index type, size and metric for the log, e.g. "IVF4096,PQ32 (IP, 250000 x 256)"
+std::string describe_faiss_index(const faiss::Index* index);
+
+// Search-time recall / speed trade-off of approximate indexes: nprobe for IVF
+// indexes, efSearch for HNSW. Values <= 0 keep what the index file stores.
+// Returns the parameters in effect, empty for exact indexes.
+std::string set_faiss_search_parameters(faiss::Index* index, int nprobe, int ef_search);
+
 // FAISS search
 std::map<faiss::idx_t, float> search_faiss_index(
-    std::vector<float>* query,
+    const std::vector<float>* query,
     faiss::Index* index,
     int k_nearest
 );
@@ -0,0 +1,53 @@
+#ifndef MODELPACK_H
+#define MODELPACK_H
+
+#include <string>
+
+/**
+ * @brief Swipe encoder and FAISS index variant selected together
+ *
+ * A reduced-precision encoder produces embeddings that only match an index
+ * built from the same model, so the two files ship as one versioned pack in
+ * <assets>/packs/<name>/pack.ini:
+ *
+ *     # HeyEye model pack
+ *     format = 1
+ *     version = 2024.06-int8
+ *     precision = int8-dynamic
+ *     embeddings = pq64x8
+ *     encoder = swipe_encoder.int8.onnx
+ *     index = index.pq.faiss
+ *
+ * Features:
+ * - precision: fp32, fp16, int8-dynamic or int8-static (encoder weights)
+ * - embeddings: free-form label of the index encoding (fp32, sq8, pq64x8...)
+ * - encoder / index: file names relative to the pack directory
+ *   (default swipe_encoder.onnx and index.faiss)
+ * - The vocabulary, language model and ranker stay in the assets directory,
+ *   shared by every pack
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+struct ModelPack {
+    static const int FORMAT_VERSION = 1;
+
+    std::string name;         // Directory under <assets>/packs, "default" = the assets directory files
+    std::string version;      // Free-form, reported in logs and benchmarks
+    std::string precision;    // Encoder precision, see IsKnownPrecision
+    std::string embeddings;   // Index encoding label
+    std::string encoderPath;  // UTF-8 paths
+    std::string indexPath;
+
+    // Reduced precision encoders are compared with a looser tolerance
+    bool IsReducedPrecision() const { return precision != "fp32"; }
+
+    static bool IsKnownPrecision(const std::string& precision);
+
+    // The FP32 swipe_encoder.onnx and index.faiss of the assets directory
+    static ModelPack Default(const std::string& assetsDir);
+
+    // Parse <assetsDir>/packs/<name>/pack.ini and check that both files exist
+    static bool Load(const std::string& assetsDir, const std::string& name, ModelPack& pack, std::string& error);
+};
+
+#endif // MODELPACK_H
@@ -4,6 +4,12 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <cstdint>
+
+class Vocabulary;
+class ThreadPool;
+class CandidateBatch;
+class DtwPrefixCache;
 
 // Structure to hold a candidate word with all its computed features
 struct CandidateFeatures {
@@ -82,6 +88,11 @@ float dtw_multivariate(const std::vector<std::pair<float, float>>& A,
                        const std::vector<std::pair<float, float>>& B,
                        int window = -1);
 
+// Same, with B given as count interleaved x, y points (precomputed vocabulary paths)
+float dtw_multivariate(const std::vector<std::pair<float, float>>& A,
+                       const float* B, int m,
+                       int window = -1);
+
 // Get the ideal keyboard path for a word
 std::vector<std::pair<float, float>> get_word_path(const std::string& word);
 
@@ -90,14 +101,55 @@ namespace faiss {
     typedef long long idx_t;
 }
 
-// Compute all features for candidates given the raw inputs
+// One unique candidate word (deduplicated, in FAISS result order)
+struct CandidateRef {
+    uint32_t word_id;        // Vocabulary word id
+    faiss::idx_t vocab_idx;  // FAISS id (vocabulary key) the word came from
+    float faiss_distance;
+    int faiss_rank;          // 1-based rank of vocab_idx in the FAISS results
+};
+
+// DTW settings of the candidate stage (see DtwEngine)
+struct DtwOptions {
+    int window;       // Sakoe-Chiba half width in points, < 0 = unbounded (legacy features)
+    int prune_top_k;  // > 0: drop candidates that cannot reach the best k DTW scores
+                      // (lower bounds and early abandoning), 0 = score every candidate
+
+    DtwOptions() : window(-1), prune_top_k(0) {}
+};
+
+// Expand FAISS results into unique candidate words
+std::vector<CandidateRef> collect_candidates(
+    const std::map<faiss::idx_t, float>& faiss_results,  // vocab_idx -> distance
+    const Vocabulary& vocab
+);
+
+// Compute all features for candidates given the raw inputs, one batch row per
+// kept candidate (pruned ones are dropped), in candidate order. With a pool,
+// DTW and the per-candidate features run on its threads; the result does not
+// depend on the thread count (fixed chunks, merged in candidate order).
+// With a prefix cache, unbounded DTW continues from the rows of an earlier
+// prefix of the same swipe (same result, fewer rows).
+void compute_all_features(
+    const std::vector<std::pair<float, float>>& swipe_path,
+    const Vocabulary& vocab,
+    const std::vector<CandidateRef>& candidates,
+    const std::vector<float>& lm_scores,  // one score per candidate
+    CandidateBatch& batch,                // cleared, then filled in place
+    const DtwOptions& dtw_options = DtwOptions(),
+    ThreadPool* pool = nullptr,
+    DtwPrefixCache* prefix_cache = nullptr
+);
+
+// Same features as structs (tools and debugging, allocates per candidate)
 std::vector<CandidateFeatures> compute_all_features(
     const std::vector<std::pair<float, float>>& swipe_path,
-    const std::map<faiss::idx_t, float>& faiss_results,  // vocab_idx -> distance
-    const std::map<int, std::vector<std::string>>* vocab,
-    const std::vector<std::string>* vocabKeys,
-    const std::vector<float>& lm_scores,  // one score per candidate word
-    const std::vector<std::string>& candidate_words
+    const Vocabulary& vocab,
+    const std::vector<CandidateRef>& candidates,
+    const std::vector<float>& lm_scores,  // one score per candidate
+    const DtwOptions& dtw_options = DtwOptions(),
+    ThreadPool* pool = nullptr,
+    DtwPrefixCache* prefix_cache = nullptr
 );
 
 #endif // RANKING_FEATURES_H
@@ -0,0 +1,39 @@
+#ifndef SCREENCAPTURE_H
+#define SCREENCAPTURE_H
+
+#include <wx/wx.h>
+
+/**
+ * @brief Captures small regions of the desktop underneath the overlay
+ *
+ * Features:
+ * - Excludes the overlay from capture (WDA_EXCLUDEFROMCAPTURE, Windows 10 2004+)
+ *   so it can stay visible while the region is grabbed
+ * - Fallback for older systems: hide the window and wait one composition
+ *   frame (DwmFlush) instead of a fixed sleep
+ * - Region-only copy into a reusable bitmap (no full-screen bitmap kept)
+ */
+class ScreenCapture
+{
+public:
+    ScreenCapture();
+
+    // Ask the compositor to leave this window out of screen captures.
+    // Returns false (and keeps the hide fallback) when unsupported.
+    bool ExcludeFromCapture(wxWindow* window);
+    bool IsExcludedFromCapture() const { return m_excluded; }
+
+    // Copy screenRect (virtual desktop coordinates) into bitmap, reusing it when
+    // the size matches. When the window could not be excluded it is hidden for
+    // the duration of the copy.
+    bool CaptureRegion(const wxRect& screenRect, wxBitmap& bitmap);
+
+private:
+    // Block until the desktop was composed without the hidden window
+    void WaitForComposition();
+
+    wxWindow* m_window;
+    bool m_excluded;
+};
+
+#endif // SCREENCAPTURE_H
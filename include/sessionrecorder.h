@@ -0,0 +1,117 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Overlay geometry a session was recorded against
+ *
+ * Gaze samples are stored in overlay client coordinates, the replay needs
+ * the keyboard placement to turn them into keyboard-local positions.
+ */
+struct SessionGeometry {
+    float overlayWidth;
+    float overlayHeight;
+    float keyboardX;       // Keyboard area origin in the overlay
+    float keyboardY;
+    float keyboardWidth;
+    float keyboardHeight;
+
+    SessionGeometry()
+        : overlayWidth(0.0f), overlayHeight(0.0f)
+        , keyboardX(0.0f), keyboardY(0.0f)
+        , keyboardWidth(0.0f), keyboardHeight(0.0f)
+    {}
+};
+
+/**
+ * @brief Recorded session, loaded in one piece for replay
+ */
+struct SessionData {
+    struct Gaze {
+        float x;                 // Overlay client coordinates
+        float y;
+        uint64_t timestamp;      // Microseconds
+        bool keyboardVisible;    // Keyboard was shown when the sample arrived
+    };
+
+    struct Swipe {
+        uint64_t timestamp;
+        std::vector<std::pair<float, float>> path;  // Model-normalized, as sent to the engine
+        std::string context;     // Text before the swipe (UTF-8)
+        std::string word;        // Word the user committed, "" = unknown or removed
+        size_t gazeIndex;        // Gaze samples recorded before the swipe completed
+    };
+
+    SessionGeometry geometry;
+    std::vector<Gaze> gaze;
+    std::vector<Swipe> swipes;
+};
+
+/**
+ * @brief Compact binary recorder of gaze streams and completed swipes
+ *
+ * File layout (little endian): "HEYESES1" magic, uint32 version, the
+ * SessionGeometry floats, then tagged records:
+ * - GAZE:     float x, float y, uint64 timestamp (17 bytes with the tag)
+ * - KEYBOARD: uint8 visible, uint64 timestamp
+ * - SWIPE:    uint64 timestamp, uint32 points, float x/y pairs,
+ *             uint32 length + UTF-8 text before the swipe
+ * - WORD:     uint32 length + UTF-8 word committed for the last swipe, ""
+ *             when the user removed it (a later WORD replaces it, e.g.
+ *             the word retyped after the deletion)
+ *
+ * Features:
+ * - Buffered writes, a 120 Hz session is about 2 KB/s
+ * - A truncated file (application killed) loads up to its last full record
+ *
+ * Not thread safe (GUI thread).
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class SessionRecorder
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    SessionRecorder();
+    ~SessionRecorder();
+
+    bool Open(const std::string& filepath, const SessionGeometry& geometry);
+    void Close();
+    bool IsOpen() const { return m_file.is_open(); }
+
+    void RecordGaze(float x, float y, uint64_t timestamp);
+    void RecordKeyboardVisible(bool visible, uint64_t timestamp);
+    void RecordSwipe(const std::vector<std::pair<float, float>>& path, const std::string& context, uint64_t timestamp);
+    void RecordWord(const std::string& word);
+
+    size_t GetGazeCount() const { return m_gazeCount; }
+    size_t GetSwipeCount() const { return m_swipeCount; }
+
+    // Read a whole recording, error describes why on failure
+    static bool Load(const std::string& filepath, SessionData& data, std::string& error);
+
+private:
+    enum RecordType : uint8_t {
+        RECORD_GAZE = 1,
+        RECORD_KEYBOARD = 2,
+        RECORD_SWIPE = 3,
+        RECORD_WORD = 4
+    };
+
+    template <typename T>
+    void Write(const T& value) { m_file.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void WriteString(const std::string& text);
+
+    std::vector<char> m_buffer;  // Stream buffer of m_file (declared first, outlives it)
+    std::ofstream m_file;
+    size_t m_gazeCount;
+    size_t m_swipeCount;
+};
+
+#endif // SESSIONRECORDER_H
@@ -36,6 +36,18 @@ public:
     bool GetAutoShowKeyboard() const { return m_autoShowKeyboard; }
     void SetAutoShowKeyboard(bool enable) { m_autoShowKeyboard = enable; }
 
+    float GetSwipeMinCutoff() const { return m_swipeMinCutoff; }
+    void SetSwipeMinCutoff(float hz) { m_swipeMinCutoff = hz; }
+
+    float GetSwipeBeta() const { return m_swipeBeta; }
+    void SetSwipeBeta(float beta) { m_swipeBeta = beta; }
+
+    float GetSwipeFixationRadius() const { return m_swipeFixationRadius; }
+    void SetSwipeFixationRadius(float radius) { m_swipeFixationRadius = radius; }
+
+    float GetSwipeResampleStep() const { return m_swipeResampleStep; }
+    void SetSwipeResampleStep(float step) { m_swipeResampleStep = step; }
+
     // Zoom
     float GetZoomFactor() const { return m_zoomFactor; }
     void SetZoomFactor(float factor) { m_zoomFactor = factor; }
@@ -55,6 +67,61 @@ public:
     int GetSelectionHeight() const { return m_selectionHeight; }
     void SetSelectionHeight(int height) { m_selectionHeight = height; }
 
+    // Display
+    int GetTrackedDisplay() const { return m_trackedDisplay; }
+    void SetTrackedDisplay(int index) { m_trackedDisplay = index; }
+
+    // ML
+    int GetEncoderIntraOpThreads() const { return m_encoderIntraOpThreads; }
+    void SetEncoderIntraOpThreads(int threads) { m_encoderIntraOpThreads = threads; }
+
+    int GetEncoderGraphOptimization() const { return m_encoderGraphOptimization; }
+    void SetEncoderGraphOptimization(int level) { m_encoderGraphOptimization = level; }
+
+    bool GetEncoderCpuMemArena() const { return m_encoderCpuMemArena; }
+    void SetEncoderCpuMemArena(bool enable) { m_encoderCpuMemArena = enable; }
+
+    int GetDtwWindow() const { return m_dtwWindow; }
+    void SetDtwWindow(int window) { m_dtwWindow = window; }
+
+    int GetDtwPruneTopK() const { return m_dtwPruneTopK; }
+    void SetDtwPruneTopK(int topK) { m_dtwPruneTopK = topK; }
+
+    int GetRankingThreads() const { return m_rankingThreads; }
+    void SetRankingThreads(int threads) { m_rankingThreads = threads; }
+
+    int GetFaissTopK() const { return m_faissTopK; }
+    void SetFaissTopK(int topK) { m_faissTopK = topK; }
+
+    int GetFaissNprobe() const { return m_faissNprobe; }
+    void SetFaissNprobe(int nprobe) { m_faissNprobe = nprobe; }
+
+    int GetFaissEfSearch() const { return m_faissEfSearch; }
+    void SetFaissEfSearch(int efSearch) { m_faissEfSearch = efSearch; }
+
+    int GetSpeculativeInterval() const { return m_speculativeInterval; }
+    void SetSpeculativeInterval(int points) { m_speculativeInterval = points; }
+
+    int GetRankerBackend() const { return m_rankerBackend; }
+    void SetRankerBackend(int backend) { m_rankerBackend = backend; }
+
+    int GetCandidateCount() const { return m_candidateCount; }
+    void SetCandidateCount(int count) { m_candidateCount = count; }
+
+    int GetExecutionProvider() const { return m_executionProvider; }
+    void SetExecutionProvider(int provider) { m_executionProvider = provider; }
+
+    wxString GetModelPack() const { return m_modelPack; }
+    void SetModelPack(const wxString& pack) { m_modelPack = pack; }
+
+    // Debug
+    bool GetRecordSession() const { return m_recordSession; }
+    void SetRecordSession(bool record) { m_recordSession = record; }
+    bool GetTraceEnabled() const { return m_traceEnabled; }
+    void SetTraceEnabled(bool enabled) { m_traceEnabled = enabled; }
+    bool GetShowTraceStats() const { return m_showTraceStats; }
+    void SetShowTraceStats(bool show) { m_showTraceStats = show; }
+
     // Get config file path
     wxString GetConfigFilePath() const;
 
@@ -70,6 +137,10 @@ private:
 
     // keyboard/
     bool m_autoShowKeyboard;  // Auto-show keyboard on text cursor (default: true)
+    float m_swipeMinCutoff;      // Swipe path One Euro cutoff at rest in Hz, 0 = no smoothing (default: 1.0)
+    float m_swipeBeta;           // Swipe path One Euro speed coefficient (default: 0.02)
+    float m_swipeFixationRadius; // Swipe samples this close to the last kept one are dropped, model units (default: 1.0)
+    float m_swipeResampleStep;   // Swipe path point spacing in model units (key ~ 20), 0 = off (default: 2.0)
 
     // zoom/
     float m_zoomFactor;       // Magnification level (default: 3.0)
@@ -81,6 +152,30 @@ private:
     int m_colorB;             // UI color B (default: 255)
     int m_selectionWidth;     // Screenshot size width (default: 300)
     int m_selectionHeight;    // Screenshot size height (default: 300)
+
+    // display/
+    int m_trackedDisplay;     // Monitor mapped to the eye tracker, -1 = under mouse at startup (default: -1)
+
+    // ml/
+    int m_encoderIntraOpThreads;     // ONNX encoder threads, 0 = runtime default (default: 0)
+    int m_encoderGraphOptimization;  // ONNX graph optimization 0-3 (default: 3 = all)
+    bool m_encoderCpuMemArena;       // ONNX CPU arena allocator (default: false)
+    int m_dtwWindow;                 // DTW band half width in points, -1 = unbounded (default: -1)
+    int m_dtwPruneTopK;              // DTW pruning top k, 0 = exact for all candidates (default: 0)
+    int m_rankingThreads;            // Candidate scoring threads, 0 = one per core (default: 0)
+    int m_faissTopK;                 // FAISS neighbours ranked per swipe (default: 100)
+    int m_faissNprobe;               // IVF lists probed per search, 0 = value in the index file (default: 16)
+    int m_faissEfSearch;             // HNSW search beam width, 0 = value in the index file (default: 128)
+    int m_speculativeInterval;       // Swipe points between partial predictions, 0 = off (default: 24)
+    int m_rankerBackend;             // 0 = auto, 1 = LightGBM C API, 2 = compiled trees (default: 0)
+    int m_candidateCount;            // Words per swipe: the inserted one + alternates in the bar (default: 5)
+    int m_executionProvider;         // Encoder: 0 = CPU, 1 = auto, 2 = DirectML, 3 = CUDA, 4 = OpenVINO, falls back to CPU (default: 0)
+    wxString m_modelPack;            // Encoder + index variant in <assets>/packs/<name>, "" = the FP32 files (default: "")
+
+    // debug/
+    bool m_recordSession;            // Record gaze and swipes to <user data>/sessions for HeyEyeBench (default: false)
+    bool m_traceEnabled;             // Collect hot-path timings, Chrome trace written on exit to <user data>/traces (default: false)
+    bool m_showTraceStats;           // Rolling latency panel on the overlay, implies collecting timings (default: false)
 };
 
 #endif // SETTINGS_H
@@ -0,0 +1,100 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-size lock-free single-producer/single-consumer ring buffer
+ *
+ * Features:
+ * - Wait-free push and pop, no allocation after construction
+ * - Capacity must be a power of two, all slots are usable
+ * - When full, new items are dropped and counted instead of blocking the producer
+ * - Batch pop so the consumer pays one acquire per drain
+ *
+ * Exactly one thread may call TryPush and exactly one (other) thread may
+ * call TryPop/PopBatch.
+ */
+template <typename T, size_t Capacity>
+class SpscRingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRingBuffer capacity must be a power of two");
+
+public:
+    SpscRingBuffer()
+        : m_head(0)
+        , m_tail(0)
+        , m_dropped(0)
+    {
+    }
+
+    // Producer side. Returns false (and counts a drop) when the buffer is full.
+    bool TryPush(const T& item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail >= Capacity) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_items[head & (Capacity - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool TryPop(T& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        if (tail == head) {
+            return false;
+        }
+
+        item = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pops up to maxItems into out, returns the number copied
+    size_t PopBatch(T* out, size_t maxItems)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        size_t count = head - tail;
+        if (count > maxItems) {
+            count = maxItems;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = m_items[(tail + i) & (Capacity - 1)];
+        }
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Approximate when called from a thread that is neither producer nor consumer
+    size_t Size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const { return Size() == 0; }
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+    // Number of items rejected because the buffer was full
+    uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+    alignas(64) std::atomic<uint64_t> m_dropped;
+    T m_items[Capacity];
+};
+
+#endif // SPSCRINGBUFFER_H
@@ -0,0 +1,84 @@
+#ifndef SWIPEPATHFILTER_H
+#define SWIPEPATHFILTER_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Capture-time settings of SwipePathFilter (model-normalized units, one key ~ 20)
+ */
+struct SwipePathFilterOptions {
+    float minCutoffHz;         // One Euro cutoff at rest, lower = smoother fixations, 0 = no smoothing
+    float beta;                // One Euro speed coefficient, higher = less lag on fast strokes
+    float derivativeCutoffHz;  // One Euro cutoff of the speed estimate
+    float fixationRadius;      // Samples closer than this to the last kept one are dropped, 0 = keep all
+    float resampleStep;        // Arc length between output points, 0 = one point per kept sample
+
+    SwipePathFilterOptions()
+        : minCutoffHz(1.0f)
+        , beta(0.02f)
+        , derivativeCutoffHz(1.0f)
+        , fixationRadius(1.0f)
+        , resampleStep(2.0f)
+    {}
+};
+
+/**
+ * @brief Online smoothing and spatial resampling of a swipe path as it is captured
+ *
+ * Each gaze sample goes through three stages:
+ * - One Euro filter per axis (adaptive low-pass: heavy at rest, light when moving)
+ * - Fixation de-duplication: samples within fixationRadius of the last kept
+ *   one are dropped, so dwelling on a key adds nothing
+ * - Arc-length resampling: points are emitted every resampleStep along the
+ *   smoothed path, independent of the tracker rate and of the stroke speed
+ *
+ * The output is what the encoder and DTW see, so its length (and the O(n*m)
+ * DTW cost) follows the distance travelled instead of the time spent.
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class SwipePathFilter
+{
+public:
+    typedef std::pair<float, float> Point;
+
+    SwipePathFilter();
+
+    void SetOptions(const SwipePathFilterOptions& options);
+    const SwipePathFilterOptions& GetOptions() const { return m_options; }
+
+    // Start a new path
+    void Reset();
+
+    // Feed one sample (timestamp in microseconds), appends the 0..n points it produces
+    void Add(float x, float y, uint64_t timestamp, std::vector<Point>& out);
+
+    // End of the stroke: appends the last kept sample if resampling skipped it
+    void Finish(std::vector<Point>& out);
+
+private:
+    struct OneEuroAxis {
+        float value;
+        float derivative;
+    };
+
+    static float Alpha(float cutoffHz, float dt);
+    float Smooth(OneEuroAxis& axis, float sample, float dt) const;
+    void Emit(const Point& point, std::vector<Point>& out);
+
+    SwipePathFilterOptions m_options;
+
+    bool m_started;
+    uint64_t m_lastTimestamp;
+    OneEuroAxis m_axisX;
+    OneEuroAxis m_axisY;
+
+    Point m_kept;         // Last sample that passed the fixation test
+    Point m_emitted;      // Last output point
+    float m_sinceEmitted; // Arc length travelled since m_emitted
+    bool m_keptEmitted;   // m_kept is also the last output point
+};
+
+#endif // SWIPEPATHFILTER_H
@@ -7,9 +7,17 @@
 #include <utility>
 #include <string>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include "languagecontext.h"
+#include "modelpack.h"
 
 // Forward declarations for ML components
 namespace Ort {
+    struct Env;
     class Session;
     struct MemoryInfo;
 }
@@ -19,7 +27,76 @@ namespace faiss {
     typedef long long idx_t;
 }
 
+class CandidateBatch;
 class LightGBMRanker;
+class ThreadPool;
+class Vocabulary;
+
+/**
+ * @brief Machine-specific tuning for the ML pipeline (settings section /ml/)
+ *
+ * Must be set before Initialize(); changing it afterwards has no effect on
+ * already loaded models.
+ */
+struct TextInputEngineOptions {
+    int intraOpThreads;          // ONNX encoder intra-op threads, 0 = runtime default
+    int graphOptimizationLevel;  // 0 = disabled, 1 = basic, 2 = extended, 3 = all
+    bool cpuMemArena;            // ONNX CPU arena for intermediate tensors
+    int dtwWindow;               // DTW Sakoe-Chiba half width in points, < 0 = unbounded
+    int dtwPruneTopK;            // Full DTW only for candidates that can enter the top k, 0 = all
+    int rankingThreads;          // Candidate scoring threads, 0 = one per core, 1 = serial
+    int faissTopK;               // FAISS neighbours ranked per swipe
+    int faissNprobe;             // IVF index lists probed per search, 0 = value in the index file
+    int faissEfSearch;           // HNSW index search beam width, 0 = value in the index file
+    int rankerBackend;           // LightGBMRanker::Backend: 0 = auto, 1 = C API, 2 = compiled trees
+    int candidateCount;          // Ranked words reported per swipe (best + alternates)
+    int executionProvider;       // Swipe encoder: 0 = CPU, 1 = auto (DirectML, CUDA, OpenVINO, CPU),
+                                 // 2 = DirectML, 3 = CUDA, 4 = OpenVINO (CPU if unavailable)
+    std::string modelPack;       // Encoder + index pack in <assets>/packs/<name>, "" = the FP32 files
+
+    TextInputEngineOptions()
+        : intraOpThreads(0)
+        , graphOptimizationLevel(3)
+        , cpuMemArena(false)
+        , dtwWindow(-1)
+        , dtwPruneTopK(0)
+        , rankingThreads(0)
+        , faissTopK(100)
+        , faissNprobe(16)
+        , faissEfSearch(128)
+        , rankerBackend(0)
+        , candidateCount(5)
+        , executionProvider(0)
+        , modelPack()
+    {}
+};
+
+/**
+ * @brief Wall time of the stages of one prediction (see TextInputEngine::PredictTopKFromSwipe)
+ */
+struct PredictionTimings {
+    double encodeMs;  // ONNX swipe encoder
+    double searchMs;  // FAISS vocabulary search
+    double rankMs;    // LM scores, features and ranker
+
+    PredictionTimings() : encodeMs(0.0), searchMs(0.0), rankMs(0.0) {}
+};
+
+/**
+ * @brief Load result of one startup stage (see TextInputEngine::GetStartupStages)
+ */
+struct StartupStage {
+    wxString name;
+    bool required;        // Swipe prediction is unavailable when a required stage fails
+    bool loaded;
+    double milliseconds;  // Wall time of the stage on its pool thread
+
+    StartupStage()
+        : required(true)
+        , loaded(false)
+        , milliseconds(0.0)
+    {}
+};
 
 /**
  * @brief Manages text prediction using ML models and letter-by-letter input
@@ -27,49 +104,139 @@ class LightGBMRanker;
  * Integrates:
  * - ONNX swipe encoder for gesture embeddings
  * - FAISS vector search for candidate retrieval
- * - KenLM language model for scoring
+ * - KenLM language model for scoring (binary models are memory-mapped), the
+ *   context state follows the text edits (LanguageContext)
  * - LightGBM ranker for final prediction
  * - Letter-by-letter direct input
+ *
+ * Swipe predictions can run on a background worker thread
+ * (PredictFromSwipeAsync); results are marshalled back to the GUI thread
+ * through wx events and delivered via the usual callbacks.
+ *
+ * While the gesture is in progress, partial predictions
+ * (PredictPartialSwipeAsync) show a provisional word and leave their LM
+ * scores and DTW rows behind, so the completed swipe only computes the
+ * candidates and swipe points that are new.
+ *
+ * The models are independent and load concurrently on a thread pool.
+ * InitializeAsync returns immediately so letter input works while they load;
+ * swipe prediction switches on once every required stage is ready.
  */
-class TextInputEngine
+class TextInputEngine : public wxEvtHandler
 {
 public:
     explicit TextInputEngine();
     ~TextInputEngine();
 
     // Initialization
+    void SetOptions(const TextInputEngineOptions& options) { m_options = options; }
+    const TextInputEngineOptions& GetOptions() const { return m_options; }
     bool Initialize(const wxString& assetsPath);
-    bool IsInitialized() const { return m_initialized; }
+    bool IsInitialized() const { return m_initialized.load(); }
+
+    // Load the assets in the background. OnInitialized reports the outcome on
+    // the GUI thread; until then swipe predictions are rejected.
+    void InitializeAsync(const wxString& assetsPath);
+    bool IsInitializing() const { return m_initializing.load(); }
+
+    // Per-stage timings of the last (finished) initialization
+    std::vector<StartupStage> GetStartupStages() const;
+
+    // Execution provider the swipe encoder was loaded on ("CPU", "DirectML", ...), "none" before
+    const char* GetEncoderProvider() const { return m_encoderProvider; }
+
+    // Encoder and index files of the last initialization (the default pack
+    // when options.modelPack could not be loaded)
+    const ModelPack& GetModelPack() const { return m_modelPack; }
 
     // Current text management
-    wxString GetCurrentText() const { return m_currentText; }
+    const wxString& GetCurrentText() const { return m_currentText; }
     void AppendCharacter(wxChar c);
     void AppendText(const wxString& text);
     void DeleteLastCharacter();
     void DeleteLastWord();
     void Clear();
 
-    // Swipe prediction
+    // Swipe prediction (synchronous, runs on the calling thread; waits for an
+    // asynchronous prediction that is running, they share the pipeline buffers)
     wxString PredictFromSwipe(const std::vector<std::pair<float, float>>& swipePath);
-    std::vector<wxString> PredictTopKFromSwipe(const std::vector<std::pair<float, float>>& swipePath, int k = 5);
+
+    // Best words of one ranking pass, best first (at most k)
+    std::vector<wxString> PredictTopKFromSwipe(const std::vector<std::pair<float, float>>& swipePath, int k = 5,
+                                               PredictionTimings* timings = nullptr);
+
+    // Swipe prediction on the worker thread. A new request supersedes any
+    // request that is still queued or running; only the latest one reports
+    // through OnPredictionReady and OnTopKPredictionsReady (the best
+    // options.candidateCount words of the same pass, on the GUI thread).
+    void PredictFromSwipeAsync(const std::vector<std::pair<float, float>>& swipePath);
+    void CancelPendingPredictions();
+
+    // Speculative prediction of the swipe recorded so far, reported through
+    // OnProvisionalPrediction. Never supersedes a completed swipe still
+    // waiting for its word (the partial request is dropped instead).
+    void PredictPartialSwipeAsync(const std::vector<std::pair<float, float>>& swipePath);
+    void CancelPartialPredictions();  // Swipe abandoned, no provisional word
 
     // Language model access for external use
     float EvaluateSequence(const std::vector<wxString>& words);
 
-    // Incremental evaluation with state (for ranking candidates)
+    // Incremental evaluation, the state is a value to continue from
     struct KenLMResult {
-        float logProb;
-        void* state;  // Opaque pointer to lm::ngram::State
+        float logProb;   // Including </s>
+        LmState state;   // After the last word (before </s>)
     };
-    KenLMResult EvaluateIncremental(const std::vector<wxString>& words, float initialLogProb = 0.0f, void* initialState = nullptr);
-    void* GetBeginSentenceState();
+    KenLMResult EvaluateIncremental(const std::vector<wxString>& words, float initialLogProb = 0.0f,
+                                    const LmState* initialState = nullptr);
+    LmState GetBeginSentenceState();
 
     // Callbacks (replace Qt signals)
     std::function<void(const wxString&)> OnTextChanged;
     std::function<void(const wxString&)> OnPredictionReady;
     std::function<void(const std::vector<wxString>&)> OnTopKPredictionsReady;
+    std::function<void(const wxString&)> OnProvisionalPrediction;  // Swipe still in progress
+    std::function<void(bool)> OnInitialized;  // Swipe prediction ready (true) or unavailable
 
 private:
+    // Background prediction worker
+    struct PredictionRequest {
+        uint64_t id;
+        std::vector<std::pair<float, float>> swipePath;
+        LmContext context;     // LM state of the text when the request was made
+        bool partial;          // Gesture still in progress
+        PredictionRequest() : id(0), partial(false) {}
+    };
+    struct PredictionResult {
+        uint64_t id;
+        std::vector<std::string> words;  // Best first, UTF-8, converted on the GUI thread
+        bool partial;
+    };
+    void PredictionWorkerLoop();
+    void StopPredictionWorker();
+    void OnPredictionResult(wxThreadEvent& event);
+
+    // Work carried from the partial predictions of a swipe to the next ones
+    // (defined in the .cpp, prediction worker only)
+    struct SwipeCache;
+
+    // Full encode -> search -> rank pipeline. isCancelled is polled between
+    // stages so stale requests stop early. With a cache, LM scores of earlier
+    // swipes and DTW rows of earlier partial runs are reused (same result).
+    // Returns the topK best words, best first.
+    std::vector<std::string> RunPrediction(const std::vector<std::pair<float, float>>& swipePath,
+                                           const LmContext& context,
+                                           size_t topK,
+                                           const std::function<bool()>& isCancelled,
+                                           SwipeCache* cache = nullptr,
+                                           PredictionTimings* timings = nullptr);
+
+    // Context of m_currentText for a request (GUI thread)
+    LmContext GetLanguageContext();
+
+    // Run every load stage on a pool, blocks until all are done
+    bool LoadAssets(const wxString& assetsPath);
+    void OnInitializationDone(wxThreadEvent& event);
+
     // Initialization helpers
     bool LoadSwipeEncoder(const wxString& modelPath);
     bool LoadVocabulary(const wxString& vocabPath);
@@ -77,32 +244,80 @@ private:
     bool LoadKenLM(const wxString& modelPath);
     bool LoadLightGBM(const wxString& modelPath);
 
-    // Swipe encoding
-    std::vector<float> EncodeSwipe(const std::vector<std::pair<float, float>>& swipePath);
+    // Swipe encoding through the pre-bound encoder context. embedding is
+    // overwritten (its capacity is reused). Returns false on failure.
+    bool EncodeSwipe(const std::vector<std::pair<float, float>>& swipePath, std::vector<float>& embedding);
+
+    // Persistent encoder inputs/outputs bound once after loading, one binding
+    // per sequence length bucket when the model allows it (defined with ONNX only)
+    struct EncoderContext;
+    bool CreateEncoderContext();
+
+    // Run every bound length once so graph initialization and kernel
+    // selection happen at startup, not on the first swipe
+    bool WarmUpEncoder();
 
     // Vocabulary search
     std::map<faiss::idx_t, float> SearchVocabulary(const std::vector<float>& embedding, int topK = 100);
 
-    // Ranking
-    std::string RankCandidates(
+    // Ranking, the topK best words of one pass (best first)
+    std::vector<std::string> RankCandidates(
         const std::vector<std::pair<float, float>>& swipePath,
-        const std::map<faiss::idx_t, float>& candidates
+        const std::map<faiss::idx_t, float>& candidates,
+        const LmContext& context,
+        size_t topK,
+        SwipeCache* cache
     );
 
-    bool m_initialized;
+    std::atomic<bool> m_initialized;
+    TextInputEngineOptions m_options;
     wxString m_currentText;
     std::vector<wxString> m_wordHistory;
+    LanguageContext m_languageContext;  // Words of m_currentText and their LM states (GUI thread)
 
     // ML Components (using pointers to avoid header dependencies)
+    Ort::Env* m_ortEnv;             // Outlives the sessions created from it
     Ort::Session* m_swipeEncoder;
+    const char* m_encoderProvider;  // Execution provider the encoder runs on
+    size_t m_embeddingSize;         // Encoder output floats, 0 before the warm-up run
+    ModelPack m_modelPack;          // Resolved by LoadAssets before the stages start
     Ort::MemoryInfo* m_memoryInfo;
+    EncoderContext* m_encoderContext;
     faiss::Index* m_faissIndex;
-    void* m_kenLM;  // Opaque pointer to lm::ngram::Model
+    void* m_kenLM;  // Opaque pointer to lm::base::Model (ARPA or mmapped binary)
     LightGBMRanker* m_lightGBM;
 
-    // Vocabulary
-    std::map<int, std::vector<std::string>>* m_vocab;
-    std::vector<std::string>* m_vocabKeys;
+    // Vocabulary (memory-mapped vocab.bin, or built from the legacy msgpack)
+    Vocabulary* m_vocab;
+
+    // Candidate scoring workers (LM, DTW, features), null = serial
+    ThreadPool* m_rankingPool;
+
+    // Encoder output, ranker input and output, reused across swipes (guarded by
+    // m_pipelineMutex, held for a whole RunPrediction by the worker, the
+    // synchronous calls and the warm-up); m_embedding is reserved once the
+    // encoder size is known
+    std::mutex m_pipelineMutex;
+    std::vector<float> m_embedding;
+    CandidateBatch* m_candidateBatch;
+    std::vector<size_t> m_rankOrder;
+    SwipeCache* m_swipeCache;  // Prediction worker only
+
+    // Prediction worker state (m_pendingRequest guarded by m_requestMutex)
+    std::thread m_predictionThread;
+    std::mutex m_requestMutex;
+    std::condition_variable m_requestCondition;
+    PredictionRequest m_pendingRequest;
+    bool m_hasPendingRequest;
+    bool m_finalInFlight;  // A completed swipe has not delivered its word yet
+    bool m_stopWorker;
+    std::atomic<uint64_t> m_latestRequestId;
+
+    // Background initialization (m_startupStages guarded by m_startupMutex)
+    std::thread m_startupThread;
+    std::atomic<bool> m_initializing;
+    mutable std::mutex m_startupMutex;
+    std::vector<StartupStage> m_startupStages;
 };
 
 #endif // TEXTINPUTENGINE_H
@@ -0,0 +1,68 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Small fixed-size pool of worker threads
+ *
+ * Features:
+ * - FIFO task queue, Submit() returns a std::future for the result
+ * - Exceptions thrown by a task are stored in its future
+ * - ParallelFor() splits an index range into fixed chunks claimed on demand
+ * - Destruction drains the queue (every submitted task runs) and joins
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class ThreadPool
+{
+public:
+    // threadCount 0 picks hardware_concurrency (at least 1)
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+    // Queue a callable, any thread
+    template <typename F>
+    std::future<std::invoke_result_t<F>> Submit(F&& task)
+    {
+        typedef std::invoke_result_t<F> Result;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        Enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    // Run body(begin, end) over [0, count) in chunks of grain indices, on the
+    // workers and the calling thread; returns when every chunk is done and
+    // rethrows the first exception. Chunk boundaries only depend on count and
+    // grain, so per-index results do not depend on the thread count. Safe to
+    // call from a worker: the caller claims chunks itself and only waits for
+    // helpers that already started, the ones still queued behind it skip.
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+private:
+    void Enqueue(std::function<void()> task);
+    void WorkerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;  // Guarded by m_mutex
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,158 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "spscringbuffer.h"
+
+/**
+ * @brief One timed section of a thread (Chrome trace "complete" event)
+ *
+ * Names are string literals, nothing is formatted on the hot path.
+ */
+struct TraceEvent {
+    const char* name;
+    uint64_t start;     // Tracer::Now() microseconds
+    uint64_t duration;  // Microseconds
+    uint32_t thread;    // Tracer thread id (registration order)
+};
+
+/**
+ * @brief Rolling latency summary of one trace name (last ROLLING_WINDOW events)
+ */
+struct TraceStageStats {
+    const char* name;
+    uint64_t count;     // Events since tracing started
+    double lastMs;
+    double p50Ms;
+    double p95Ms;
+    double maxMs;
+};
+
+/**
+ * @brief Process-wide collector of scoped timers
+ *
+ * Every thread that records gets its own SPSC ring on first use (the only
+ * locked step), so recording is a clock read and a wait-free push. One
+ * consumer thread (the GUI) drains the rings into rolling per-name windows
+ * for the stats panel and into a bounded history for the trace export.
+ *
+ * Features:
+ * - Compiled out entirely without HEYEYE_TRACE (the TRACE_* macros are empty)
+ * - Runtime switch: a disabled tracer costs one relaxed load per scope
+ * - Full rings drop events and count them rather than blocking
+ * - Chrome trace JSON export (chrome://tracing, Perfetto, Tracy import-chrome)
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class Tracer
+{
+public:
+    static const size_t THREAD_BUFFER_SIZE = 4096;  // Events per thread between two drains
+    static const size_t HISTORY_SIZE = 65536;       // Events kept for the export (~1 min of use)
+    static const size_t ROLLING_WINDOW = 256;       // Events per name in the stats
+
+    static Tracer& Get();
+
+    // Monotonic microseconds (steady clock, never 0)
+    static uint64_t Now();
+
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Any thread. start/end come from Now().
+    void Record(const char* name, uint64_t start, uint64_t end);
+
+    // Name of the calling thread in the export (literal, e.g. "prediction")
+    void SetThreadName(const char* name);
+
+    // Consumer side (one thread)
+    void Drain();
+    std::vector<TraceStageStats> GetStats() const;  // In order of first appearance
+    bool ExportChromeTrace(const std::string& filepath);
+    uint64_t GetDroppedCount() const;
+
+private:
+    struct ThreadBuffer {
+        SpscRingBuffer<TraceEvent, THREAD_BUFFER_SIZE> events;
+        uint32_t id;
+        std::atomic<const char*> name;  // Set by the owning thread, read by the export
+        ThreadBuffer() : id(0), name(nullptr) {}
+    };
+
+    struct Window {
+        const char* name;
+        uint64_t count;
+        double lastMs;
+        std::vector<float> durations;  // Ring of ROLLING_WINDOW milliseconds
+    };
+
+    Tracer();
+    ThreadBuffer* GetThreadBuffer();
+    void Accumulate(const TraceEvent& event);
+
+    std::atomic<bool> m_enabled;
+
+    mutable std::mutex m_threadsMutex;  // Guards the list, never an individual ring
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+    // Consumer state
+    std::vector<TraceEvent> m_drainBuffer;
+    std::vector<TraceEvent> m_history;  // Ring of HISTORY_SIZE events
+    size_t m_historyNext;
+    std::vector<Window> m_windows;
+};
+
+/**
+ * @brief Records the enclosing scope as one trace event (use TRACE_SCOPE)
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(name)
+        , m_active(Tracer::Get().IsEnabled())
+        , m_start(m_active ? Tracer::Now() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_active) {
+            Tracer::Get().Record(m_name, m_start, Tracer::Now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    bool m_active;
+    uint64_t m_start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef HEYEYE_TRACE
+// Time the rest of the enclosing scope
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+// Time from start (TRACE_NOW() taken earlier, possibly on another thread) to now
+#define TRACE_INTERVAL(name, start) \
+    do { if ((start) != 0 && Tracer::Get().IsEnabled()) Tracer::Get().Record(name, start, Tracer::Now()); } while (0)
+#define TRACE_NOW() (Tracer::Get().IsEnabled() ? Tracer::Now() : uint64_t(0))
+#define TRACE_THREAD_NAME(name) Tracer::Get().SetThreadName(name)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_INTERVAL(name, start) do { (void)(start); } while (0)
+#define TRACE_NOW() uint64_t(0)
+#define TRACE_THREAD_NAME(name) do {} while (0)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,74 @@
+#ifndef TREEENSEMBLE_H
+#define TREEENSEMBLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief LightGBM model compiled into flat arrays for batch inference
+ *
+ * Reads the text model written by LightGBM (lightgbm_ranker.txt) and
+ * evaluates it without the LightGBM runtime: same split rule (numerical
+ * "value <= threshold" in double, missing value handling of the decision
+ * type), same tree order for the sum, same output transform, so scores
+ * match LGBM_BoosterPredictForMat with C_API_PREDICT_NORMAL.
+ *
+ * Features:
+ * - All nodes of all trees in one array, 24 bytes per node, children as a
+ *   pair indexed by the comparison result (no branch on the split outcome)
+ * - Tree-major evaluation: one tree is walked for the whole batch before the
+ *   next one, so it stays in cache
+ * - Supported: numerical splits, identity / sigmoid (binary) output, one
+ *   class. Anything else (categorical splits, linear trees, multiclass)
+ *   makes Load() fail so the caller can fall back to the C API
+ *
+ * No wxWidgets dependency so it can be driven from benchmarks.
+ */
+class TreeEnsemble
+{
+public:
+    TreeEnsemble();
+
+    // Parse a LightGBM text model, error describes why on failure
+    bool Load(const std::string& filepath, std::string& error);
+    bool LoadFromString(const std::string& model, std::string& error);
+
+    bool IsLoaded() const { return !m_treeRoots.empty(); }
+    int GetFeatureCount() const { return m_featureCount; }
+    size_t GetTreeCount() const { return m_treeRoots.size(); }
+
+    // Sorted split thresholds of a feature, to build rows reaching every branch
+    const std::vector<double>& GetFeatureThresholds(int feature) const { return m_featureThresholds[feature]; }
+
+    // scores[r] for count rows of GetFeatureCount() floats, stride floats apart
+    void Predict(const float* rows, size_t count, size_t stride, double* scores) const;
+
+private:
+    // Internal node. child[0] = left ("<= threshold"), child[1] = right.
+    // Child >= 0 is a node index relative to the tree root, < 0 is ~leaf.
+    struct Node {
+        double threshold;
+        int32_t feature;
+        int32_t child[2];
+        uint8_t missingType;   // 0 none, 1 zero, 2 NaN
+        uint8_t defaultLeft;
+        uint8_t padding[2];
+    };
+
+    bool ParseTree(const std::vector<std::pair<std::string, std::string>>& fields, std::string& error);
+    void Clear();
+
+    int m_featureCount;
+    double m_sigmoid;          // > 0: binary objective, score = 1 / (1 + exp(-sigmoid * raw))
+
+    std::vector<Node> m_nodes;
+    std::vector<double> m_leaves;
+    std::vector<uint32_t> m_treeRoots;        // First node of each tree in m_nodes
+    std::vector<uint32_t> m_treeLeafBegin;    // First leaf of each tree in m_leaves
+    std::vector<uint8_t> m_treeSingleLeaf;    // Tree is a constant (no split)
+    std::vector<std::vector<double>> m_featureThresholds;
+};
+
+#endif // TREEENSEMBLE_H
@@ -0,0 +1,125 @@
+#ifndef VOCABULARY_H
+#define VOCABULARY_H
+
+#include "mappedfile.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Flat, memory-mappable swipe vocabulary (vocab.bin)
+ *
+ * Every FAISS id ("key") owns a contiguous range of surface words. The
+ * keyboard path of the key's canonical (first) word is precomputed and each
+ * word can carry its KenLM WordIndex, so ranking never looks words up.
+ *
+ * File layout (little-endian, every section 4-byte aligned):
+ *   VocabFileHeader
+ *   uint32 keyWordBegin[keyCount + 1]      word range of each key
+ *   uint32 keyPathBegin[keyCount + 1]      point range of each key
+ *   uint32 wordStringBegin[wordCount + 1]  byte range of each word in the pool
+ *   uint32 wordLmIndex[wordCount]          only with VOCAB_FLAG_LM_INDEX
+ *   float  points[pointCount * 2]          x, y of every path point
+ *   char   strings[stringPoolSize]         UTF-8, not NUL terminated
+ *
+ * Features:
+ * - Open() maps the file, lookups are plain array indexing
+ * - Build() creates the same layout in memory from the legacy msgpack map
+ * - Paths are recomputed when the keyboard layout changed since the file was
+ *   written, LM indices when they do not match the loaded model
+ * - Words spelled the same under several keys share a canonical id (computed
+ *   once at load) so candidates are deduplicated without string compares
+ *
+ * No wxWidgets dependency so it can be used by the converter tool.
+ */
+class Vocabulary
+{
+public:
+    static const uint32_t NO_LM_INDEX = 0xFFFFFFFFu;
+
+    // Maps a word to its KenLM WordIndex
+    typedef std::function<uint32_t(const std::string&)> LmIndexFunction;
+
+    Vocabulary();
+
+    // Map a vocab.bin file (init_keyboard_coords() must have run)
+    bool Open(const std::string& filepath);
+
+    // Build in memory from the legacy FAISS id -> words map
+    bool Build(const std::map<int, std::vector<std::string>>& entries);
+
+    // Convert the legacy map to a vocab.bin file, with LM indices when given
+    static bool Write(const std::string& filepath,
+                      const std::map<int, std::vector<std::string>>& entries,
+                      const LmIndexFunction& lmIndex = nullptr);
+
+    void Clear();
+    bool IsLoaded() const { return m_keyWordBegin != nullptr; }
+    bool IsMapped() const { return m_file.IsOpen(); }
+
+    size_t GetKeyCount() const { return m_keyCount; }
+    size_t GetWordCount() const { return m_wordCount; }
+
+    // Word ids of a key are [GetKeyWordBegin, GetKeyWordEnd)
+    bool HasKey(int64_t key) const
+    {
+        return key >= 0 && key < static_cast<int64_t>(m_keyCount) && m_keyWordBegin[key] != m_keyWordBegin[key + 1];
+    }
+    uint32_t GetKeyWordBegin(int64_t key) const { return m_keyWordBegin[key]; }
+    uint32_t GetKeyWordEnd(int64_t key) const { return m_keyWordBegin[key + 1]; }
+
+    std::string_view GetWord(uint32_t wordId) const
+    {
+        return std::string_view(m_strings + m_wordStringBegin[wordId],
+                                m_wordStringBegin[wordId + 1] - m_wordStringBegin[wordId]);
+    }
+
+    // Keyboard path of the key's canonical word as interleaved x, y
+    const float* GetKeyPath(int64_t key, size_t& pointCount) const
+    {
+        pointCount = m_keyPathBegin[key + 1] - m_keyPathBegin[key];
+        return m_points + 2 * static_cast<size_t>(m_keyPathBegin[key]);
+    }
+
+    // First word id with the same spelling (itself for the first occurrence)
+    uint32_t GetCanonicalWord(uint32_t wordId) const { return m_wordCanonical[wordId]; }
+
+    // KenLM WordIndex of a word, NO_LM_INDEX when not bound
+    bool HasLmIndices() const { return m_wordLmIndex != nullptr; }
+    uint32_t GetLmIndex(uint32_t wordId) const { return m_wordLmIndex ? m_wordLmIndex[wordId] : NO_LM_INDEX; }
+
+    // Verify the stored indices against the model (sampled) and recompute
+    // them when they are missing or differ. Returns false if recomputed.
+    bool BindLanguageModel(const LmIndexFunction& lmIndex);
+
+private:
+    static std::vector<char> Serialize(const std::map<int, std::vector<std::string>>& entries,
+                                       const LmIndexFunction& lmIndex);
+    bool Attach(const char* data, size_t size);
+    void RebuildPaths();
+    void BuildCanonicalWords();
+
+    MappedFile m_file;
+    std::vector<char> m_ownedData;  // Build() storage, same layout as the file
+
+    // Replacements for mapped sections that had to be recomputed
+    std::vector<uint32_t> m_ownedKeyPathBegin;
+    std::vector<float> m_ownedPoints;
+    std::vector<uint32_t> m_ownedLmIndex;
+    std::vector<uint32_t> m_wordCanonical;  // Always computed at load
+
+    size_t m_keyCount;
+    size_t m_wordCount;
+    const uint32_t* m_keyWordBegin;
+    const uint32_t* m_keyPathBegin;
+    const uint32_t* m_wordStringBegin;
+    const uint32_t* m_wordLmIndex;
+    const float* m_points;
+    const char* m_strings;
+};
+
+#endif // VOCABULARY_H
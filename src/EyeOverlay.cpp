@@ -28,6 +28,7 @@ wxBEGIN_EVENT_TABLE(EyeOverlay, wxFrame)
     EVT_ERASE_BACKGROUND(EyeOverlay::OnEraseBackground)
     EVT_SIZE(EyeOverlay::OnSize)
     EVT_CLOSE(EyeOverlay::OnClose)
+    EVT_DISPLAY_CHANGED(EyeOverlay::OnDisplayChanged)
     EVT_BUTTON(ID_SPEAK, EyeOverlay::OnSpeak)
 wxEND_EVENT_TABLE()
 
@@ -43,19 +44,33 @@ EyeOverlay::EyeOverlay(GazeTracker* gazeTracker, wxWindow *parent)
     , m_espeakEngine(nullptr)
 #endif
     , m_visible(true)
+    , m_hoveredKeyboardKey(KeyGrid::NOT_FOUND)
+    , m_hoveredCandidateKey(KeyGrid::NOT_FOUND)
     , m_keyboardVisible(false)
+    , m_screenOrigin(0, 0)
     , m_gazePosition(0, 0)
     , m_lastGazeTimestamp(0)
     , m_previousTimestamp(0)
+    , m_fullDamage(true)
+    , m_backBufferGC(nullptr)
+    , m_frameScheduler(this)
+    , m_lastFrameStatsLog(0)
     , m_hasScreenshot(false)
     , m_screenshotPosition(0, 0)
     , m_screenshotSourceRect(0, 0, 0, 0)
+    , m_screenshotCaptureRect(0, 0, 0, 0)
     , m_isZoomed(false)
     , m_settingZoomFactor(3.0f)
     , m_isScrollMode(false)
     , m_isDragMode(false)
     , m_isHiddenMode(true)  // Start in hidden mode by default
-    , m_dwellProgress(0.0f)
+    , m_recordSession(false)
+    , m_swipeLabelPending(false)
+    , m_swipeLabelShown(false)
+    , m_traceExport(false)
+    , m_showTraceStats(false)
+    , m_pendingGazeArrival(0)
+    , m_lastTraceDrain(0)
     , m_lastBringToFrontTimestamp(0)
     , m_settingWaitTime(800)
     , m_settingHoldTime(800)
@@ -84,6 +99,12 @@ EyeOverlay::EyeOverlay(GazeTracker* gazeTracker, wxWindow *parent)
     m_settingsColorB = m_settings->GetColorB();
     m_settingSelectionWidth = m_settings->GetSelectionWidth();
     m_settingSelectionHeight = m_settings->GetSelectionHeight();
+
+    // Room for a whole wait time of samples at the fastest tracker rate, the
+    // ring then never grows on the gaze path
+    m_dwellDetector = DwellDetector(DwellDetector::CapacityFor(
+        static_cast<uint64_t>(m_settingWaitTime) * 1000, GazeTracker::MAX_SAMPLE_RATE_HZ));
+
     // Transparent background setup
     SetBackgroundStyle(wxBG_STYLE_PAINT);
     SetBackgroundColour(*wxBLACK);
@@ -103,8 +124,15 @@ EyeOverlay::EyeOverlay(GazeTracker* gazeTracker, wxWindow *parent)
     // Note: We'll use UpdateLayeredWindow in OnPaint instead of SetLayeredWindowAttributes
 #endif
 
+    // Zoom screenshots are taken with the overlay still on screen when the
+    // system supports excluding it from capture
+    m_screenCapture.ExcludeFromCapture(this);
+
     SetupUI();
 
+    // Repaints are coalesced by the frame scheduler and rendered on its ticks
+    Bind(wxEVT_FRAME_TICK, &EyeOverlay::OnFrameTick, this);
+
     // Connect gaze tracker callback
     m_gazeTracker->OnGazePositionUpdated = [this](float x, float y, uint64_t timestamp) {
         OnGazePositionUpdated(x, y, timestamp);
@@ -112,9 +140,49 @@ EyeOverlay::EyeOverlay(GazeTracker* gazeTracker, wxWindow *parent)
 
     // Initialize text engine
     m_textEngine = new TextInputEngine();
+
+    TextInputEngineOptions engineOptions;
+    engineOptions.intraOpThreads = m_settings->GetEncoderIntraOpThreads();
+    engineOptions.graphOptimizationLevel = m_settings->GetEncoderGraphOptimization();
+    engineOptions.cpuMemArena = m_settings->GetEncoderCpuMemArena();
+    engineOptions.dtwWindow = m_settings->GetDtwWindow();
+    engineOptions.dtwPruneTopK = m_settings->GetDtwPruneTopK();
+    engineOptions.rankingThreads = m_settings->GetRankingThreads();
+    engineOptions.faissTopK = m_settings->GetFaissTopK();
+    engineOptions.faissNprobe = m_settings->GetFaissNprobe();
+    engineOptions.faissEfSearch = m_settings->GetFaissEfSearch();
+    engineOptions.rankerBackend = m_settings->GetRankerBackend();
+    engineOptions.candidateCount = m_settings->GetCandidateCount();
+    engineOptions.executionProvider = m_settings->GetExecutionProvider();
+    engineOptions.modelPack = std::string(m_settings->GetModelPack().ToUTF8());
+    m_textEngine->SetOptions(engineOptions);
+    m_keyboard->SetSwipeProgressInterval(m_settings->GetSpeculativeInterval());
+    SwipePathFilterOptions swipeFilter;
+    swipeFilter.minCutoffHz = m_settings->GetSwipeMinCutoff();
+    swipeFilter.beta = m_settings->GetSwipeBeta();
+    swipeFilter.fixationRadius = m_settings->GetSwipeFixationRadius();
+    swipeFilter.resampleStep = m_settings->GetSwipeResampleStep();
+    m_keyboard->SetSwipeFilterOptions(swipeFilter);
+    m_recordSession = m_settings->GetRecordSession();
+    m_traceExport = m_settings->GetTraceEnabled();
+    m_showTraceStats = m_settings->GetShowTraceStats();
+    Tracer::Get().SetEnabled(m_traceExport || m_showTraceStats);
+    TRACE_THREAD_NAME("gui");
     m_textEngine->OnTextChanged = [this](const wxString& text) {
         OnTextChanged(text);
     };
+    m_textEngine->OnPredictionReady = [this](const wxString& prediction) {
+        OnPredictionReady(prediction);
+    };
+    m_textEngine->OnProvisionalPrediction = [this](const wxString& prediction) {
+        OnProvisionalPrediction(prediction);
+    };
+    m_textEngine->OnTopKPredictionsReady = [this](const std::vector<wxString>& words) {
+        OnCandidatesReady(words);
+    };
+    m_textEngine->OnInitialized = [this](bool ready) {
+        OnTextEngineInitialized(ready);
+    };
 
     // Initialize espeak engine
 #ifdef USE_ESPEAK
@@ -149,13 +217,39 @@ EyeOverlay::EyeOverlay(GazeTracker* gazeTracker, wxWindow *parent)
     wxLogMessage("ESpeakEngine disabled (USE_ESPEAK not defined)");
 #endif
 
-    // Fullscreen on current display
-    wxDisplay display(wxDisplay::GetFromPoint(wxGetMousePosition()));
-    wxRect screenRect = display.GetGeometry();
+    // Fullscreen on the display the eye tracker is mapped to
+    m_gazeTracker->SetTrackedDisplay(m_settings->GetTrackedDisplay());
+    PlaceOnTrackedDisplay();
+    m_frameScheduler.Start();
+
+    wxLogMessage("EyeOverlay initialized: %dx%d", GetSize().GetWidth(), GetSize().GetHeight());
+}
+
+void EyeOverlay::PlaceOnTrackedDisplay()
+{
+    wxRect screenRect = m_gazeTracker->GetTrackedDisplayRect();
     SetSize(screenRect);
     SetPosition(screenRect.GetPosition());
+    m_screenOrigin = screenRect.GetPosition();
+
+    // Pace frames to this display when vsync through DWM is not available
+    int displayIndex = wxDisplay::GetFromPoint(screenRect.GetPosition());
+    if (displayIndex != wxNOT_FOUND) {
+        int refresh = wxDisplay(displayIndex).GetCurrentMode().GetRefresh();
+        if (refresh > 0) {
+            m_frameScheduler.SetFallbackRate(refresh);
+        }
+    }
+}
 
-    wxLogMessage("EyeOverlay initialized: %dx%d", screenRect.GetWidth(), screenRect.GetHeight());
+void EyeOverlay::OnDisplayChanged(wxDisplayChangedEvent& event)
+{
+    event.Skip();
+
+    // Monitors were added, removed or rearranged: re-map gaze and follow the display
+    m_gazeTracker->RefreshDisplayGeometry();
+    PlaceOnTrackedDisplay();
+    Refresh(false);
 }
 
 EyeOverlay::~EyeOverlay()
@@ -178,6 +272,21 @@ EyeOverlay::~EyeOverlay()
         m_settings = nullptr;
     }
 
+    // No more frame ticks once the window starts going away
+    m_frameScheduler.Stop();
+
+    // Release the retained back buffer context before its DC goes away
+    delete m_backBufferGC;
+    m_backBufferGC = nullptr;
+    m_backBufferDC.SelectObject(wxNullBitmap);
+
+    // Joins the prediction worker before the callbacks into this window go away
+    CommitSwipeLabel();
+    if (m_textEngine) {
+        delete m_textEngine;
+        m_textEngine = nullptr;
+    }
+
     // Cleanup espeak engine
 #ifdef USE_ESPEAK
     if (m_espeakEngine) {
@@ -208,10 +317,12 @@ LRESULT CALLBACK EyeOverlay::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPAR
 
 void EyeOverlay::ShowKeyboard(bool show) {
     m_keyboardVisible = show;
+    m_sessionRecorder.RecordKeyboardVisible(show, m_lastGazeTimestamp);
 
     // Clear keyboard keys when hiding so they'll be rebuilt when shown again
     if (!show) {
         m_keyboardKeys.clear();
+        ClearCandidates();
     }
 
     Refresh();
@@ -221,24 +332,218 @@ bool EyeOverlay::IsKeyboardVisible() const {
     return m_keyboardVisible;
 }
 
+void EyeOverlay::Refresh(bool eraseBackground, const wxRect* rect)
+{
+    // Accumulate damage; no rect means the whole overlay changed
+    if (rect) {
+        m_damage.Union(*rect);
+    } else {
+        m_fullDamage = true;
+    }
+
+    // Rendering is paced by the frame scheduler (once per vblank at most)
+    if (m_frameScheduler.IsRunning()) {
+        m_frameScheduler.RequestFrame();
+    } else {
+        wxFrame::Refresh(eraseBackground, rect);
+    }
+}
+
+void EyeOverlay::RenderNow()
+{
+    // Synchronous path for callers that need the overlay updated before they
+    // continue (e.g. hiding before a screenshot or a synthetic click)
+    RenderFrame();
+}
+
+void EyeOverlay::OnFrameTick(wxThreadEvent& event)
+{
+    wxUnusedVar(event);
+
+    m_frameScheduler.BeginFrame();
+    bool rendered = RenderFrame();
+    m_frameScheduler.EndFrame(rendered);
+
+    // Trace rings are drained a few times per second (ticks keep coming while the gaze moves)
+    uint64_t now = wxGetUTCTimeUSec().GetValue();
+    if (Tracer::Get().IsEnabled() && now - m_lastTraceDrain >= 250000) {  // 250ms
+        UpdateTraceStats();
+        m_lastTraceDrain = now;
+    }
+
+    // Periodic frame pacing summary
+    if (now - m_lastFrameStatsLog >= 10000000) {  // 10s
+        FrameStats stats = m_frameScheduler.GetStats();
+        if (stats.framesRendered > 0) {
+            wxLogMessage("Overlay frames: %.1f fps avg, interval max %.1f ms, render avg %.2f ms / max %.2f ms, %llu rendered, %llu skipped, %llu coalesced",
+                         stats.GetAverageFps(), stats.maxIntervalMs, stats.averageRenderMs, stats.maxRenderMs,
+                         static_cast<unsigned long long>(stats.framesRendered),
+                         static_cast<unsigned long long>(stats.framesSkipped),
+                         static_cast<unsigned long long>(stats.requestsCoalesced));
+        }
+        m_lastFrameStatsLog = now;
+    }
+}
+
+wxRect EyeOverlay::GetCursorRect() const
+{
+    // Cursor circle (80px) plus the 5px dwell arc pen
+    const int cursorSize = 80;
+    const int margin = 4;
+    int cursorX = static_cast<int>(m_gazePosition.m_x);
+    int cursorY = static_cast<int>(m_gazePosition.m_y);
+    return wxRect(cursorX - cursorSize / 2 - margin, cursorY - cursorSize / 2 - margin,
+                  cursorSize + 2 * margin, cursorSize + 2 * margin);
+}
+
+bool EyeOverlay::CursorMoved(const wxPoint2DDouble& oldPosition) const
+{
+    // More than 5 px since the previous sample (reduces 120Hz to ~20-30Hz), or
+    // drifted that far from where the cursor was last drawn
+    const float threshold = 5.0f;
+    float dx = m_gazePosition.m_x - oldPosition.m_x;
+    float dy = m_gazePosition.m_y - oldPosition.m_y;
+    if (std::sqrt(dx * dx + dy * dy) > threshold) {
+        return true;
+    }
+    if (m_paintedCursorRect.IsEmpty()) {
+        return true;
+    }
+    wxPoint painted(m_paintedCursorRect.x + m_paintedCursorRect.width / 2,
+                    m_paintedCursorRect.y + m_paintedCursorRect.height / 2);
+    dx = m_gazePosition.m_x - painted.x;
+    dy = m_gazePosition.m_y - painted.y;
+    return std::sqrt(dx * dx + dy * dy) > threshold;
+}
+
+wxRect EyeOverlay::GetButtonRect(CircularButton* button) const
+{
+    // Circle plus the selected pen width (labels are centered inside the circle)
+    wxPoint pos = button->GetPosition();
+    wxSize size = button->GetSize();
+    wxRect rect(pos.x - size.GetWidth() / 2, pos.y - size.GetHeight() / 2, size.GetWidth(), size.GetHeight());
+    return rect.Inflate(4);
+}
+
+wxRect EyeOverlay::GetTextBoxRect() const
+{
+    // Same geometry as in DrawKeyboardWithGC
+    int textBoxWidth = 800;
+    int textBoxHeight = 80;
+    int textBoxX = (GetClientSize().GetWidth() - textBoxWidth) / 2;
+    int textBoxY = 50;
+    return wxRect(textBoxX, textBoxY, textBoxWidth, textBoxHeight).Inflate(2);
+}
+
+wxRect EyeOverlay::GetCandidateBarRect() const
+{
+    wxRect rect;
+    for (const auto& key : m_candidateKeys) {
+        rect.Union(key.bounds);
+    }
+    return rect.IsEmpty() ? rect : rect.Inflate(4);
+}
+
+wxRect EyeOverlay::GetTraceStatsRect() const
+{
+    if (!m_showTraceStats || m_traceStatsLines.empty()) {
+        return wxRect();
+    }
+
+    // Top right, the keyboard toggle is in the top-left corner
+    const int width = 470;
+    const int height = 16 + 18 * static_cast<int>(m_traceStatsLines.size());
+    return wxRect(GetClientSize().GetWidth() - width - 20, 20, width, height).Inflate(2);
+}
+
 void EyeOverlay::OnPaint(wxPaintEvent& event)
 {
     wxUnusedVar(event);
+
+    // Validate the update region, the actual output goes through UpdateLayeredWindow
+    // (the layered surface is retained by the system, only pending damage is drawn).
+    // Only system invalidations and the no-scheduler fallback get here, paced
+    // frames call RenderFrame directly.
+    wxPaintDC paintDC(this);
+    RenderFrame();
+}
+
+bool EyeOverlay::RenderFrame()
+{
     wxSize clientSize = GetClientSize();
+    if (clientSize.GetWidth() <= 0 || clientSize.GetHeight() <= 0) {
+        return false;
+    }
+
+    // Persistent 32-bit back buffer with alpha channel (only areas that changed are redrawn)
+    if (!PrepareBackBuffer(clientSize)) {
+        return false;
+    }
 
-    // Create 32-bit bitmap with alpha channel
-    wxBitmap bmp(clientSize.GetWidth(), clientSize.GetHeight(), 32);
-    bmp.UseAlpha();
+    // Nothing changed since the last frame: skip it entirely
+    if (!m_fullDamage && m_damage.IsEmpty()) {
+        return false;
+    }
 
-    wxMemoryDC mdc(bmp);
+    // The cursor moves on its own: always repaint where it was drawn and where it is now
+    wxRect clientRect(clientSize);
+    wxRegion damage(clientRect);
+    if (!m_fullDamage) {
+        m_damage.Union(m_paintedCursorRect);
+        m_damage.Union(GetCursorRect());
+        m_damage.Intersect(clientRect);
+        damage = m_damage;
+    }
+    m_damage.Clear();
+    m_fullDamage = false;
+    m_paintedCursorRect = GetCursorRect();
+
+    const wxRect dirty = damage.GetBox();
+    if (dirty.IsEmpty()) {
+        return false;
+    }
+
+    TRACE_SCOPE("paint");
 
     // Use wxGraphicsContext (GDI+) for all drawing - supports proper alpha
-    wxGraphicsContext* gc = wxGraphicsContext::Create(mdc);
-    if (!gc) return;
+    // (context, pens, brushes and fonts are kept between frames)
+    wxGraphicsContext* gc = m_backBufferGC;
+    wxColour buttonColor(m_settingsColorR, m_settingsColorG, m_settingsColorB);
+    UpdateRenderResources(buttonColor);
+    UpdateStaticPaths(gc);
+
+    // Each rectangle of the damage is redrawn on its own, so the cursor and a
+    // distant change (trace panel, candidate bar) do not repaint the span
+    // between them. A region split in many bands is drawn as its box instead.
+    size_t rectCount = 0;
+    for (wxRegionIterator it(damage); it && rectCount <= MAX_DAMAGE_RECTS; ++it) {
+        ++rectCount;
+    }
+    if (rectCount > MAX_DAMAGE_RECTS) {
+        DrawDamage(gc, dirty);
+    } else {
+        for (wxRegionIterator it(damage); it; ++it) {
+            DrawDamage(gc, it.GetRect());
+        }
+    }
+
+    // One copy to the layered window, bounded by the box of every rectangle
+    PushToScreen(dirty);
+    return true;
+}
+
+void EyeOverlay::DrawDamage(wxGraphicsContext* gc, const wxRect& dirty)
+{
+    m_paintDirtyRect = dirty;
+    wxSize clientSize = GetClientSize();
+
+    // Everything outside the dirty area keeps what was rendered previously
+    gc->ResetClip();
+    gc->Clip(dirty.x, dirty.y, dirty.width, dirty.height);
 
     // Clear to fully transparent first
     gc->SetCompositionMode(wxCOMPOSITION_CLEAR);
-    gc->DrawRectangle(0, 0, clientSize.GetWidth(), clientSize.GetHeight());
+    gc->DrawRectangle(dirty.x, dirty.y, dirty.width, dirty.height);
 
     // Set high-quality rendering for transparent backgrounds
     gc->SetCompositionMode(wxCOMPOSITION_OVER);  // Alpha blending mode
@@ -247,39 +552,14 @@ void EyeOverlay::OnPaint(wxPaintEvent& event)
 
     // Like HeyEyeControl: if not visible, just draw nothing (fully transparent)
     if (!m_visible) {
-
-        delete gc;
-        mdc.SelectObject(wxNullBitmap);
-
-#ifdef __WXMSW__
-        // Update with fully transparent bitmap
-        HWND hwnd = (HWND)GetHWND();
-        HDC hdcScreen = ::GetDC(NULL);
-        HDC hdcMem = ::CreateCompatibleDC(hdcScreen);
-        HBITMAP hBitmap = (HBITMAP)bmp.GetHBITMAP();
-        HGDIOBJ oldBitmap = ::SelectObject(hdcMem, hBitmap);
-
-        SIZE size = { clientSize.GetWidth(), clientSize.GetHeight() };
-        POINT src = { 0, 0 };
-        POINT pos = { GetPosition().x, GetPosition().y };
-
-        BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-        ::UpdateLayeredWindow(hwnd, hdcScreen, &pos, &size, hdcMem, &src, 0, &blend, ULW_ALPHA);
-
-        ::SelectObject(hdcMem, oldBitmap);
-        ::DeleteDC(hdcMem);
-        ::ReleaseDC(NULL, hdcScreen);
-#endif
         return;
     }
 
-    wxColour buttonColor(m_settingsColorR, m_settingsColorG, m_settingsColorB);
-
     // Draw semi-transparent background if buttons/keyboard are visible (provides proper background for text antialiasing)
     if (m_hasScreenshot || !m_visibleButtons.empty() || m_keyboardVisible) {
-        gc->SetBrush(wxBrush(wxColour(0, 0, 0, m_settingBackgroundOpacity)));
-        gc->SetPen(*wxTRANSPARENT_PEN);
-        gc->DrawRectangle(0, 0, clientSize.GetWidth(), clientSize.GetHeight());
+        gc->SetBrush(m_renderResources.backgroundBrush);
+        gc->SetPen(m_renderResources.transparentPen);
+        gc->DrawRectangle(dirty.x, dirty.y, dirty.width, dirty.height);
     }
 
     // Draw screenshot if available and button menu is visible (not during keyboard layer)
@@ -305,8 +585,15 @@ void EyeOverlay::OnPaint(wxPaintEvent& event)
             int crosshairX = centerX + offsetX;
             int crosshairY = centerY + offsetY;
 
-            // Create sub-bitmap from the full screenshot
-            wxBitmap subBitmap = m_screenshot.GetSubBitmap(sourceRect);
+            // Converted sub-bitmap of the captured region, rebuilt only when the source rect moves
+            if (m_screenshotGraphicsBitmap.IsNull() || m_screenshotGraphicsRect != sourceRect) {
+                wxRect captureLocal(sourceRect);
+                captureLocal.Offset(-m_screenshotCaptureRect.x, -m_screenshotCaptureRect.y);
+                captureLocal.Intersect(wxRect(m_screenshot.GetSize()));
+                m_screenshotGraphicsBitmap = gc->CreateBitmap(m_screenshot.GetSubBitmap(captureLocal));
+                m_screenshotGraphicsRect = sourceRect;
+            }
+            const wxGraphicsBitmap& subBitmap = m_screenshotGraphicsBitmap;
 
             if (m_isZoomed) {
                 // Draw zoomed (magnified) subset
@@ -323,17 +610,11 @@ void EyeOverlay::OnPaint(wxPaintEvent& event)
                 int zoomedCrosshairX = centerX + static_cast<int>(offsetX * m_settingZoomFactor);
                 int zoomedCrosshairY = centerY + static_cast<int>(offsetY * m_settingZoomFactor);
 
-                gc->SetPen(wxPen(buttonColor, 2));
-                wxGraphicsPath path = gc->CreatePath();
-                path.MoveToPoint(zoomedCrosshairX - 15, zoomedCrosshairY);
-                path.AddLineToPoint(zoomedCrosshairX - 3, zoomedCrosshairY);
-                path.MoveToPoint(zoomedCrosshairX + 3, zoomedCrosshairY);
-                path.AddLineToPoint(zoomedCrosshairX + 15, zoomedCrosshairY);
-                path.MoveToPoint(zoomedCrosshairX, zoomedCrosshairY - 15);
-                path.AddLineToPoint(zoomedCrosshairX, zoomedCrosshairY - 3);
-                path.MoveToPoint(zoomedCrosshairX, zoomedCrosshairY + 3);
-                path.AddLineToPoint(zoomedCrosshairX, zoomedCrosshairY + 15);
-                gc->StrokePath(path);
+                gc->SetPen(m_renderResources.pen2);
+                gc->PushState();
+                gc->Translate(zoomedCrosshairX, zoomedCrosshairY);
+                gc->StrokePath(m_staticPaths.crosshair);
+                gc->PopState();
             } else {
                 // Draw normal subset with crosshair
                 gc->DrawBitmap(subBitmap,
@@ -343,17 +624,11 @@ void EyeOverlay::OnPaint(wxPaintEvent& event)
                               m_settingSelectionHeight);
 
                 // Draw crosshair at adjusted position (accounts for border clamping)
-                gc->SetPen(wxPen(buttonColor, 2));
-                wxGraphicsPath path = gc->CreatePath();
-                path.MoveToPoint(crosshairX - 15, crosshairY);
-                path.AddLineToPoint(crosshairX - 3, crosshairY);
-                path.MoveToPoint(crosshairX + 3, crosshairY);
-                path.AddLineToPoint(crosshairX + 15, crosshairY);
-                path.MoveToPoint(crosshairX, crosshairY - 15);
-                path.AddLineToPoint(crosshairX, crosshairY - 3);
-                path.MoveToPoint(crosshairX, crosshairY + 3);
-                path.AddLineToPoint(crosshairX, crosshairY + 15);
-                gc->StrokePath(path);
+                gc->SetPen(m_renderResources.pen2);
+                gc->PushState();
+                gc->Translate(crosshairX, crosshairY);
+                gc->StrokePath(m_staticPaths.crosshair);
+                gc->PopState();
             }
         }
     }
@@ -361,14 +636,18 @@ void EyeOverlay::OnPaint(wxPaintEvent& event)
     // Draw visible buttons with GraphicsContext (only if keyboard not visible)
     if (!m_keyboardVisible) {
         for (auto& button : m_visibleButtons) {
-            DrawButtonWithGC(gc, button.get(), buttonColor);
+            DrawButtonWithGC(gc, button.get());
         }
     }
 
     // Draw keyboard directly on overlay (text box, buttons, and keys)
     // Use DrawKeyboardWithGC which tracks ALL keys in m_keyboardKeys (same principle as UNDO/SUBMIT)
     if (m_keyboardVisible) {
-        DrawKeyboardWithGC(gc, buttonColor);
+        DrawKeyboardWithGC(gc);
+    }
+
+    if (m_showTraceStats) {
+        DrawTraceStatsWithGC(gc);
     }
 
     // Draw gaze cursor (from HeyEyeControl eyepanel.cpp:138-147)
@@ -379,47 +658,218 @@ void EyeOverlay::OnPaint(wxPaintEvent& event)
         int cursorX = static_cast<int>(m_gazePosition.m_x);
         int cursorY = static_cast<int>(m_gazePosition.m_y);
 
-        gc->SetPen(wxPen(buttonColor, 1));
-        gc->SetBrush(*wxTRANSPARENT_BRUSH);
-        gc->DrawEllipse(cursorX - cursorSize/2, cursorY - cursorSize/2, cursorSize, cursorSize);
+        gc->SetPen(m_renderResources.pen1);
+        gc->PushState();
+        gc->Translate(cursorX, cursorY);
+        gc->StrokePath(m_staticPaths.cursor);
+        gc->PopState();
+
+        if (m_dwellProgress.Get() > 0.0f) {
+            gc->SetPen(m_renderResources.arcPen5);
+            StrokeDwellArc(gc, cursorX, cursorY, cursorSize/2, m_dwellProgress.Get());
+        }
+    }
+
+}
+
+bool EyeOverlay::PrepareBackBuffer(const wxSize& size)
+{
+    if (m_backBufferGC && m_backBuffer.IsOk() && m_backBuffer.GetSize() == size) {
+        return true;
+    }
+
+    // Size changed (or first paint): rebuild the surface and its context
+    delete m_backBufferGC;
+    m_backBufferGC = nullptr;
+    m_backBufferDC.SelectObject(wxNullBitmap);
+
+    m_backBuffer = wxBitmap(size.GetWidth(), size.GetHeight(), 32);
+    m_backBuffer.UseAlpha();
+    m_backBufferDC.SelectObject(m_backBuffer);
+
+    m_backBufferGC = wxGraphicsContext::Create(m_backBufferDC);
+    if (!m_backBufferGC) {
+        wxLogError("EyeOverlay: Failed to create graphics context for back buffer");
+        m_backBufferDC.SelectObject(wxNullBitmap);
+        return false;
+    }
+
+    // Resources are bound to the renderer, recreate them against the new context
+    m_renderResources.valid = false;
+    m_keyCapAtlas.Clear();
+    m_staticPaths.valid = false;
+    m_screenshotGraphicsBitmap = wxGraphicsBitmap();
+    m_fullDamage = true;
+    return true;
+}
+
+void EyeOverlay::UpdateStaticPaths(wxGraphicsContext* gc)
+{
+    StaticPaths& paths = m_staticPaths;
+    if (paths.valid) {
+        return;
+    }
 
-        if (m_dwellProgress > 0.0f) {
-            gc->SetPen(wxPen(buttonColor, 5));
-            wxGraphicsPath path = gc->CreatePath();
-            path.AddArc(cursorX, cursorY, cursorSize/2, 0, m_dwellProgress * 2.0 * M_PI, true);
-            gc->StrokePath(path);
+    // Same shapes as the cursor circle (80 px) and the 15 px crosshair arms
+    paths.cursor = gc->CreatePath();
+    paths.cursor.AddCircle(0, 0, 40);
+
+    paths.crosshair = gc->CreatePath();
+    paths.crosshair.MoveToPoint(-15, 0);
+    paths.crosshair.AddLineToPoint(-3, 0);
+    paths.crosshair.MoveToPoint(3, 0);
+    paths.crosshair.AddLineToPoint(15, 0);
+    paths.crosshair.MoveToPoint(0, -15);
+    paths.crosshair.AddLineToPoint(0, -3);
+    paths.crosshair.MoveToPoint(0, 3);
+    paths.crosshair.AddLineToPoint(0, 15);
+
+    // Layout dependent paths are rebuilt on their next draw
+    paths.textBoxRect = wxRect();
+    paths.traceStatsRect = wxRect();
+    paths.dwellArcs.clear();
+    paths.swipeTrail = wxGraphicsPath();
+    paths.swipeTrailPoints = 0;
+    paths.valid = true;
+}
+
+void EyeOverlay::StrokeDwellArc(wxGraphicsContext* gc, int centerX, int centerY, int radius, float progress)
+{
+    // Arcs are kept per radius and progress step: a dwell only ever shows a
+    // few radii (cursor, buttons, key sizes), so after the first dwell on each
+    // nothing is built per frame
+    int step = static_cast<int>(progress * DWELL_ARC_STEPS + 0.5f);
+    step = std::max(1, std::min(DWELL_ARC_STEPS, step));
+
+    DwellArcs* arcs = nullptr;
+    for (DwellArcs& entry : m_staticPaths.dwellArcs) {
+        if (entry.radius == radius) {
+            arcs = &entry;
+            break;
         }
     }
+    if (!arcs) {
+        m_staticPaths.dwellArcs.push_back(DwellArcs());
+        arcs = &m_staticPaths.dwellArcs.back();
+        arcs->radius = radius;
+        arcs->steps.resize(DWELL_ARC_STEPS + 1);
+    }
+
+    wxGraphicsPath& path = arcs->steps[step];
+    if (path.IsNull()) {
+        path = gc->CreatePath();
+        path.AddArc(0, 0, radius, 0, step * 2.0 * M_PI / DWELL_ARC_STEPS, true);
+    }
 
-    delete gc;
-    mdc.SelectObject(wxNullBitmap);
+    // Integer offsets, translating back restores the transform exactly
+    gc->Translate(centerX, centerY);
+    gc->StrokePath(path);
+    gc->Translate(-centerX, -centerY);
+}
+
+void EyeOverlay::DrawLabelCap(wxGraphicsContext* gc, size_t slot, const wxString& label, const wxRect& bounds,
+                              KeyCapAtlas::LabelCapStyle style)
+{
+    const wxGraphicsBitmap& cap = m_keyCapAtlas.GetLabelCap(gc, slot, label, bounds.width, bounds.height, style);
+    if (!cap.IsNull()) {
+        gc->DrawBitmap(cap, bounds.x - KeyCapAtlas::MARGIN, bounds.y - KeyCapAtlas::MARGIN,
+                       bounds.width + 2 * KeyCapAtlas::MARGIN, bounds.height + 2 * KeyCapAtlas::MARGIN);
+    }
+}
+
+const EyeOverlay::TextExtent& EyeOverlay::MeasureText(wxGraphicsContext* gc, TextExtent& cache, const wxString& text)
+{
+    // Measured with the font currently set on gc, again only when the text changes
+    if (!cache.valid || cache.text != text) {
+        cache.text = text;
+        gc->GetTextExtent(text, &cache.width, &cache.height);
+        cache.valid = true;
+    }
+    return cache;
+}
+
+void EyeOverlay::UpdateRenderResources(const wxColour& color)
+{
+    RenderResources& res = m_renderResources;
+    if (res.valid && res.color == color && res.backgroundOpacity == m_settingBackgroundOpacity) {
+        return;
+    }
+
+    wxGraphicsContext* gc = m_backBufferGC;
+    res.color = color;
+    res.backgroundOpacity = m_settingBackgroundOpacity;
+
+    res.pen1 = gc->CreatePen(wxPen(color, 1));
+    res.pen2 = gc->CreatePen(wxPen(color, 2));
+    res.pen3 = gc->CreatePen(wxPen(color, 3));
+    res.arcPen5 = gc->CreatePen(wxPen(color, 5));
+    res.arcPen6 = gc->CreatePen(wxPen(color, 6));
+    res.trailPen = gc->CreatePen(wxPen(wxColour(color.Red(), color.Green(), color.Blue(), 180), 3));
+    res.transparentPen = gc->CreatePen(*wxTRANSPARENT_PEN);
+
+    res.backgroundBrush = gc->CreateBrush(wxBrush(wxColour(0, 0, 0, m_settingBackgroundOpacity)));
+    res.textBoxBrush = gc->CreateBrush(wxBrush(wxColour(255, 255, 255, 230)));  // Semi-transparent white
+    res.transparentBrush = gc->CreateBrush(*wxTRANSPARENT_BRUSH);
+
+    res.textFont = gc->CreateFont(wxFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL), wxColour(0, 0, 0));
+    res.provisionalFont = gc->CreateFont(wxFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_ITALIC, wxFONTWEIGHT_NORMAL), wxColour(140, 140, 140));
+    res.statsFont = gc->CreateFont(wxFont(10, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL), wxColour(0, 0, 0));
+
+    m_keyCapAtlas.SetColor(color);
+    m_textBoxExtent.valid = false;
+    res.valid = true;
+}
+
+void EyeOverlay::PushToScreen(const wxRect& dirty)
+{
+    wxSize clientSize = m_backBuffer.GetSize();
 
 #ifdef __WXMSW__
-    // Use UpdateLayeredWindow for per-pixel alpha transparency
+    // Use UpdateLayeredWindow for per-pixel alpha transparency, only the dirty
+    // rectangle is copied (the rest of the layered surface is kept by the system).
+    // The back buffer stays selected in m_backBufferDC, GDI+ must be flushed first.
+    m_backBufferGC->Flush();
+
     HWND hwnd = (HWND)GetHWND();
-    HDC hdcScreen = ::GetDC(NULL);
-    HDC hdcMem = ::CreateCompatibleDC(hdcScreen);
-    HBITMAP hBitmap = (HBITMAP)bmp.GetHBITMAP();
-    HGDIOBJ oldBitmap = ::SelectObject(hdcMem, hBitmap);
+    HDC hdcMem = (HDC)m_backBufferDC.GetHDC();
 
     SIZE size = { clientSize.GetWidth(), clientSize.GetHeight() };
     POINT src = { 0, 0 };
     POINT pos = { GetPosition().x, GetPosition().y };
+    RECT dirtyRect = { dirty.GetLeft(), dirty.GetTop(), dirty.GetRight() + 1, dirty.GetBottom() + 1 };
 
     BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-    ::UpdateLayeredWindow(hwnd, hdcScreen, &pos, &size, hdcMem, &src, 0, &blend, ULW_ALPHA);
 
-    ::SelectObject(hdcMem, oldBitmap);
-    ::DeleteDC(hdcMem);
-    ::ReleaseDC(NULL, hdcScreen);
+    UPDATELAYEREDWINDOWINFO info;
+    ZeroMemory(&info, sizeof(info));
+    info.cbSize = sizeof(info);
+    info.hdcDst = NULL;  // Default palette, no need for a screen DC
+    info.pptDst = &pos;
+    info.psize = &size;
+    info.hdcSrc = hdcMem;
+    info.pptSrc = &src;
+    info.pblend = &blend;
+    info.dwFlags = ULW_ALPHA;
+    info.prcDirty = &dirtyRect;
+
+    if (!::UpdateLayeredWindowIndirect(hwnd, &info)) {
+        // Dirty rect rejected (e.g. first update after a resize): push everything
+        ::UpdateLayeredWindow(hwnd, NULL, &pos, &size, hdcMem, &src, 0, &blend, ULW_ALPHA);
+    }
 #else
+    m_backBufferGC->Flush();
     wxClientDC dc(this);
-    dc.DrawBitmap(bmp, 0, 0, true);
+    dc.Blit(dirty.x, dirty.y, dirty.width, dirty.height, &m_backBufferDC, dirty.x, dirty.y);
+    wxUnusedVar(clientSize);
 #endif
+
+    // Gaze arrival to the frame that shows it
+    TRACE_INTERVAL("gaze to screen", m_pendingGazeArrival);
+    m_pendingGazeArrival = 0;
 }
 
 // Helper function to draw buttons using GraphicsContext
-void EyeOverlay::DrawButtonWithGC(wxGraphicsContext* gc, CircularButton* button, const wxColour& color)
+void EyeOverlay::DrawButtonWithGC(wxGraphicsContext* gc, CircularButton* button)
 {
     if (!gc || !button) return;
 
@@ -428,36 +878,25 @@ void EyeOverlay::DrawButtonWithGC(wxGraphicsContext* gc, CircularButton* button,
     float progress = button->GetProgress();
     bool isSelected = button->IsSelected();
 
-    // Draw text with GDI+ (handles transparent background correctly)
-    // Antialiasing and quality settings are set globally in OnPaint
-    wxFont font(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-    gc->SetFont(font, color);
-
-    wxString label = button->GetLabel();
-    double textWidth, textHeight;
-    gc->GetTextExtent(label, &textWidth, &textHeight);
-
-    // Draw text - GDI+ will handle antialiasing correctly on transparent background
-    gc->DrawText(label, pos.x - textWidth/2, pos.y - textHeight/2);
-
-    // Draw circle
-    int penWidth = isSelected ? 3 : 1;
-    gc->SetPen(wxPen(color, penWidth));
-    gc->SetBrush(*wxTRANSPARENT_BRUSH);
-    gc->DrawEllipse(pos.x - size.GetWidth()/2, pos.y - size.GetHeight()/2, size.GetWidth(), size.GetHeight());
+    // Label and circle come pre-rendered from the atlas (one slot per menu position)
+    size_t slot = LABEL_SLOTS_MENU;
+    for (size_t i = 0; i < m_visibleButtons.size() && m_visibleButtons[i].get() != button; ++i) {
+        ++slot;
+    }
+    wxRect bounds(pos.x - size.GetWidth()/2, pos.y - size.GetHeight()/2, size.GetWidth(), size.GetHeight());
+    DrawLabelCap(gc, slot, button->GetLabel(), bounds,
+                 isSelected ? KeyCapAtlas::LabelCapCircleSelected : KeyCapAtlas::LabelCapCircle);
 
     // Draw progress arc
     if (progress > 0.0f) {
-        gc->SetPen(wxPen(color, 6));
-        wxGraphicsPath path = gc->CreatePath();
+        gc->SetPen(m_renderResources.arcPen6);
         int reduce = 4;
-        path.AddArc(pos.x, pos.y, size.GetWidth()/2 - reduce, 0, progress * 2.0 * M_PI, true);
-        gc->StrokePath(path);
+        StrokeDwellArc(gc, pos.x, pos.y, size.GetWidth()/2 - reduce, progress);
     }
 }
 
 // Helper function to draw keyboard using GraphicsContext (AZERTY layout from KeyboardView)
-void EyeOverlay::DrawKeyboardWithGC(wxGraphicsContext* gc, const wxColour& color)
+void EyeOverlay::DrawKeyboardWithGC(wxGraphicsContext* gc)
 {
     if (!gc || !m_keyboard) return;
 
@@ -469,27 +908,38 @@ void EyeOverlay::DrawKeyboardWithGC(wxGraphicsContext* gc, const wxColour& color
     int textBoxX = (clientSize.GetWidth() - textBoxWidth) / 2;
     int textBoxY = 50;  // Position at top center
 
-    // Draw white background box
-    gc->SetBrush(wxBrush(wxColour(255, 255, 255, 230)));  // Semi-transparent white
-    gc->SetPen(wxPen(color, 2));
-    gc->DrawRoundedRectangle(textBoxX, textBoxY, textBoxWidth, textBoxHeight, 10);
+    // Draw white background box (outline rebuilt only when the overlay is resized)
+    wxRect textBoxRect(textBoxX, textBoxY, textBoxWidth, textBoxHeight);
+    if (m_staticPaths.textBoxRect != textBoxRect) {
+        m_staticPaths.textBox = gc->CreatePath();
+        m_staticPaths.textBox.AddRoundedRectangle(textBoxX, textBoxY, textBoxWidth, textBoxHeight, 10);
+        m_staticPaths.textBoxRect = textBoxRect;
+    }
+    gc->SetBrush(m_renderResources.textBoxBrush);  // Semi-transparent white
+    gc->SetPen(m_renderResources.pen2);
+    gc->DrawPath(m_staticPaths.textBox);
 
-    // Draw the current text inside the box
+    // Draw the current text inside the box (measured again only when it changes)
     if (m_textEngine) {
-        wxString currentText = m_textEngine->GetCurrentText();
-        if (currentText.IsEmpty()) {
-            currentText = wxT("Type here...");  // Placeholder text
-        }
+        static const wxString placeholder(wxT("Type here..."));
+        const wxString& engineText = m_textEngine->GetCurrentText();
+        const wxString& currentText = (engineText.IsEmpty() && m_provisionalWord.IsEmpty()) ? placeholder : engineText;
 
-        wxFont textFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-        gc->SetFont(textFont, wxColour(0, 0, 0));  // Black text
+        gc->SetFont(m_renderResources.textFont);  // Black text
 
-        double textWidth, textHeight;
-        gc->GetTextExtent(currentText, &textWidth, &textHeight);
+        const TextExtent& extent = MeasureText(gc, m_textBoxExtent, currentText.IsEmpty() ? m_provisionalWord : currentText);
+        double textHeight = extent.height;
 
         // Center text vertically, align left with some padding
         int textPadding = 20;
         gc->DrawText(currentText, textBoxX + textPadding, textBoxY + (textBoxHeight - textHeight) / 2);
+
+        // Word of the swipe in progress, greyed after the text
+        if (!m_provisionalWord.IsEmpty()) {
+            double currentWidth = currentText.IsEmpty() ? 0.0 : extent.width;
+            gc->SetFont(m_renderResources.provisionalFont);
+            gc->DrawText(m_provisionalWord, textBoxX + textPadding + currentWidth, textBoxY + (textBoxHeight - textHeight) / 2);
+        }
     }
 
     // Calculate keyboard position on overlay
@@ -508,44 +958,22 @@ void EyeOverlay::DrawKeyboardWithGC(wxGraphicsContext* gc, const wxColour& color
     int controlX = (clientSize.GetWidth() - totalControlWidth) / 2;
     int controlY = textBoxY + textBoxHeight + 30;  // 30px below edit box
 
-    // Get all keys from KeyboardView with their current state
-    std::vector<KeyRenderInfo> keys = m_keyboard->GetKeysForRendering();
-
-    // Draw control buttons first (SWIPE, <-, <--) between edit box and keyboard
-    wxFont controlFont(16, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-
-    for (const auto& keyInfo : keys) {
-        wxString label;
-        if (keyInfo.keyType != KeyType::Character) {
-            label = keyInfo.primaryLabel;
-        }
-
-        // Skip control buttons - they're drawn from m_keyboardKeys instead
-        if (label == wxT("Swipe") || label == wxT("<-") || label == wxT("<--")) {
-            continue;
-        }
-
-    }
+    // Get all keys from KeyboardView with their current state (vector reused between frames)
+    m_keyboard->GetKeysForRendering(m_keyRenderInfo);
 
     // Draw all keyboard keys (translated to overlay coordinates)
-    // Active character: larger and bold (the one that will be typed)
-    wxFont activeFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-    // Inactive characters: smaller and normal weight
-    wxFont inactiveFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
-    // Dimmed color for inactive characters
-    wxColour inactiveColor(color.Red(), color.Green(), color.Blue(), 150);
-
-    for (const auto& keyInfo : keys) {
-        // Get label to check if this is a control button
-        wxString label;
-        if (keyInfo.keyType != KeyType::Character) {
-            label = keyInfo.primaryLabel;
-        }
-
-        // Skip control buttons (already drawn above)
-        if (label == wxT("Swipe") || label == wxT("<-") || label == wxT("<--")) {
+    // Static part (outline, background, labels) comes pre-rendered from the key cap atlas,
+    // only the dwell progress arc is drawn per frame
+    wxRect clip = m_paintDirtyRect;
+    for (size_t i = 0; i < m_keyRenderInfo.size(); ++i) {
+        const KeyRenderInfo& keyInfo = m_keyRenderInfo[i];
+
+        // Control buttons (SWIPE, <-, <--) are drawn from m_keyboardKeys instead
+        if (keyInfo.keyType != KeyType::Character &&
+            (keyInfo.primaryLabel == wxT("Swipe") || keyInfo.primaryLabel == wxT("<-") || keyInfo.primaryLabel == wxT("<--"))) {
             continue;
         }
+
         // Translate KeyboardView coordinates to overlay coordinates
         wxRect2DDouble keyGeom = keyInfo.geometry;
         int keyX = keyboardX + static_cast<int>(keyGeom.m_x);
@@ -553,93 +981,30 @@ void EyeOverlay::DrawKeyboardWithGC(wxGraphicsContext* gc, const wxColour& color
         int keyW = static_cast<int>(keyGeom.m_width);
         int keyH = static_cast<int>(keyGeom.m_height);
 
-        int centerX = keyX + keyW / 2;
-        int centerY = keyY + keyH / 2;
-
-        // Draw key background (with modifier highlighting)
-        if (keyInfo.isModifierActive) {
-            // Active modifier keys get a filled background
-            gc->SetBrush(wxBrush(wxColour(color.Red(), color.Green(), color.Blue(), 100)));
-        } else if (keyInfo.isHovered) {
-            // Hovered keys get a lighter background
-            gc->SetBrush(wxBrush(wxColour(color.Red(), color.Green(), color.Blue(), 50)));
-        } else {
-            gc->SetBrush(*wxTRANSPARENT_BRUSH);
+        // Keys outside the repainted area are left as they are in the back buffer
+        if (!clip.Intersects(wxRect(keyX, keyY, keyW, keyH).Inflate(KeyCapAtlas::MARGIN))) {
+            continue;
         }
 
-        // Draw key rectangle
-        gc->SetPen(wxPen(color, 2));
-        gc->DrawRoundedRectangle(keyX, keyY, keyW, keyH, 5);
-
-        // Draw multi-layer character labels for character keys
-        if (keyInfo.keyType == KeyType::Character) {
-            const int padding = 4;  // Padding from key edges
-
-            // Draw shift character (top-left)
-            if (!keyInfo.shiftLabel.IsEmpty()) {
-                bool isActive = (keyInfo.activeLayer == KeyRenderInfo::Shift);
-                gc->SetFont(isActive ? activeFont : inactiveFont, isActive ? color : inactiveColor);
-                double textWidth, textHeight;
-                gc->GetTextExtent(keyInfo.shiftLabel, &textWidth, &textHeight);
-
-                if (isActive) {
-                    // If shift is active, draw it larger and centered
-                    gc->DrawText(keyInfo.shiftLabel, centerX - textWidth/2, centerY - textHeight/2);
-                } else {
-                    // Draw in corner
-                    gc->DrawText(keyInfo.shiftLabel, keyX + padding, keyY + padding);
-                }
-            }
-
-            // Draw AltGr character (top-right)
-            if (!keyInfo.altgrLabel.IsEmpty()) {
-                bool isActive = (keyInfo.activeLayer == KeyRenderInfo::AltGr);
-                gc->SetFont(isActive ? activeFont : inactiveFont, isActive ? color : inactiveColor);
-                double textWidth, textHeight;
-                gc->GetTextExtent(keyInfo.altgrLabel, &textWidth, &textHeight);
-
-                if (isActive) {
-                    // If AltGr is active, draw it larger and centered
-                    gc->DrawText(keyInfo.altgrLabel, centerX - textWidth/2, centerY - textHeight/2);
-                } else {
-                    // Draw in corner
-                    gc->DrawText(keyInfo.altgrLabel, keyX + keyW - textWidth - padding, keyY + padding);
-                }
-            }
-
-            // Draw primary character (center)
-            if (!keyInfo.primaryLabel.IsEmpty()) {
-                bool isActive = (keyInfo.activeLayer == KeyRenderInfo::Primary);
-                gc->SetFont(isActive ? activeFont : inactiveFont, isActive ? color : inactiveColor);
-                double textWidth, textHeight;
-                gc->GetTextExtent(keyInfo.primaryLabel, &textWidth, &textHeight);
-
-                if (isActive) {
-                    // Draw centered and large
-                    gc->DrawText(keyInfo.primaryLabel, centerX - textWidth/2, centerY - textHeight/2);
-                } else {
-                    // Draw at bottom when not active
-                    gc->DrawText(keyInfo.primaryLabel, centerX - textWidth/2, keyY + keyH - textHeight - padding);
-                }
-            }
-        } else {
-            // For modifier keys, just draw the primary label centered
-            gc->SetFont(activeFont, color);
-            double textWidth, textHeight;
-            gc->GetTextExtent(keyInfo.primaryLabel, &textWidth, &textHeight);
-            gc->DrawText(keyInfo.primaryLabel, centerX - textWidth/2, centerY - textHeight/2);
+        const wxGraphicsBitmap& cap = m_keyCapAtlas.GetKeyCap(gc, i, keyInfo, keyW, keyH);
+        if (!cap.IsNull()) {
+            gc->DrawBitmap(cap, keyX - KeyCapAtlas::MARGIN, keyY - KeyCapAtlas::MARGIN,
+                           keyW + 2 * KeyCapAtlas::MARGIN, keyH + 2 * KeyCapAtlas::MARGIN);
         }
 
         // Draw progress arc if key has dwell progress
         if (keyInfo.progress > 0.0f) {
-            gc->SetPen(wxPen(color, 6));
-            wxGraphicsPath path = gc->CreatePath();
+            int centerX = keyX + keyW / 2;
+            int centerY = keyY + keyH / 2;
+            gc->SetPen(m_renderResources.arcPen6);
             int radius = std::min(keyW, keyH) / 2 - 5;
-            path.AddArc(centerX, centerY, radius, 0, keyInfo.progress * 2.0 * M_PI, true);
-            gc->StrokePath(path);
+            StrokeDwellArc(gc, centerX, centerY, radius, keyInfo.progress);
         }
     }
 
+    // Draw the swipe trail on top of the keys while recording
+    DrawSwipeTrailWithGC(gc, keyboardX, keyboardY);
+
     // Build workflow buttons only once when keyboard is first shown
     // These are separate from the keyboard keys and positioned independently
     if (m_keyboardKeys.empty()) {
@@ -677,44 +1042,80 @@ void EyeOverlay::DrawKeyboardWithGC(wxGraphicsContext* gc, const wxColour& color
         m_keyboardKeys.push_back(KeyboardKey(wxT("SWIPE"), wxRect(controlX, controlY, controlButtonWidth, controlButtonHeight)));
         m_keyboardKeys.push_back(KeyboardKey(wxT("<-"), wxRect(controlX + controlButtonWidth + controlButtonSpacing, controlY, controlButtonWidth, controlButtonHeight)));
         m_keyboardKeys.push_back(KeyboardKey(wxT("<--"), wxRect(controlX + 2 * (controlButtonWidth + controlButtonSpacing), controlY, controlButtonWidth, controlButtonHeight)));
-    }
 
-    // Draw workflow buttons (UNDO, SUBMIT, SUBMIT_RETURN, MENU)
-    wxFont workflowFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
-    gc->SetFont(workflowFont, color);
+        BuildKeyGrid(m_keyboardKeys, m_keyboardKeyGrid);
+        m_hoveredKeyboardKey = KeyGrid::NOT_FOUND;
+    }
 
-    for (const auto& key : m_keyboardKeys) {
+    // Draw workflow buttons (UNDO, SUBMIT, SUBMIT_RETURN, MENU), outline and
+    // label pre-rendered, only the dwell arc is drawn per frame
+    for (size_t index = 0; index < m_keyboardKeys.size(); ++index) {
+        const KeyboardKey& key = m_keyboardKeys[index];
         wxRect bounds = key.bounds;
-        int centerX = bounds.x + bounds.width / 2;
-        int centerY = bounds.y + bounds.height / 2;
-
-        // Draw key rectangle with background
-        gc->SetPen(wxPen(color, 2));
+        if (!clip.Intersects(wxRect(bounds).Inflate(KeyCapAtlas::MARGIN))) {
+            continue;
+        }
 
         // SWIPE button: show selected state when swipe mode is enabled
-        if (key.label == wxT("SWIPE") && m_keyboard && m_keyboard->IsSwipeEnabled()) {
-            // Filled background when swipe mode is active
-            gc->SetBrush(wxBrush(wxColour(color.Red(), color.Green(), color.Blue(), 100)));
-        } else {
-            gc->SetBrush(*wxTRANSPARENT_BRUSH);
+        bool active = key.label == wxT("SWIPE") && m_keyboard && m_keyboard->IsSwipeEnabled();
+        DrawLabelCap(gc, LABEL_SLOTS_WORKFLOW + index, key.label, bounds,
+                     active ? KeyCapAtlas::LabelCapButtonActive : KeyCapAtlas::LabelCapButton);
+
+        // Draw progress arc if key has dwell progress
+        if (key.dwell.Get() > 0.0f) {
+            gc->SetPen(m_renderResources.arcPen6);
+            int radius = std::min(bounds.width, bounds.height) / 2 - 5;
+            StrokeDwellArc(gc, bounds.x + bounds.width / 2, bounds.y + bounds.height / 2, radius, key.dwell.Get());
         }
+    }
 
-        gc->DrawRoundedRectangle(bounds.x, bounds.y, bounds.width, bounds.height, 10);
+    // Draw candidate bar (alternates of the last swipe)
+    for (size_t index = 0; index < m_candidateKeys.size(); ++index) {
+        const KeyboardKey& key = m_candidateKeys[index];
+        wxRect bounds = key.bounds;
+        if (!clip.Intersects(wxRect(bounds).Inflate(KeyCapAtlas::MARGIN))) {
+            continue;
+        }
 
-        // Draw key label
-        double textWidth, textHeight;
-        gc->GetTextExtent(key.label, &textWidth, &textHeight);
-        gc->DrawText(key.label, centerX - textWidth/2, centerY - textHeight/2);
+        DrawLabelCap(gc, LABEL_SLOTS_CANDIDATES + index, key.label, bounds, KeyCapAtlas::LabelCapButton);
 
-        // Draw progress arc if key has dwell progress
-        if (key.dwellProgress > 0.0f) {
-            gc->SetPen(wxPen(color, 6));
-            wxGraphicsPath path = gc->CreatePath();
+        if (key.dwell.Get() > 0.0f) {
+            gc->SetPen(m_renderResources.arcPen6);
             int radius = std::min(bounds.width, bounds.height) / 2 - 5;
-            path.AddArc(centerX, centerY, radius, 0, key.dwellProgress * 2.0 * M_PI, true);
-            gc->StrokePath(path);
+            StrokeDwellArc(gc, bounds.x + bounds.width / 2, bounds.y + bounds.height / 2, radius, key.dwell.Get());
+        }
+    }
+}
+
+void EyeOverlay::DrawSwipeTrailWithGC(wxGraphicsContext* gc, int keyboardX, int keyboardY)
+{
+    const std::vector<std::pair<float, float>>& swipePath = m_keyboard->GetSwipePath();
+    if (swipePath.size() < 2) return;
+
+    // The swipe path only grows while recording: the kept trail is extended
+    // with the new points, and built again for a new swipe or keyboard position
+    StaticPaths& paths = m_staticPaths;
+    const wxPoint origin(keyboardX, keyboardY);
+    if (paths.swipeTrail.IsNull() || swipePath.size() < paths.swipeTrailPoints ||
+        swipePath.front() != paths.swipeTrailStart || paths.swipeTrailOrigin != origin) {
+        paths.swipeTrail = gc->CreatePath();
+        paths.swipeTrailPoints = 0;
+        paths.swipeTrailStart = swipePath.front();
+        paths.swipeTrailOrigin = origin;
+    }
+    for (size_t i = paths.swipeTrailPoints; i < swipePath.size(); ++i) {
+        wxPoint2DDouble point = m_keyboard->SwipePointToLocal(swipePath[i]);
+        if (i == 0) {
+            paths.swipeTrail.MoveToPoint(keyboardX + point.m_x, keyboardY + point.m_y);
+        } else {
+            paths.swipeTrail.AddLineToPoint(keyboardX + point.m_x, keyboardY + point.m_y);
         }
     }
+    paths.swipeTrailPoints = swipePath.size();
+
+    gc->SetPen(m_renderResources.trailPen);
+    gc->SetBrush(m_renderResources.transparentBrush);
+    gc->StrokePath(paths.swipeTrail);
 }
 
 void EyeOverlay::HandleKeyActivation(const wxString& keyLabel)
@@ -782,6 +1183,13 @@ void EyeOverlay::OnClose(wxCloseEvent& event)
         m_gazeTracker->StopTracking();
     }
 
+    // Stop frame ticks, nothing will be drawn anymore
+    m_frameScheduler.Stop();
+
+    if (m_traceExport) {
+        ExportTrace();
+    }
+
     // Clear all buttons and resources
     ClearAllButtons();
 
@@ -791,10 +1199,28 @@ void EyeOverlay::OnClose(wxCloseEvent& event)
 
 void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
 {
+    TRACE_SCOPE("gaze update");
+    const bool latchedArrival = m_pendingGazeArrival == 0;
+    if (latchedArrival) {
+        m_pendingGazeArrival = m_gazeTracker->GetCurrentSampleArrival();
+    }
+
+    // Gaze arrives in virtual-desktop coordinates, everything below works in
+    // overlay client coordinates (the overlay covers the tracked display)
+    x -= m_screenOrigin.x;
+    y -= m_screenOrigin.y;
+
     wxPoint2DDouble oldPosition = m_gazePosition;
     m_gazePosition = wxPoint2DDouble(x, y);
     m_lastGazeTimestamp = timestamp;
 
+    if (m_recordSession) {
+        if (!m_sessionRecorder.IsOpen()) {
+            StartSessionRecording();
+        }
+        m_sessionRecorder.RecordGaze(x, y, timestamp);
+    }
+
     // Calculate delta time
     float deltaTime = 0.0f;
     if (m_previousTimestamp > 0) {
@@ -804,9 +1230,7 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
 
     // Forward gaze position to KeyboardView when keyboard is visible
     if (m_keyboardVisible && m_keyboard) {
-        // Convert screen coordinates to overlay coordinates
-        wxPoint screenPos(static_cast<int>(x), static_cast<int>(y));
-        wxPoint overlayPos = ScreenToClient(screenPos);
+        wxPoint overlayPos(static_cast<int>(x), static_cast<int>(y));
 
         // Calculate where keyboard is rendered on overlay (same calculation as in DrawKeyboardWithGC)
         wxSize clientSize = GetClientSize();
@@ -841,40 +1265,75 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
 
             // Pass keyboard-local coordinates to KeyboardView
             // KeyboardView handles all dwell tracking and activation for keyboard keys internally
-            m_keyboard->UpdateGazePosition(keyboardLocalX, keyboardLocalY);
+            m_keyboard->UpdateGazePosition(keyboardLocalX, keyboardLocalY, timestamp);
         }
 
         // Track dwelling on workflow buttons (UNDO, SUBMIT, SUBMIT_RETURN) only
-        // These are separate from the keyboard keys and managed in the overlay
-        bool needsRefresh = false;
-
-        for (auto& key : m_keyboardKeys) {
-            if (key.bounds.Contains(overlayPos)) {
-                // Update progress
-                float oldProgress = key.dwellProgress;
-                key.dwellProgress += deltaTime / (m_settingHoldTime * 1000.0f);
-
-                if (key.dwellProgress >= 1.0f) {
-                    // Workflow button activated!
-                    key.dwellProgress = 0.0f;
-                    HandleKeyActivation(key.label);
-                    needsRefresh = true;
-                } else if (static_cast<int>(key.dwellProgress * 20) != static_cast<int>(oldProgress * 20)) {
-                    needsRefresh = true;
-                }
-            } else {
-                // Reset progress if not hovering
-                if (key.dwellProgress > 0.0f) {
-                    key.dwellProgress = 0.0f;
-                    needsRefresh = true;
-                }
+        // These are separate from the keyboard keys and managed in the overlay.
+        // Only the hovered button advances, so only the previous one needs a reset.
+        int hoveredKey = m_keyboardKeyGrid.Find(static_cast<float>(overlayPos.x), static_cast<float>(overlayPos.y));
+        if (hoveredKey >= static_cast<int>(m_keyboardKeys.size())) {
+            hoveredKey = KeyGrid::NOT_FOUND;  // Keys cleared since the grid was built
+        }
+        if (m_hoveredKeyboardKey != hoveredKey && m_hoveredKeyboardKey >= 0 &&
+            m_hoveredKeyboardKey < static_cast<int>(m_keyboardKeys.size())) {
+            KeyboardKey& previous = m_keyboardKeys[m_hoveredKeyboardKey];
+            if (previous.dwell.Reset()) {
+                RefreshRect(wxRect(previous.bounds).Inflate(4), false);
+            }
+        }
+        m_hoveredKeyboardKey = hoveredKey;
+        if (hoveredKey != KeyGrid::NOT_FOUND) {
+            KeyboardKey& key = m_keyboardKeys[hoveredKey];
+            if (key.dwell.Advance(deltaTime, m_settingHoldTime * 1000.0f)) {
+                RefreshRect(wxRect(key.bounds).Inflate(4), false);
+            }
+
+            if (key.dwell.IsComplete()) {
+                // Workflow button activated! (UNDO/MENU/SUBMIT clear m_keyboardKeys)
+                key.dwell.Reset();
+                wxString label = key.label;
+                wxRect bounds = key.bounds;
+                m_hoveredKeyboardKey = KeyGrid::NOT_FOUND;
+                HandleKeyActivation(label);
+                RefreshRect(bounds.Inflate(4), false);
+            }
+        }
+
+        // Candidate bar, selecting one rebuilds m_candidateKeys
+        int hoveredCandidate = m_candidateKeyGrid.Find(static_cast<float>(overlayPos.x), static_cast<float>(overlayPos.y));
+        if (m_hoveredCandidateKey != hoveredCandidate && m_hoveredCandidateKey >= 0 &&
+            m_hoveredCandidateKey < static_cast<int>(m_candidateKeys.size())) {
+            KeyboardKey& previous = m_candidateKeys[m_hoveredCandidateKey];
+            if (previous.dwell.Reset()) {
+                RefreshRect(wxRect(previous.bounds).Inflate(4), false);
+            }
+        }
+        m_hoveredCandidateKey = hoveredCandidate;
+        if (hoveredCandidate != KeyGrid::NOT_FOUND && hoveredCandidate < static_cast<int>(m_candidateKeys.size())) {
+            KeyboardKey& key = m_candidateKeys[hoveredCandidate];
+            if (key.dwell.Advance(deltaTime, m_settingHoldTime * 1000.0f)) {
+                RefreshRect(wxRect(key.bounds).Inflate(4), false);
+            }
+            if (key.dwell.IsComplete()) {
+                SelectCandidate(static_cast<size_t>(hoveredCandidate));
             }
         }
 
-        // Always refresh overlay when keyboard is visible to show:
-        // 1. KeyboardView's internal state changes (dwell progress on keys)
-        // 2. Workflow button progress
-        Refresh(false);
+        // Repaint only what changed:
+        // 1. KeyboardView's internal state changes (hover, dwell progress, swipe trail)
+        // 2. Workflow button progress (above)
+        // 3. The gaze cursor, once it moved (a fixation renders no frame)
+        wxRect keyboardDamage;
+        if (m_keyboard->TakeDamage(keyboardDamage)) {
+            keyboardDamage.Offset(keyboardX, keyboardY);
+            RefreshRect(keyboardDamage, false);
+        }
+        if (CursorMoved(oldPosition)) {
+            RefreshRect(GetCursorRect(), false);
+        } else if (latchedArrival && !m_fullDamage && m_damage.IsEmpty()) {
+            m_pendingGazeArrival = 0;
+        }
         return;  // Don't process button logic when keyboard is visible
     }
 
@@ -920,12 +1379,12 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
     for (auto& button : m_visibleButtons) {
         if (button->IsPointInside(x, y)) {
             if (button->UpdateProgress(deltaTime, m_settingHoldTime)) {
-                needsRefresh = true;
+                RefreshRect(GetButtonRect(button.get()), false);
             }
             onButton = true;
         } else {
             if (button->ResetProgress()) {
-                needsRefresh = true;
+                RefreshRect(GetButtonRect(button.get()), false);
             }
         }
     }
@@ -938,7 +1397,7 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
             float buttonBottom = button->GetPosition().y + button->GetSize().GetHeight();
             if (y > buttonBottom + 2 * button->GetSize().GetHeight()) {
                 m_visibleButtons.clear();
-                needsRefresh = true;
+                Refresh(false);  // Background dimming goes away with the last button
             }
         }
 
@@ -953,7 +1412,7 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
                 ToggleHide();
             };
             m_visibleButtons.push_back(std::move(btnUnHide));
-            needsRefresh = true;
+            Refresh(false);  // Background dimming comes back with the button
         }
     }
 
@@ -965,12 +1424,9 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
         }
     }
 
-    // Always refresh when gaze cursor moves significantly (>5 pixels to reduce 120Hz to ~20-30Hz)
+    // Always refresh when gaze cursor moves significantly
     // This ensures the cursor is always visible and tracks the gaze position
-    float dx = m_gazePosition.m_x - oldPosition.m_x;
-    float dy = m_gazePosition.m_y - oldPosition.m_y;
-    float distanceMoved = std::sqrt(dx * dx + dy * dy);
-    if (distanceMoved > 5.0f) {
+    if (CursorMoved(oldPosition)) {
         needsRefresh = true;
     }
 
@@ -982,10 +1438,15 @@ void EyeOverlay::OnGazePositionUpdated(float x, float y, uint64_t timestamp)
         m_lastBringToFrontTimestamp = timestamp;
     }
 
-    // Only refresh when visual state changed
+    // Only refresh when visual state changed (button and list changes were
+    // invalidated above, the remaining state lives in the cursor area)
     if (needsRefresh) {
-        Refresh(false);  // false = don't erase background (we handle it in OnPaint with buffered DC)
+        RefreshRect(GetCursorRect(), false);  // OnPaint also repaints where the cursor was drawn
         // Note: Update() removed - let wxWidgets batch paint events naturally
+    } else if (latchedArrival && !m_fullDamage && m_damage.IsEmpty()) {
+        // Nothing to show for this sample (fixation): the next frame belongs
+        // to a later one, not to the start of the fixation
+        m_pendingGazeArrival = 0;
     }
 }
 
@@ -1003,20 +1464,178 @@ void EyeOverlay::OnSwipeCompleted(const std::vector<std::pair<float, float>>& pa
 
     if (!m_textEngine) return;
 
-    // Predict word
-    wxString prediction = m_textEngine->PredictFromSwipe(path);
+    // Starting a new swipe keeps the previous word
+    CommitSwipeLabel();
+    if (m_sessionRecorder.IsOpen()) {
+        m_swipeLabelContext = m_textEngine->GetCurrentText();
+        m_sessionRecorder.RecordSwipe(path, std::string(m_swipeLabelContext.ToUTF8()), m_lastGazeTimestamp);
+        m_swipeLabelPending = true;
+        m_swipeLabelShown = false;
+    }
 
-    if (!prediction.IsEmpty()) {
-        m_textEngine->AppendText(prediction + wxT(" "));
-        wxLogMessage("Predicted: %s", prediction);
+    if (!m_textEngine->IsInitialized()) {
+        // Models still loading (or missing): letter input keeps working
+        wxLogMessage("Swipe prediction not available yet%s",
+                     m_textEngine->IsInitializing() ? " (models loading)" : "");
+        if (m_keyboard) {
+            m_keyboard->ClearSwipePath();
+        }
+        return;
     }
 
+    // Predict word in the background, the result comes back through OnPredictionReady
+    m_textEngine->PredictFromSwipeAsync(path);
+
     // Clear the swipe path
     if (m_keyboard) {
         m_keyboard->ClearSwipePath();
     }
 }
 
+void EyeOverlay::OnSwipeProgress(const std::vector<std::pair<float, float>>& path)
+{
+    // Speculative: the engine skips it while models load or a word is pending
+    if (m_textEngine) {
+        m_textEngine->PredictPartialSwipeAsync(path);
+    }
+}
+
+void EyeOverlay::OnSwipeCancelled()
+{
+    if (m_textEngine) {
+        m_textEngine->CancelPartialPredictions();
+    }
+    SetProvisionalWord(wxEmptyString);
+}
+
+void EyeOverlay::OnProvisionalPrediction(const wxString& prediction)
+{
+    // A late result of a swipe that already ended is not shown
+    if (m_keyboard && m_keyboard->IsRecordingSwipe()) {
+        SetProvisionalWord(prediction);
+    }
+}
+
+void EyeOverlay::SetProvisionalWord(const wxString& word)
+{
+    if (m_provisionalWord != word) {
+        m_provisionalWord = word;
+        if (m_keyboardVisible) {
+            RefreshRect(GetTextBoxRect(), false);
+        }
+    }
+}
+
+void EyeOverlay::OnPredictionReady(const wxString& prediction)
+{
+    SetProvisionalWord(wxEmptyString);
+    if (!m_textEngine) return;
+
+    if (!prediction.IsEmpty()) {
+        m_textEngine->AppendText(prediction + wxT(" "));
+        wxLogMessage("Predicted: %s", prediction);
+    }
+}
+
+void EyeOverlay::OnCandidatesReady(const std::vector<wxString>& words)
+{
+    // OnPredictionReady inserted words[0] just before
+    if (!m_textEngine || words.size() < 2 ||
+        !m_textEngine->GetCurrentText().EndsWith(words[0] + wxT(" "))) {
+        ClearCandidates();
+        return;
+    }
+    SetCandidates(words[0], std::vector<wxString>(words.begin() + 1, words.end()));
+}
+
+void EyeOverlay::SetCandidates(const wxString& inserted, const std::vector<wxString>& alternates)
+{
+    wxRect damage = GetCandidateBarRect();
+    m_insertedPrediction = inserted;
+    m_candidateKeys.clear();
+
+    if (!alternates.empty()) {
+        // Same geometry as the control buttons in DrawKeyboardWithGC, one row below them
+        int candidateWidth = 200;
+        int candidateHeight = 60;
+        int candidateSpacing = 20;
+        int totalWidth = static_cast<int>(alternates.size()) * (candidateWidth + candidateSpacing) - candidateSpacing;
+        int candidateX = (GetClientSize().GetWidth() - totalWidth) / 2;
+        int candidateY = 50 + 80 + 30 + 60 + 20;  // Text box, gap, control buttons, gap
+
+        for (size_t i = 0; i < alternates.size(); ++i) {
+            int x = candidateX + static_cast<int>(i) * (candidateWidth + candidateSpacing);
+            m_candidateKeys.push_back(KeyboardKey(alternates[i], wxRect(x, candidateY, candidateWidth, candidateHeight)));
+        }
+    }
+    BuildKeyGrid(m_candidateKeys, m_candidateKeyGrid);
+    m_hoveredCandidateKey = KeyGrid::NOT_FOUND;
+
+    damage.Union(GetCandidateBarRect());
+    if (m_keyboardVisible && !damage.IsEmpty()) {
+        RefreshRect(damage, false);
+    }
+}
+
+void EyeOverlay::BuildKeyGrid(const std::vector<KeyboardKey>& keys, KeyGrid& grid)
+{
+    // Cells as large as the smallest button, so a cell holds one or two of them
+    grid.Clear();
+    int cellSize = 0;
+    for (const auto& key : keys) {
+        grid.Add(static_cast<float>(key.bounds.x), static_cast<float>(key.bounds.y),
+                 static_cast<float>(key.bounds.width), static_cast<float>(key.bounds.height));
+        int size = std::min(key.bounds.width, key.bounds.height);
+        if (size > 0 && (cellSize == 0 || size < cellSize)) {
+            cellSize = size;
+        }
+    }
+    grid.Build(static_cast<float>(cellSize));
+}
+
+void EyeOverlay::ClearCandidates()
+{
+    if (!m_insertedPrediction.IsEmpty() || !m_candidateKeys.empty()) {
+        SetCandidates(wxEmptyString, std::vector<wxString>());
+    }
+}
+
+void EyeOverlay::SelectCandidate(size_t index)
+{
+    if (!m_textEngine || index >= m_candidateKeys.size()) return;
+
+    // The edits below clear the bar (OnTextChanged), keep what to rebuild it with
+    wxString inserted = m_insertedPrediction;
+    std::vector<wxString> alternates;
+    for (const auto& key : m_candidateKeys) {
+        alternates.push_back(key.label);
+    }
+    wxString selected = alternates[index];
+
+    if (!m_textEngine->GetCurrentText().EndsWith(inserted + wxT(" "))) {
+        ClearCandidates();
+        return;
+    }
+
+    wxLogMessage("Candidate selected: %s (replaces %s)", selected, inserted);
+    m_textEngine->DeleteLastCharacter();  // Trailing space
+    m_textEngine->DeleteLastWord();
+    m_textEngine->AppendText(selected + wxT(" "));
+
+    // The replaced word takes the place of the selected one, to go back
+    alternates[index] = inserted;
+    SetCandidates(selected, alternates);
+}
+
+void EyeOverlay::OnTextEngineInitialized(bool ready)
+{
+    if (ready) {
+        wxLogMessage("Swipe prediction ready");
+    } else {
+        wxLogWarning("Text engine initialization incomplete, ML features may not be available");
+    }
+}
+
 void EyeOverlay::OnSpacePressed()
 {
     wxLogMessage("Space pressed");
@@ -1052,6 +1671,7 @@ void EyeOverlay::OnEnterPressed()
 void EyeOverlay::OnSpeakPressed()
 {
     wxLogMessage("Speak button pressed via gaze dwell");
+    CommitSwipeLabel();
 #ifdef USE_ESPEAK
     if (m_textEngine && m_espeakEngine) {
         wxString text = m_textEngine->GetCurrentText();
@@ -1072,6 +1692,80 @@ void EyeOverlay::OnTextChanged(const wxString& text)
     // Text display removed - no longer using wxStaticText overlay
     // Text is handled by the keyboard component
     wxLogMessage("Text changed: %s", text);
+
+    // Text box is drawn by the overlay itself, repaint just that area
+    if (m_keyboardVisible) {
+        RefreshRect(GetTextBoxRect(), false);
+    }
+
+    // Alternates only apply while the swiped word is the last one
+    if (!m_insertedPrediction.IsEmpty() && !text.EndsWith(m_insertedPrediction + wxT(" "))) {
+        ClearCandidates();
+    }
+
+    UpdateSwipeLabel(text);
+}
+
+// First word of the text typed after a swipe, followed = more text comes after it
+static wxString first_word(const wxString& text, bool& followed) {
+    size_t start = 0;
+    while (start < text.length() && wxIsspace(text[start])) {
+        ++start;
+    }
+    size_t end = start;
+    while (end < text.length() && !wxIsspace(text[end])) {
+        ++end;
+    }
+    followed = end + 1 < text.length();
+    return text.Mid(start, end - start);
+}
+
+void EyeOverlay::UpdateSwipeLabel(const wxString& text)
+{
+    if (!m_swipeLabelPending) {
+        return;
+    }
+
+    // Text before the swipe was edited or cleared: the word is gone with it
+    if (!text.StartsWith(m_swipeLabelContext)) {
+        m_sessionRecorder.RecordWord(std::string());
+        m_swipeLabelPending = false;
+        return;
+    }
+
+    bool followed = false;
+    wxString word = first_word(text.Mid(m_swipeLabelContext.length()), followed);
+    if (word.IsEmpty()) {
+        // Deleted (backspace, delete word, candidate replaced): unlabeled
+        // unless a word is typed again in its place
+        if (m_swipeLabelShown) {
+            m_sessionRecorder.RecordWord(std::string());
+            m_swipeLabelShown = false;
+        }
+        return;
+    }
+    m_swipeLabelShown = true;
+
+    // The user moved on to the next word (or line), this one is kept
+    if (followed) {
+        m_sessionRecorder.RecordWord(std::string(word.ToUTF8()));
+        m_swipeLabelPending = false;
+    }
+}
+
+void EyeOverlay::CommitSwipeLabel()
+{
+    if (!m_swipeLabelPending || !m_textEngine) {
+        return;
+    }
+    m_swipeLabelPending = false;
+
+    wxString text = m_textEngine->GetCurrentText();
+    bool followed = false;
+    wxString word = text.StartsWith(m_swipeLabelContext)
+                        ? first_word(text.Mid(m_swipeLabelContext.length()), followed)
+                        : wxString();
+    m_sessionRecorder.RecordWord(std::string(word.ToUTF8()));
 }
 
 void EyeOverlay::OnSpeak(wxCommandEvent& event)
@@ -1095,6 +1789,12 @@ void EyeOverlay::SetupUI()
     m_keyboard->OnSwipeCompleted = [this](const std::vector<std::pair<float, float>>& path) {
         OnSwipeCompleted(path);
     };
+    m_keyboard->OnSwipeProgress = [this](const std::vector<std::pair<float, float>>& path) {
+        OnSwipeProgress(path);
+    };
+    m_keyboard->OnSwipeCancelled = [this]() {
+        OnSwipeCancelled();
+    };
     m_keyboard->OnSpacePressed = [this]() {
         OnSpacePressed();
     };
@@ -1117,6 +1817,101 @@ void EyeOverlay::UpdateButtonPositions()
     // No persistent buttons to update (keyboard button is now in the radial panel)
 }
 
+void EyeOverlay::StartSessionRecording()
+{
+    // Only tried once per run
+    m_recordSession = false;
+
+    wxString directory = wxStandardPaths::Get().GetUserDataDir() + wxT("/sessions");
+    if (!wxDirExists(directory) && !wxMkdir(directory)) {
+        wxLogWarning("Cannot create session directory: %s", directory);
+        return;
+    }
+    wxString filepath = directory + wxT("/session-") + wxDateTime::Now().Format(wxT("%Y%m%d-%H%M%S")) + wxT(".heyes");
+
+    // Same geometry as in DrawKeyboardWithGC
+    wxSize clientSize = GetClientSize();
+    SessionGeometry geometry;
+    geometry.overlayWidth = static_cast<float>(clientSize.GetWidth());
+    geometry.overlayHeight = static_cast<float>(clientSize.GetHeight());
+    geometry.keyboardWidth = 1600.0f;
+    geometry.keyboardHeight = 500.0f;
+    geometry.keyboardX = (geometry.overlayWidth - geometry.keyboardWidth) / 2.0f;
+    geometry.keyboardY = geometry.overlayHeight - geometry.keyboardHeight - 50.0f;
+
+    if (m_sessionRecorder.Open(std::string(filepath.ToUTF8()), geometry)) {
+        m_recordSession = true;
+        m_sessionRecorder.RecordKeyboardVisible(m_keyboardVisible, m_lastGazeTimestamp);
+        wxLogMessage("Recording session to %s", filepath);
+    }
+}
+
+void EyeOverlay::UpdateTraceStats()
+{
+    Tracer& tracer = Tracer::Get();
+    tracer.Drain();
+    if (!m_showTraceStats) {
+        return;
+    }
+
+    wxRect oldRect = GetTraceStatsRect();
+    m_traceStatsLines.clear();
+    m_traceStatsLines.push_back(wxString::Format("%-15s %8s %8s %8s %8s", "ms", "last", "p50", "p95", "max"));
+    for (const TraceStageStats& stage : tracer.GetStats()) {
+        m_traceStatsLines.push_back(wxString::Format("%-15s %8.2f %8.2f %8.2f %8.2f", stage.name,
+                                                     stage.lastMs, stage.p50Ms, stage.p95Ms, stage.maxMs));
+    }
+    FrameStats frames = m_frameScheduler.GetStats();
+    m_traceStatsLines.push_back(wxString::Format("%.1f fps, %llu gaze / %llu trace events dropped",
+                                                 frames.GetAverageFps(),
+                                                 static_cast<unsigned long long>(m_gazeTracker->GetDroppedSampleCount()),
+                                                 static_cast<unsigned long long>(tracer.GetDroppedCount())));
+
+    // The panel grows when a new stage shows up
+    wxRect newRect = GetTraceStatsRect();
+    if (!oldRect.IsEmpty()) {
+        Refresh(false, &oldRect);
+    }
+    Refresh(false, &newRect);
+}
+
+void EyeOverlay::DrawTraceStatsWithGC(wxGraphicsContext* gc)
+{
+    wxRect rect = GetTraceStatsRect();
+    if (rect.IsEmpty() || !rect.Intersects(m_paintDirtyRect)) {
+        return;
+    }
+    rect.Deflate(2);
+
+    if (m_staticPaths.traceStatsRect != rect) {
+        m_staticPaths.traceStats = gc->CreatePath();
+        m_staticPaths.traceStats.AddRoundedRectangle(rect.x, rect.y, rect.width, rect.height, 6);
+        m_staticPaths.traceStatsRect = rect;
+    }
+    gc->SetBrush(m_renderResources.textBoxBrush);
+    gc->SetPen(m_renderResources.pen1);
+    gc->DrawPath(m_staticPaths.traceStats);
+
+    gc->SetFont(m_renderResources.statsFont);
+    for (size_t i = 0; i < m_traceStatsLines.size(); ++i) {
+        gc->DrawText(m_traceStatsLines[i], rect.x + 10, rect.y + 8 + 18 * static_cast<int>(i));
+    }
+}
+
+void EyeOverlay::ExportTrace()
+{
+    wxString directory = wxStandardPaths::Get().GetUserDataDir() + wxT("/traces");
+    if (!wxDirExists(directory) && !wxMkdir(directory)) {
+        wxLogWarning("Cannot create trace directory: %s", directory);
+        return;
+    }
+    wxString filepath = directory + wxT("/trace-") + wxDateTime::Now().Format(wxT("%Y%m%d-%H%M%S")) + wxT(".json");
+
+    if (Tracer::Get().ExportChromeTrace(std::string(filepath.ToUTF8()))) {
+        wxLogMessage("Trace written to %s (chrome://tracing, Perfetto or Tracy import-chrome)", filepath);
+    }
+}
+
 void EyeOverlay::CaptureScreenshotIfNeeded()
 {
     // Only take screenshot if we don't have one yet (first time or after undo)
@@ -1127,65 +1922,55 @@ void EyeOverlay::CaptureScreenshotIfNeeded()
             static_cast<int>(m_gazePosition.m_y)
         );
 
-        // Make overlay invisible before screenshot (like HeyEyeControl - just set flag and repaint)
-        m_visible = false;
-        Hide();
-        Refresh();
-        Update();  // to be sure the circle won't be present on the screenshot
-
-        wxMilliSleep(50);  // to be sure the overlay has disappear
+        // Calculate and store the actual screenshot area (with border clamping)
+        m_screenshotSourceRect = GetSelectionRect(m_screenshotPosition);
 
-        // Take screenshot of ENTIRE screen (like HeyEyeControl)
-        wxScreenDC screenDC;
-        wxSize clientSize = GetClientSize();
-        m_screenshot = wxBitmap(clientSize.GetWidth(), clientSize.GetHeight());
-        wxMemoryDC memDC(m_screenshot);
-
-        memDC.Blit(
-            0, 0,
-            clientSize.GetWidth(), clientSize.GetHeight(),
-            &screenDC,
-            0, 0
-        );
+        // Only the selection is ever shown (directly or zoomed), grab just that
+        // (the overlay is excluded from capture, so it can stay visible)
+        CaptureScreenshotRegion(m_screenshotSourceRect);
+    }
+}
 
-        memDC.SelectObject(wxNullBitmap);
-        m_hasScreenshot = true;
+wxRect EyeOverlay::GetSelectionRect(const wxPoint& center) const
+{
+    // Try to center the selection on the target, but clamp to screen edges
+    wxSize clientSize = GetClientSize();
+    wxRect rect(center.x - m_settingSelectionWidth / 2,
+                center.y - m_settingSelectionHeight / 2,
+                m_settingSelectionWidth,
+                m_settingSelectionHeight);
+
+    if (rect.x + rect.width > clientSize.GetWidth())
+        rect.x = clientSize.GetWidth() - rect.width;
+    if (rect.y + rect.height > clientSize.GetHeight())
+        rect.y = clientSize.GetHeight() - rect.height;
+    if (rect.x < 0)
+        rect.x = 0;
+    if (rect.y < 0)
+        rect.y = 0;
+
+    return rect;
+}
 
-        // Calculate and store the actual screenshot area (with border clamping)
-        int intendedX = m_screenshotPosition.x - m_settingSelectionWidth / 2;
-        int intendedY = m_screenshotPosition.y - m_settingSelectionHeight / 2;
-
-        m_screenshotSourceRect = wxRect(
-            intendedX,
-            intendedY,
-            m_settingSelectionWidth,
-            m_settingSelectionHeight
-        );
+void EyeOverlay::CaptureScreenshotRegion(const wxRect& rect)
+{
+    // Overlay client coordinates -> virtual desktop
+    wxRect screenRect(rect);
+    screenRect.Offset(m_screenOrigin);
 
-        // Clamp to screen bounds (same logic as in OnPaint)
-        if (m_screenshotSourceRect.x < 0)
-            m_screenshotSourceRect.x = 0;
-        if (m_screenshotSourceRect.y < 0)
-            m_screenshotSourceRect.y = 0;
-        if (m_screenshotSourceRect.x + m_screenshotSourceRect.width > m_screenshot.GetWidth())
-            m_screenshotSourceRect.x = m_screenshot.GetWidth() - m_screenshotSourceRect.width;
-        if (m_screenshotSourceRect.y + m_screenshotSourceRect.height > m_screenshot.GetHeight())
-            m_screenshotSourceRect.y = m_screenshot.GetHeight() - m_screenshotSourceRect.height;
+    m_hasScreenshot = m_screenCapture.CaptureRegion(screenRect, m_screenshot);
+    m_screenshotCaptureRect = rect;
+    m_screenshotGraphicsBitmap = wxGraphicsBitmap();  // Drop the converted copy of the previous capture
 
-        // Make overlay visible again
-        m_visible = true;
-        Show();  // Must call Show() since we called Hide() before screenshot
-        Refresh();  // Force repaint to show buttons
-    }
+    Refresh();  // Force repaint to show buttons
 }
 
 void EyeOverlay::CreateButtonsAtCenter()
 {
     // Clear any existing buttons
     m_visibleButtons.clear();
-    m_dwellProgress = 0.0f;
-    m_positionHistory.clear();
-    m_timestampHistory.clear();
+    m_dwellProgress.Reset();
+    m_dwellDetector.Reset();
 
     // Always bring window to front when creating buttons
     EnsureOnTop();
@@ -1211,9 +1996,8 @@ void EyeOverlay::CreateButtonsAtCenter()
             ShowKeyboard(!m_keyboardVisible);
             // Clear buttons but preserve screenshot for MENU button to use
             m_visibleButtons.clear();
-            m_dwellProgress = 0.0f;
-            m_positionHistory.clear();
-            m_timestampHistory.clear();
+            m_dwellProgress.Reset();
+            m_dwellDetector.Reset();
             // Don't clear m_hasScreenshot, m_screenshot, m_screenshotPosition, m_screenshotSourceRect
         };
         m_visibleButtons.push_back(std::move(btnKeyboard));
@@ -1308,12 +2092,13 @@ void EyeOverlay::CreateButtonsAtCenter()
 void EyeOverlay::ClearAllButtons()
 {
     m_visibleButtons.clear();
-    m_dwellProgress = 0.0f;
-    m_positionHistory.clear();
-    m_timestampHistory.clear();
+    m_dwellProgress.Reset();
+    m_dwellDetector.Reset();
     m_hasScreenshot = false;
     m_screenshot = wxNullBitmap;
+    m_screenshotGraphicsBitmap = wxGraphicsBitmap();
     m_screenshotSourceRect = wxRect(0, 0, 0, 0);
+    m_screenshotCaptureRect = wxRect(0, 0, 0, 0);
     m_isZoomed = false;
     // Note: m_isScrollMode and m_isDragMode are NOT cleared here - they persist until explicitly changed
 }
@@ -1327,13 +2112,13 @@ void EyeOverlay::Click()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and click
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1363,13 +2148,13 @@ void EyeOverlay::ClickRight()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and click
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1409,13 +2194,13 @@ void EyeOverlay::DoubleClick()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and double click
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1460,13 +2245,13 @@ void EyeOverlay::Drag()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and start drag (button DOWN only)
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1494,13 +2279,13 @@ void EyeOverlay::Drop()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and release drag (button UP)
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1536,6 +2321,7 @@ void EyeOverlay::ToggleHide()
 void EyeOverlay::SubmitText()
 {
     if (!m_textEngine) return;
+    CommitSwipeLabel();
 
     wxString text = m_textEngine->GetCurrentText();
     if (text.IsEmpty()) {
@@ -1549,13 +2335,13 @@ void EyeOverlay::SubmitText()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and click first (to focus the text field)
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1614,6 +2400,7 @@ void EyeOverlay::SubmitText()
 void EyeOverlay::SubmitTextWithReturn()
 {
     if (!m_textEngine) return;
+    CommitSwipeLabel();
 
     wxString text = m_textEngine->GetCurrentText();
     if (text.IsEmpty()) {
@@ -1627,13 +2414,13 @@ void EyeOverlay::SubmitTextWithReturn()
     m_visible = false;
     Hide();
     Refresh();
-    Update();
+    RenderNow();
 
 #ifdef __WXMSW__
     wxMilliSleep(50);
 
     // Move cursor and click first (to focus the text field)
-    SetCursorPos(m_screenshotPosition.x, m_screenshotPosition.y);
+    SetCursorPos(m_screenOrigin.x + m_screenshotPosition.x, m_screenOrigin.y + m_screenshotPosition.y);
 
     wxMilliSleep(m_settingCursorDelay);
 
@@ -1742,132 +2529,101 @@ bool EyeOverlay::IsTextCursorAtPosition(int x, int y)
 
 bool EyeOverlay::UpdateDwellDetection(float x, float y, uint64_t timestamp)
 {
-    // Add current position to history
-    m_positionHistory.push_back(wxPoint2DDouble(x, y));
-    m_timestampHistory.push_back(timestamp);
-
-    // Remove old positions (older than wait time)
-    while (!m_timestampHistory.empty() &&
-           (timestamp - m_timestampHistory.front()) >= static_cast<uint64_t>(m_settingWaitTime * 1000)) {
-        m_positionHistory.erase(m_positionHistory.begin());
-        m_timestampHistory.erase(m_timestampHistory.begin());
-    }
+    TRACE_SCOPE("dwell");
+    // Add current position, samples older than wait time drop out of the window
+    m_dwellDetector.SetWindow(static_cast<uint64_t>(m_settingWaitTime) * 1000);
+    m_dwellDetector.AddSample(x, y, timestamp);
 
     // Check if movement is stable (within 30 pixels like HeyEyeControl)
-    if (!m_positionHistory.empty()) {
-        float minX = 1e15f, maxX = 0.0f, minY = 1e15f, maxY = 0.0f;
-        for (const auto& pt : m_positionHistory) {
-            if (pt.m_x < minX) minX = pt.m_x;
-            if (pt.m_x > maxX) maxX = pt.m_x;
-            if (pt.m_y < minY) minY = pt.m_y;
-            if (pt.m_y > maxY) maxY = pt.m_y;
+    bool isStable = m_dwellDetector.IsStable();
+
+    if (isStable) {
+        // Move cursor only if the button layer is not visible
+        if (!m_visible) {
+            SetCursorPos(m_screenOrigin.x + static_cast<int>(m_gazePosition.m_x), m_screenOrigin.y + static_cast<int>(m_gazePosition.m_y));
         }
 
-        bool isStable = ((maxX - minX) < 30) && ((maxY - minY) < 30);
+        // Update progress
+        float deltaT = static_cast<float>(m_dwellDetector.GetLastDelta());
+        bool progressChanged = m_dwellProgress.Advance(deltaT, m_settingHoldTime * 1000.0f);
 
-        if (isStable && m_timestampHistory.size() > 2) {
-            // Move cursor only if the button layer is not visible
-            if (!m_visible) {
-                SetCursorPos(m_gazePosition.m_x, m_gazePosition.m_y);
-            }
+        if (m_dwellProgress.IsComplete()) {
+            // Dwell complete
+            m_dwellProgress.Reset();
 
-            // Update progress
-            float oldProgress = m_dwellProgress;
-            float deltaT = static_cast<float>(m_timestampHistory.back() - m_timestampHistory[m_timestampHistory.size() - 2]);
-            m_dwellProgress += deltaT / (m_settingHoldTime * 1000.0f);
-
-            if (m_dwellProgress >= 1.0f) {
-                // Dwell complete
-                m_dwellProgress = 0.0f;
-
-                if (m_isZoomed) {
-                    // In zoom mode - refine position and exit zoom
-                    wxLogMessage("Zoom refinement: refining position from (%d, %d)", m_screenshotPosition.x, m_screenshotPosition.y);
-
-                    wxSize clientSize = GetClientSize();
-                    int centerX = clientSize.GetWidth() / 2;
-                    int centerY = clientSize.GetHeight() / 2;
-
-                    // In zoom view, screen center corresponds to sourceRect center
-                    // User is looking at (x, y) which corresponds to a specific point in the screenshot
-                    int sourceRectCenterX = m_screenshotSourceRect.x + m_screenshotSourceRect.width / 2;
-                    int sourceRectCenterY = m_screenshotSourceRect.y + m_screenshotSourceRect.height / 2;
-
-                    // Calculate the absolute position in screen coordinates where user is looking
-                    m_screenshotPosition.x = sourceRectCenterX + static_cast<int>((x - centerX) / m_settingZoomFactor);
-                    m_screenshotPosition.y = sourceRectCenterY + static_cast<int>((y - centerY) / m_settingZoomFactor);
-
-                    wxLogMessage("Zoom refinement: new position (%d, %d)", m_screenshotPosition.x, m_screenshotPosition.y);
-
-                    // Recalculate screenshot source rect to center on new position
-                    // Try to center the crosshair, but clamp to screen edges
-                    int intendedX = m_screenshotPosition.x - m_settingSelectionWidth / 2;
-                    int intendedY = m_screenshotPosition.y - m_settingSelectionHeight / 2;
-
-                    m_screenshotSourceRect = wxRect(
-                        intendedX,
-                        intendedY,
-                        m_settingSelectionWidth,
-                        m_settingSelectionHeight
-                    );
-
-                    // Clamp to screen bounds
-                    if (m_screenshotSourceRect.x < 0)
-                        m_screenshotSourceRect.x = 0;
-                    if (m_screenshotSourceRect.y < 0)
-                        m_screenshotSourceRect.y = 0;
-                    if (m_screenshotSourceRect.x + m_screenshotSourceRect.width > m_screenshot.GetWidth())
-                        m_screenshotSourceRect.x = m_screenshot.GetWidth() - m_screenshotSourceRect.width;
-                    if (m_screenshotSourceRect.y + m_screenshotSourceRect.height > m_screenshot.GetHeight())
-                        m_screenshotSourceRect.y = m_screenshot.GetHeight() - m_screenshotSourceRect.height;
-
-                    wxLogMessage("Zoom refinement: updated sourceRect to (%d, %d, %d, %d)",
-                                m_screenshotSourceRect.x, m_screenshotSourceRect.y,
-                                m_screenshotSourceRect.width, m_screenshotSourceRect.height);
-
-                    // Exit zoom mode and recreate buttons
-                    m_isZoomed = false;
-
-                    // Capture screenshot first (before checking text cursor)
-                    CaptureScreenshotIfNeeded();
-
-                    // Check if we're on a text cursor - if so, show keyboard instead of buttons
-                    if (m_settings && m_settings->GetAutoShowKeyboard() &&
-                        IsTextCursorAtPosition(static_cast<int>(x), static_cast<int>(y))) {
-                        wxLogMessage("Text cursor detected - showing keyboard instead of buttons");
-                        // Screenshot position already captured above
-                        ShowKeyboard(true);
-                    } else {
-                        CreateButtonsAtCenter();
-                    }
-                } else {
-                    // Normal mode - create buttons at center
-                    wxLogMessage("DWELL COMPLETE! Creating buttons at center...");
-
-                    // Capture screenshot first (before checking text cursor)
-                    CaptureScreenshotIfNeeded();
-
-                    // Check if we're on a text cursor - if so, show keyboard instead of buttons
-                    if (m_settings && m_settings->GetAutoShowKeyboard() &&
-                        IsTextCursorAtPosition(static_cast<int>(x), static_cast<int>(y))) {
-                        wxLogMessage("Text cursor detected - showing keyboard instead of buttons");
-                        // Screenshot position already captured above
-                        ShowKeyboard(true);
-                    } else {
-                        CreateButtonsAtCenter();
-                    }
+            if (m_isZoomed) {
+                // In zoom mode - refine position and exit zoom
+                wxLogMessage("Zoom refinement: refining position from (%d, %d)", m_screenshotPosition.x, m_screenshotPosition.y);
+
+                wxSize clientSize = GetClientSize();
+                int centerX = clientSize.GetWidth() / 2;
+                int centerY = clientSize.GetHeight() / 2;
+
+                // In zoom view, screen center corresponds to sourceRect center
+                // User is looking at (x, y) which corresponds to a specific point in the screenshot
+                int sourceRectCenterX = m_screenshotSourceRect.x + m_screenshotSourceRect.width / 2;
+                int sourceRectCenterY = m_screenshotSourceRect.y + m_screenshotSourceRect.height / 2;
+
+                // Calculate the absolute position in screen coordinates where user is looking
+                m_screenshotPosition.x = sourceRectCenterX + static_cast<int>((x - centerX) / m_settingZoomFactor);
+                m_screenshotPosition.y = sourceRectCenterY + static_cast<int>((y - centerY) / m_settingZoomFactor);
+
+                wxLogMessage("Zoom refinement: new position (%d, %d)", m_screenshotPosition.x, m_screenshotPosition.y);
+
+                // Recalculate screenshot source rect to center on new position
+                m_screenshotSourceRect = GetSelectionRect(m_screenshotPosition);
+
+                // The refined selection may reach outside the captured region
+                if (!m_screenshotCaptureRect.Contains(m_screenshotSourceRect)) {
+                    CaptureScreenshotRegion(m_screenshotSourceRect);
                 }
 
-                return true;  // Visual state changed
-            }
+                wxLogMessage("Zoom refinement: updated sourceRect to (%d, %d, %d, %d)",
+                            m_screenshotSourceRect.x, m_screenshotSourceRect.y,
+                            m_screenshotSourceRect.width, m_screenshotSourceRect.height);
 
-            // Only refresh if progress changed significantly (every 5%)
-            return (static_cast<int>(m_dwellProgress * 20) != static_cast<int>(oldProgress * 20));
-        } else {
-            if (m_dwellProgress > 0.0f) {
-                m_dwellProgress = 0.0f;
-                return true;  // Visual state changed (progress reset)
+                // Exit zoom mode and recreate buttons
+                m_isZoomed = false;
+
+                // Capture screenshot first (before checking text cursor)
+                CaptureScreenshotIfNeeded();
+
+                // Check if we're on a text cursor - if so, show keyboard instead of buttons
+                if (m_settings && m_settings->GetAutoShowKeyboard() &&
+                    IsTextCursorAtPosition(static_cast<int>(x), static_cast<int>(y))) {
+                    wxLogMessage("Text cursor detected - showing keyboard instead of buttons");
+                    // Screenshot position already captured above
+                    ShowKeyboard(true);
+                } else {
+                    CreateButtonsAtCenter();
+                }
+            } else {
+                // Normal mode - create buttons at center
+                wxLogMessage("DWELL COMPLETE! Creating buttons at center...");
+
+                // Capture screenshot first (before checking text cursor)
+                CaptureScreenshotIfNeeded();
+
+                // Check if we're on a text cursor - if so, show keyboard instead of buttons
+                if (m_settings && m_settings->GetAutoShowKeyboard() &&
+                    IsTextCursorAtPosition(static_cast<int>(x), static_cast<int>(y))) {
+                    wxLogMessage("Text cursor detected - showing keyboard instead of buttons");
+                    // Screenshot position already captured above
+                    ShowKeyboard(true);
+                } else {
+                    CreateButtonsAtCenter();
+                }
             }
+
+            Refresh(false);  // Buttons, screenshot or keyboard now cover the whole overlay
+            return true;  // Visual state changed
+        }
+
+        // Only refresh if progress changed significantly (every 5%)
+        return progressChanged;
+    } else {
+        if (m_dwellProgress.Reset()) {
+            return true;  // Visual state changed (progress reset)
         }
     }
 
@@ -1,5 +1,9 @@
 #include "gazetracker.h"
 
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#endif
+
 #ifdef USE_TOBII
 #include "tobii/tobii.h"
 #include "tobii/tobii_streams.h"
@@ -16,22 +20,12 @@ static void gaze_point_callback(tobii_gaze_point_t const* gaze_point, void* user
     {
         GazeTracker* tracker = static_cast<GazeTracker*>(user_data);
 
-        // Get screen dimensions
-        wxDisplay display(wxDisplay::GetFromPoint(wxGetMousePosition()));
-        wxRect screenRect = display.GetGeometry();
-
-        // Convert normalized coordinates (0.0-1.0) to screen coordinates
-        float x = gaze_point->position_xy[0] * screenRect.GetWidth();
-        float y = gaze_point->position_xy[1] * screenRect.GetHeight();
-
-        // Keep timestamp in microseconds (as expected by dwell calculation)
-        uint64_t timestamp = gaze_point->timestamp_us;
-
-        // Call the callback if set
-        if (tracker->OnGazePositionUpdated)
-        {
-            tracker->OnGazePositionUpdated(x, y, timestamp);
-        }
+        // May run on the capture thread: only queue the normalized sample here,
+        // screen mapping and the user callback happen when the GUI drains it.
+        // Timestamp stays in microseconds (as expected by dwell calculation)
+        tracker->QueueSample(gaze_point->position_xy[0],
+                             gaze_point->position_xy[1],
+                             gaze_point->timestamp_us);
     }
 }
 
@@ -43,6 +37,9 @@ static void url_receiver(char const* url, void* user_data)
 }
 #endif
 
+// Posted by the discovery thread, handled on the GUI thread
+wxDEFINE_EVENT(wxEVT_GAZE_DEVICE_DISCOVERED, wxThreadEvent);
+
 wxBEGIN_EVENT_TABLE(GazeTracker, wxEvtHandler)
     EVT_TIMER(wxID_ANY, GazeTracker::OnTimer)
 wxEND_EVENT_TABLE()
@@ -54,17 +51,31 @@ GazeTracker::GazeTracker()
     , m_deviceRatio(1.0f)
     , m_api(nullptr)
     , m_device(nullptr)
+    , m_captureMode(CaptureMode::Thread)
+    , m_captureRunning(false)
+    , m_discovering(false)
+    , m_trackedDisplay(-1)
     , m_manualMode(false)
     , m_manualX(0.0f)
     , m_manualY(0.0f)
+    , m_currentSampleArrival(0)
     , OnGazePositionUpdated(nullptr)
 {
     // Create update timer
     m_updateTimer = new wxTimer(this);
+
+    Bind(wxEVT_GAZE_DEVICE_DISCOVERED, &GazeTracker::OnDeviceDiscovered, this);
+
+    RefreshDisplayGeometry();
 }
 
 GazeTracker::~GazeTracker()
 {
+    // Discovery owns the Tobii handles until it returns
+    if (m_discoveryThread.joinable()) {
+        m_discoveryThread.join();
+    }
+
     StopTracking();
 
     // Clean up Tobii resources
@@ -108,16 +119,125 @@ bool GazeTracker::Initialize()
     return true;
 }
 
-void GazeTracker::SetManualPosition(float x, float y)
+void GazeTracker::InitializeAsync()
+{
+    if (m_discovering.exchange(true)) {
+        return;
+    }
+
+    wxLogMessage("GazeTracker: Initializing (device discovery in background)...");
+
+    // Mouse control until the device is connected
+    m_manualMode = true;
+    StartTracking();
+
+    m_discoveryThread = std::thread([this]() {
+        bool found = DiscoverDevice();
+
+        wxThreadEvent* event = new wxThreadEvent(wxEVT_GAZE_DEVICE_DISCOVERED);
+        event->SetInt(found ? 1 : 0);
+        wxQueueEvent(this, event);
+    });
+}
+
+void GazeTracker::OnDeviceDiscovered(wxThreadEvent& event)
+{
+    if (m_discoveryThread.joinable()) {
+        m_discoveryThread.join();
+    }
+    m_discovering = false;
+
+    if (event.GetInt() == 0) {
+        wxLogWarning("GazeTracker: No Tobii device found, running in manual mode");
+        return;
+    }
+
+    // Hand over from the mouse to the device
+    m_manualMode = false;
+    m_connected = true;
+    if (m_captureMode == CaptureMode::Thread && m_updateTimer && m_updateTimer->IsRunning()) {
+        StartCaptureThread();
+    }
+
+    wxLogMessage("GazeTracker: Initialization complete");
+}
+
+void GazeTracker::SetManualPosition(float x, float y, uint64_t timestamp)
 {
     m_manualX = x;
     m_manualY = y;
 
     if (m_manualMode && OnGazePositionUpdated) {
-        OnGazePositionUpdated(x, y, 0);
+        // Same clock as the mouse samples of OnTimer, dwell detection needs it
+        if (timestamp == 0) {
+            timestamp = wxGetUTCTimeMillis().GetValue() * 1000;
+        }
+        m_currentSampleArrival = TRACE_NOW();
+        OnGazePositionUpdated(x, y, timestamp);
     }
 }
 
+void GazeTracker::SetCaptureMode(CaptureMode mode)
+{
+    if (mode == m_captureMode) {
+        return;
+    }
+
+    m_captureMode = mode;
+    wxLogMessage("GazeTracker: Capture mode set to %s",
+                 mode == CaptureMode::Thread ? "thread" : "timer");
+
+    // Switch the pump without touching the gaze subscription
+    if (m_updateTimer && m_updateTimer->IsRunning()) {
+        if (mode == CaptureMode::Thread) {
+            StartCaptureThread();
+        } else {
+            StopCaptureThread();
+        }
+    }
+}
+
+void GazeTracker::SetTrackedDisplay(int index)
+{
+    m_trackedDisplay = index;
+    RefreshDisplayGeometry();
+}
+
+void GazeTracker::RefreshDisplayGeometry()
+{
+    int count = static_cast<int>(wxDisplay::GetCount());
+    int index = m_trackedDisplay;
+
+    if (index < 0 || index >= count) {
+        if (index >= count) {
+            wxLogWarning("GazeTracker: Display %d not available (%d connected), using display under mouse",
+                         index, count);
+        }
+        index = wxDisplay::GetFromPoint(wxGetMousePosition());
+        if (index == wxNOT_FOUND) {
+            index = 0;
+        }
+    }
+
+    wxDisplay display(static_cast<unsigned int>(index));
+    m_displayRect = display.GetGeometry();
+
+    wxLogMessage("GazeTracker: Tracking display %d of %d at (%d, %d) %dx%d%s",
+                 index, count, m_displayRect.x, m_displayRect.y,
+                 m_displayRect.width, m_displayRect.height,
+                 display.IsPrimary() ? " (primary)" : "");
+}
+
+void GazeTracker::QueueSample(float x, float y, uint64_t timestamp)
+{
+    GazeSample sample;
+    sample.x = x;
+    sample.y = y;
+    sample.timestamp = timestamp;
+    sample.queuedAt = TRACE_NOW();
+    m_samples.TryPush(sample);
+}
+
 void GazeTracker::OnTimer(wxTimerEvent& event)
 {
     wxUnusedVar(event);
@@ -132,6 +252,7 @@ void GazeTracker::UpdateCallbacks()
         if (OnGazePositionUpdated) {
             // Use microseconds timestamp (milliseconds * 1000)
             uint64_t timestamp = wxGetUTCTimeMillis().GetValue() * 1000;
+            m_currentSampleArrival = TRACE_NOW();
             OnGazePositionUpdated(static_cast<float>(mousePos.x),
                                 static_cast<float>(mousePos.y),
                                 timestamp);
@@ -139,6 +260,15 @@ void GazeTracker::UpdateCallbacks()
         return;
     }
 
+    // In thread mode the capture thread pumps the device, just consume its samples
+    if (m_captureMode == CaptureMode::Timer) {
+        ProcessDeviceCallbacks();
+    }
+    DrainSamples();
+}
+
+void GazeTracker::ProcessDeviceCallbacks()
+{
 #ifdef USE_TOBII
     // Process Tobii callbacks
     if (m_device) {
@@ -158,6 +288,85 @@ void GazeTracker::UpdateCallbacks()
 #endif
 }
 
+void GazeTracker::DrainSamples()
+{
+    size_t count = m_samples.PopBatch(m_drainBuffer, SAMPLE_RING_SIZE);
+    if (count == 0 || !OnGazePositionUpdated) {
+        return;
+    }
+
+    const float originX = static_cast<float>(m_displayRect.x);
+    const float originY = static_cast<float>(m_displayRect.y);
+    const float width = static_cast<float>(m_displayRect.width);
+    const float height = static_cast<float>(m_displayRect.height);
+
+    for (size_t i = 0; i < count; ++i) {
+        const GazeSample& sample = m_drainBuffer[i];
+
+        // Convert normalized coordinates (0.0-1.0) to screen coordinates
+        float x = originX + sample.x * width;
+        float y = originY + sample.y * height;
+        m_currentSampleArrival = sample.queuedAt;
+        OnGazePositionUpdated(x, y, sample.timestamp);
+    }
+}
+
+void GazeTracker::StartCaptureThread()
+{
+#ifdef USE_TOBII
+    if (!m_device || m_manualMode || m_captureRunning.load()) {
+        return;
+    }
+
+    m_captureRunning = true;
+    m_captureThread = std::thread(&GazeTracker::CaptureThreadLoop, this);
+    wxLogMessage("GazeTracker: Capture thread started");
+#endif
+}
+
+void GazeTracker::StopCaptureThread()
+{
+    if (!m_captureRunning.load()) {
+        return;
+    }
+
+    // tobii_wait_for_callbacks times out on its own, the loop sees the flag shortly after
+    m_captureRunning = false;
+    if (m_captureThread.joinable()) {
+        m_captureThread.join();
+    }
+    wxLogMessage("GazeTracker: Capture thread stopped");
+}
+
+void GazeTracker::CaptureThreadLoop()
+{
+#ifdef __WXMSW__
+    // Gaze acquisition must not be starved by painting or inference
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#endif
+    TRACE_THREAD_NAME("gaze capture");
+
+#ifdef USE_TOBII
+    while (m_captureRunning.load()) {
+        tobii_error_t error = tobii_wait_for_callbacks(1, &m_device);
+        if (error == TOBII_ERROR_TIMED_OUT) {
+            continue;
+        }
+        if (error != TOBII_ERROR_NO_ERROR) {
+            wxLogWarning("Tobii wait_for_callbacks failed: %s", tobii_error_message(error));
+            // Avoid spinning if the device keeps failing
+            wxMilliSleep(REFRESH_DELAY);
+            continue;
+        }
+
+        error = tobii_device_process_callbacks(m_device);
+        if (error != TOBII_ERROR_NO_ERROR) {
+            wxLogWarning("Failed to process callbacks: %s", tobii_error_message(error));
+        }
+    }
+#endif
+}
+
 bool GazeTracker::DiscoverDevice()
 {
     wxLogMessage("GazeTracker: Discovering Tobii devices...");
@@ -238,6 +447,10 @@ void GazeTracker::StartTracking()
         m_updateTimer->Start(REFRESH_DELAY);
         wxLogMessage("GazeTracker: Tracking started");
     }
+
+    if (m_captureMode == CaptureMode::Thread) {
+        StartCaptureThread();
+    }
 }
 
 void GazeTracker::StopTracking()
@@ -247,6 +460,9 @@ void GazeTracker::StopTracking()
         wxLogMessage("GazeTracker: Tracking stopped");
     }
 
+    // The capture thread must be gone before the subscription is torn down
+    StopCaptureThread();
+
 #ifdef USE_TOBII
     if (m_device) {
         // Unsubscribe from gaze stream
@@ -0,0 +1,206 @@
+#include "audiostream.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#include <mmsystem.h>
+#endif
+
+#ifdef __WXMSW__
+struct AudioStream::Device {
+    HWAVEOUT handle;
+    HANDLE doneEvent;  // Set by the driver each time a buffer finished playing
+    WAVEHDR headers[BUFFER_COUNT];
+    std::vector<int16_t> samples[BUFFER_COUNT];
+    size_t capacity;   // Samples per buffer
+    size_t current;    // Buffer being filled
+    size_t filled;     // Samples already in it
+};
+#else
+struct AudioStream::Device {};
+#endif
+
+AudioStream::AudioStream()
+    : m_generation(0)
+{
+}
+
+AudioStream::~AudioStream()
+{
+    Close();
+}
+
+bool AudioStream::IsSupported()
+{
+#ifdef __WXMSW__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool AudioStream::Open(int sampleRate)
+{
+    Close();
+
+#ifdef __WXMSW__
+    std::unique_ptr<Device> device(new Device());
+    device->doneEvent = ::CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!device->doneEvent) {
+        wxLogError("AudioStream: CreateEvent failed (error %lu)", static_cast<unsigned long>(::GetLastError()));
+        return false;
+    }
+
+    WAVEFORMATEX format;
+    ZeroMemory(&format, sizeof(format));
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = 1;
+    format.nSamplesPerSec = sampleRate;
+    format.wBitsPerSample = 16;
+    format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+    MMRESULT result = ::waveOutOpen(&device->handle, WAVE_MAPPER, &format,
+                                    reinterpret_cast<DWORD_PTR>(device->doneEvent), 0, CALLBACK_EVENT);
+    if (result != MMSYSERR_NOERROR) {
+        wxLogError("AudioStream: waveOutOpen failed (error %u)", static_cast<unsigned>(result));
+        ::CloseHandle(device->doneEvent);
+        return false;
+    }
+
+    // Headers stay prepared for the lifetime of the device, a buffer is free
+    // whenever the driver does not hold it (WHDR_INQUEUE cleared)
+    device->capacity = std::max(1, sampleRate * BUFFER_MS / 1000);
+    for (size_t i = 0; i < BUFFER_COUNT; ++i) {
+        device->samples[i].resize(device->capacity);
+        ZeroMemory(&device->headers[i], sizeof(WAVEHDR));
+        device->headers[i].lpData = reinterpret_cast<LPSTR>(device->samples[i].data());
+        device->headers[i].dwBufferLength = static_cast<DWORD>(device->capacity * sizeof(int16_t));
+        ::waveOutPrepareHeader(device->handle, &device->headers[i], sizeof(WAVEHDR));
+    }
+    device->current = 0;
+    device->filled = 0;
+
+    std::lock_guard<std::mutex> lock(m_deviceMutex);
+    m_device = std::move(device);
+    return true;
+#else
+    wxUnusedVar(sampleRate);
+    return false;
+#endif
+}
+
+void AudioStream::Close()
+{
+    // Callers stop their producer first, no Write() may be waiting here
+    std::lock_guard<std::mutex> lock(m_deviceMutex);
+    if (!m_device) {
+        return;
+    }
+    m_generation++;
+
+#ifdef __WXMSW__
+    Device& device = *m_device;
+    ::waveOutReset(device.handle);
+    for (size_t i = 0; i < BUFFER_COUNT; ++i) {
+        ::waveOutUnprepareHeader(device.handle, &device.headers[i], sizeof(WAVEHDR));
+    }
+    ::waveOutClose(device.handle);
+    ::CloseHandle(device.doneEvent);
+#endif
+    m_device.reset();
+}
+
+bool AudioStream::IsOpen() const
+{
+    return m_device != nullptr;
+}
+
+bool AudioStream::Write(const int16_t* samples, size_t count, uint64_t generation)
+{
+#ifdef __WXMSW__
+    while (count > 0) {
+        // Reset() holds the same lock, checked again before every buffer is queued
+        std::unique_lock<std::mutex> lock(m_deviceMutex);
+        if (!m_device || m_generation.load() != generation) {
+            return false;
+        }
+
+        Device& device = *m_device;
+        if (device.headers[device.current].dwFlags & WHDR_INQUEUE) {
+            // Every buffer is queued: wait for the driver to hand one back
+            // (Reset() sets the event too)
+            HANDLE doneEvent = device.doneEvent;
+            lock.unlock();
+            ::WaitForSingleObject(doneEvent, BUFFER_MS);
+            continue;
+        }
+
+        const size_t copied = std::min(count, device.capacity - device.filled);
+        std::memcpy(device.samples[device.current].data() + device.filled, samples, copied * sizeof(int16_t));
+        device.filled += copied;
+        samples += copied;
+        count -= copied;
+
+        if (device.filled == device.capacity && !SubmitCurrent()) {
+            return false;
+        }
+    }
+    return true;
+#else
+    wxUnusedVar(samples);
+    wxUnusedVar(count);
+    wxUnusedVar(generation);
+    return false;
+#endif
+}
+
+void AudioStream::Flush(uint64_t generation)
+{
+    std::lock_guard<std::mutex> lock(m_deviceMutex);
+#ifdef __WXMSW__
+    if (m_device && m_generation.load() == generation && m_device->filled > 0) {
+        SubmitCurrent();
+    }
+#else
+    wxUnusedVar(generation);
+#endif
+}
+
+void AudioStream::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_deviceMutex);
+    m_generation++;
+    if (!m_device) {
+        return;
+    }
+
+#ifdef __WXMSW__
+    // Returns every queued buffer at once, playback stops mid-buffer
+    ::waveOutReset(m_device->handle);
+    m_device->filled = 0;
+    ::SetEvent(m_device->doneEvent);
+#endif
+}
+
+bool AudioStream::SubmitCurrent()
+{
+#ifdef __WXMSW__
+    Device& device = *m_device;
+    WAVEHDR& header = device.headers[device.current];
+    header.dwBufferLength = static_cast<DWORD>(device.filled * sizeof(int16_t));
+    MMRESULT result = ::waveOutWrite(device.handle, &header, sizeof(WAVEHDR));
+
+    device.current = (device.current + 1) % BUFFER_COUNT;
+    device.filled = 0;
+    if (result != MMSYSERR_NOERROR) {
+        wxLogWarning("AudioStream: waveOutWrite failed (error %u)", static_cast<unsigned>(result));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
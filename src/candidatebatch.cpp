@@ -0,0 +1,14 @@
+#include "candidatebatch.h"
+
+void CandidateBatch::Clear()
+{
+    m_values.clear();
+    m_wordIds.clear();
+}
+
+size_t CandidateBatch::AddRow(uint32_t wordId)
+{
+    m_values.resize(m_values.size() + FEATURE_COUNT, 0.0f);
+    m_wordIds.push_back(wordId);
+    return m_wordIds.size() - 1;
+}
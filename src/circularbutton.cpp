@@ -5,7 +5,6 @@ CircularButton::CircularButton(const wxString& label, const wxPoint& position)
     : m_label(label)
     , m_position(position)
     , m_size(120, 120)  // Default size from EyeButton
-    , m_progress(0.0f)
     , m_isSelected(false)
 {
 }
@@ -33,7 +32,7 @@ void CircularButton::Draw(wxDC& dc, const wxColour& color)
     dc.DrawCircle(m_position, m_size.GetWidth() / 2);
 
     // Draw progress arc (like EyeButton line 34-37)
-    if (m_progress > 0.0f) {
+    if (m_progress.Get() > 0.0f) {
         dc.SetPen(wxPen(color, 6));
 
         int reduce = 4;  // Arc is slightly inside the circle
@@ -43,7 +42,7 @@ void CircularButton::Draw(wxDC& dc, const wxColour& color)
         int arcHeight = m_size.GetHeight() - 2 * reduce;
 
         // Convert progress (0-1) to arc angle in degrees
-        double arcAngle = m_progress * 360.0;
+        double arcAngle = m_progress.Get() * 360.0;
 
         // wxWidgets DrawEllipticArc: (x, y, width, height, start_angle, end_angle)
         // Arc starts at 0° (3 o'clock) and goes counter-clockwise
@@ -73,31 +72,27 @@ bool CircularButton::UpdateProgress(float deltaTime, float holdTime)
     // Convert holdTime to microseconds
     float holdTimeUs = holdTime * 1000.0f;
 
-    float oldProgress = m_progress;
-    m_progress += deltaTime / holdTimeUs;
+    // Only triggers refresh if progress changed by at least 5% (reduces refresh rate)
+    bool changed = m_progress.Advance(deltaTime, holdTimeUs);
 
-    if (m_progress >= 1.0f) {
-        m_progress = 0.0f;
+    if (m_progress.IsComplete()) {
+        m_progress.Reset();
         if (OnActivated) {
             OnActivated();
         }
         return true;  // Button activated - visual state changed
     }
 
-    // Only trigger refresh if progress changed by at least 5% (reduces refresh rate)
-    return (static_cast<int>(m_progress * 20) != static_cast<int>(oldProgress * 20));
+    return changed;
 }
 
 bool CircularButton::ResetProgress()
 {
-    if (m_progress > 0.0f) {
-        m_progress = 0.0f;
-        return true;  // Visual state changed (progress was reset)
-    }
-    return false;  // Progress was already 0
+    // Returns false if progress was already 0
+    return m_progress.Reset();
 }
 
 bool CircularButton::IsActivated() const
 {
-    return m_progress >= 1.0f;
+    return m_progress.IsComplete();
 }
@@ -0,0 +1,326 @@
+#include "dtwengine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DTW_KERNEL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DTW_KERNEL_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DTW_KERNEL_NEON
+#endif
+
+const float DtwEngine::INF = 1e12f;
+
+// Lower bounds are sums in a different order than the DP, keep a margin
+// for float rounding so they never exceed the true distance
+static const float LB_MARGIN = 1.0f - 1e-5f;
+
+namespace {
+
+// Minimal vector abstraction: the kernel is written once against it
+#if defined(DTW_KERNEL_AVX2)
+struct Simd {
+    typedef __m256 V;
+    static const int WIDTH = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V sqrt(V a) { return _mm256_sqrt_ps(a); }
+    static float hmin(V a)
+    {
+        __m128 v = _mm_min_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+        v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+};
+#elif defined(DTW_KERNEL_SSE2)
+struct Simd {
+    typedef __m128 V;
+    static const int WIDTH = 4;
+    static V load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V add(V a, V b) { return _mm_add_ps(a, b); }
+    static V min(V a, V b) { return _mm_min_ps(a, b); }
+    static V sqrt(V a) { return _mm_sqrt_ps(a); }
+    static float hmin(V a)
+    {
+        V v = _mm_min_ps(a, _mm_movehl_ps(a, a));
+        v = _mm_min_ss(v, _mm_shuffle_ps(v, v, 1));
+        return _mm_cvtss_f32(v);
+    }
+};
+#elif defined(DTW_KERNEL_NEON)
+struct Simd {
+    typedef float32x4_t V;
+    static const int WIDTH = 4;
+    static V load(const float* p) { return vld1q_f32(p); }
+    static void store(float* p, V v) { vst1q_f32(p, v); }
+    static V sub(V a, V b) { return vsubq_f32(a, b); }
+    static V mul(V a, V b) { return vmulq_f32(a, b); }
+    static V add(V a, V b) { return vaddq_f32(a, b); }
+    static V min(V a, V b) { return vminq_f32(a, b); }
+    static V sqrt(V a) { return vsqrtq_f32(a); }
+    static float hmin(V a) { return vminvq_f32(a); }
+};
+#else
+struct Simd {
+    typedef float V;
+    static const int WIDTH = 1;
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V add(V a, V b) { return a + b; }
+    static V min(V a, V b) { return std::min(a, b); }
+    static V sqrt(V a) { return std::sqrt(a); }
+    static float hmin(V a) { return a; }
+};
+#endif
+
+const int W = Simd::WIDTH;
+
+inline float point_cost(float ax, float ay, float bx, float by) {
+    float dx = ax - bx;
+    float dy = ay - by;
+    return std::sqrt(dx*dx + dy*dy);
+}
+
+// Floor division for possibly negative numerators
+inline int floor_div2(int value) {
+    return (value >= 0) ? value / 2 : -((1 - value) / 2);
+}
+
+} // namespace
+
+DtwEngine::DtwEngine()
+    : m_queryLength(0)
+    , m_window(-1)
+{
+}
+
+const char* DtwEngine::GetKernelName()
+{
+#if defined(DTW_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(DTW_KERNEL_SSE2)
+    return "SSE2";
+#elif defined(DTW_KERNEL_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void DtwEngine::SetQuery(const std::vector<std::pair<float, float>>& query, int window)
+{
+    m_queryLength = query.size();
+    m_window = window;
+
+    // Padding: the last vector of a diagonal reads up to W - 1 points past the end
+    m_queryX.assign(m_queryLength + W, 0.0f);
+    m_queryY.assign(m_queryLength + W, 0.0f);
+    for (size_t i = 0; i < m_queryLength; ++i) {
+        m_queryX[i] = query[i].first;
+        m_queryY[i] = query[i].second;
+    }
+
+    m_envelopes.clear();
+}
+
+int DtwEngine::GetBand(int m) const
+{
+    const int n = static_cast<int>(m_queryLength);
+    int window = (m_window < 0) ? std::max(n, m) : m_window;
+    return std::max(window, std::abs(n - m));
+}
+
+float DtwEngine::LowerBoundKim(const float* path, int m) const
+{
+    const int n = static_cast<int>(m_queryLength);
+    if (n == 0 || m == 0) {
+        return 0.0f;
+    }
+
+    // Every warping path starts at (1, 1) and ends at (n, m)
+    float bound = point_cost(m_queryX[0], m_queryY[0], path[0], path[1]);
+    if (n > 1 || m > 1) {
+        bound += point_cost(m_queryX[n - 1], m_queryY[n - 1], path[2 * (m - 1)], path[2 * (m - 1) + 1]);
+    }
+    return bound * LB_MARGIN;
+}
+
+const std::vector<float>& DtwEngine::GetEnvelope(int m)
+{
+    if (static_cast<int>(m_envelopes.size()) <= m) {
+        m_envelopes.resize(m + 1);
+    }
+
+    std::vector<float>& envelope = m_envelopes[m];
+    if (!envelope.empty()) {
+        return envelope;
+    }
+
+    // Column j is visited by at least one row of the band [j - w, j + w]
+    const int n = static_cast<int>(m_queryLength);
+    const int band = GetBand(m);
+    envelope.resize(4 * static_cast<size_t>(m));
+    for (int j = 1; j <= m; ++j) {
+        int first = std::max(1, j - band);
+        int last = std::min(n, j + band);
+        float minX = INF, maxX = -INF, minY = INF, maxY = -INF;
+        for (int i = first; i <= last; ++i) {
+            minX = std::min(minX, m_queryX[i - 1]);
+            maxX = std::max(maxX, m_queryX[i - 1]);
+            minY = std::min(minY, m_queryY[i - 1]);
+            maxY = std::max(maxY, m_queryY[i - 1]);
+        }
+        float* box = &envelope[4 * (j - 1)];
+        box[0] = minX;
+        box[1] = maxX;
+        box[2] = minY;
+        box[3] = maxY;
+    }
+    return envelope;
+}
+
+float DtwEngine::LowerBoundKeogh(const float* path, int m)
+{
+    if (m_queryLength == 0 || m == 0) {
+        return 0.0f;
+    }
+
+    const std::vector<float>& envelope = GetEnvelope(m);
+    float bound = 0.0f;
+    for (int j = 0; j < m; ++j) {
+        const float* box = &envelope[4 * j];
+        float x = path[2 * j];
+        float y = path[2 * j + 1];
+        float dx = std::max(0.0f, std::max(box[0] - x, x - box[1]));
+        float dy = std::max(0.0f, std::max(box[2] - y, y - box[3]));
+        bound += std::sqrt(dx*dx + dy*dy);
+    }
+    return bound * LB_MARGIN;
+}
+
+float DtwEngine::Distance(const float* path, int m, float threshold)
+{
+    const int n = static_cast<int>(m_queryLength);
+    if (n == 0 || m == 0) {
+        m_stats.computed++;
+        return 0.0f;
+    }
+
+    const int band = GetBand(m);
+    const bool abandon = threshold < INF;
+
+    // Path reversed so the points of one anti-diagonal are contiguous:
+    // cell (i, d - i) uses path point d - i - 1 = reversed index i + m - d
+    m_pathX.assign(m + 2 * W, 0.0f);
+    m_pathY.assign(m + 2 * W, 0.0f);
+    for (int k = 0; k < m; ++k) {
+        m_pathX[W + k] = path[2 * (m - 1 - k)];
+        m_pathY[W + k] = path[2 * (m - 1 - k) + 1];
+    }
+
+    // Anti-diagonal d holds cells (i, d - i) indexed by i
+    const size_t diagonalSize = n + 2 + W;
+    for (std::vector<float>& diagonal : m_diagonals) {
+        if (diagonal.size() < diagonalSize) {
+            diagonal.resize(diagonalSize, INF);
+        }
+    }
+    float* prev2 = m_diagonals[0].data();
+    float* prev = m_diagonals[1].data();
+    float* cur = m_diagonals[2].data();
+
+    // d = 0: the origin. d = 1: only boundary cells (i = 0 or j = 0).
+    prev2[0] = 0.0f;
+    prev2[1] = INF;
+    prev[0] = INF;
+    prev[1] = INF;
+
+    const float* qx = m_queryX.data();
+    const float* qy = m_queryY.data();
+    float prevMin = INF;
+
+    for (int d = 2; d <= n + m; ++d) {
+        // Valid rows: inside the matrix and inside the band |i - j| <= band
+        const int lo = std::max(std::max(1, d - m), -floor_div2(band - d));
+        const int hi = std::min(std::min(n, d - 1), floor_div2(d + band));
+
+        const float* px = m_pathX.data() + W + m - d;
+        const float* py = m_pathY.data() + W + m - d;
+
+        // Lanes past hi compute garbage that is overwritten or never read
+        for (int i = lo; i <= hi; i += W) {
+            Simd::V dx = Simd::sub(Simd::load(qx + i - 1), Simd::load(px + i));
+            Simd::V dy = Simd::sub(Simd::load(qy + i - 1), Simd::load(py + i));
+            Simd::V cost = Simd::sqrt(Simd::add(Simd::mul(dx, dx), Simd::mul(dy, dy)));
+
+            // Same order as the row DP: min(min(up, left), diagonal)
+            Simd::V best = Simd::min(Simd::load(prev + i - 1), Simd::load(prev + i));
+            best = Simd::min(best, Simd::load(prev2 + i - 1));
+            Simd::store(cur + i, Simd::add(cost, best));
+        }
+
+        // Cells just outside the valid range are read by the next two diagonals
+        cur[lo - 1] = INF;
+        cur[hi + 1] = INF;
+
+        if (abandon) {
+            // Overwrite the garbage lanes so the minimum can use full vectors
+            for (int i = hi + 2; i <= hi + W; ++i) {
+                cur[i] = INF;
+            }
+            float curMin = INF;
+            if (lo <= hi) {
+                Simd::V lanes = Simd::load(cur + lo);
+                for (int i = lo + W; i <= hi; i += W) {
+                    lanes = Simd::min(lanes, Simd::load(cur + i));
+                }
+                curMin = Simd::hmin(lanes);
+            }
+
+            // A warping path crosses one of any two consecutive anti-diagonals
+            if (std::min(curMin, prevMin) > threshold) {
+                m_stats.abandoned++;
+                return INF;
+            }
+            prevMin = curMin;
+        }
+
+        float* recycled = prev2;
+        prev2 = prev;
+        prev = cur;
+        cur = recycled;
+    }
+
+    m_stats.computed++;
+    return prev[n];
+}
+
+float DtwEngine::DistanceIfBelow(const float* path, int m, float threshold)
+{
+    if (threshold < INF) {
+        if (LowerBoundKim(path, m) > threshold) {
+            m_stats.prunedKim++;
+            return INF;
+        }
+        if (LowerBoundKeogh(path, m) > threshold) {
+            m_stats.prunedKeogh++;
+            return INF;
+        }
+    }
+    return Distance(path, m, threshold);
+}
@@ -0,0 +1,55 @@
+#include "dtwprefixcache.h"
+#include "dtwengine.h"
+#include <algorithm>
+#include <cmath>
+
+void DtwPrefixCache::Reset()
+{
+    m_swipe.clear();
+    m_entries.clear();
+}
+
+void DtwPrefixCache::Prepare(const std::vector<std::pair<float, float>>& swipe)
+{
+    const bool extends = swipe.size() >= m_swipe.size() &&
+                         std::equal(m_swipe.begin(), m_swipe.end(), swipe.begin());
+    if (!extends) {
+        Reset();
+    }
+    m_swipe = swipe;
+}
+
+float DtwPrefixCache::Extend(Entry& entry, const std::vector<std::pair<float, float>>& swipe, const float* path, int m)
+{
+    const size_t n = swipe.size();
+    if (n == 0 || m == 0) {
+        return 0.0f;
+    }
+
+    // Row 0 of the DP: only the origin is reachable
+    if (entry.row.size() != static_cast<size_t>(m) + 1 || entry.points > n) {
+        entry.row.assign(m + 1, DtwEngine::INF);
+        entry.row[0] = 0.0f;
+        entry.points = 0;
+    }
+
+    // Same cell order and operations as dtw_multivariate() without a band
+    std::vector<float>& prev_row = entry.row;
+    std::vector<float> curr_row(m + 1);
+    for (size_t i = entry.points; i < n; ++i) {
+        curr_row[0] = DtwEngine::INF;
+        for (int j = 1; j <= m; ++j) {
+            float dx = swipe[i].first - path[2*(j-1)];
+            float dy = swipe[i].second - path[2*(j-1) + 1];
+            float cost = std::sqrt(dx*dx + dy*dy);
+
+            float min_val = std::min(prev_row[j], curr_row[j-1]);
+            min_val = std::min(min_val, prev_row[j-1]);
+            curr_row[j] = cost + min_val;
+        }
+        std::swap(prev_row, curr_row);
+    }
+    entry.points = n;
+
+    return prev_row[m];
+}
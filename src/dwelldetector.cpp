@@ -0,0 +1,155 @@
+#include "dwelldetector.h"
+#include <initializer_list>
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+DwellDetector::DwellDetector(size_t capacity)
+    : m_samples(round_up_pow2(capacity < 4 ? 4 : capacity))
+    , m_mask(m_samples.size() - 1)
+    , m_begin(0)
+    , m_end(0)
+    , m_windowUs(800000)
+    , m_radius(30.0f)
+{
+    for (MonotonicQueue* q : {&m_minX, &m_maxX, &m_minY, &m_maxY}) {
+        q->seq.resize(m_samples.size());
+        QueueReset(*q);
+    }
+}
+
+size_t DwellDetector::CapacityFor(uint64_t windowUs, float sampleRateHz) {
+    // +25% for timestamp jitter and rate bursts
+    double samples = static_cast<double>(windowUs) / 1e6 * sampleRateHz * 1.25 + 4.0;
+    return static_cast<size_t>(samples);
+}
+
+void DwellDetector::QueueReset(MonotonicQueue& q) {
+    q.head = 0;
+    q.tail = 0;
+}
+
+template <typename Compare>
+void DwellDetector::QueuePush(MonotonicQueue& q, uint64_t seq, float value, float Sample::*axis, Compare dominated) {
+    // Drop entries that can never be the extremum again
+    while (q.tail != q.head && dominated(At(q.seq[(q.tail - 1) & m_mask]).*axis, value)) {
+        --q.tail;
+    }
+    q.seq[q.tail & m_mask] = seq;
+    ++q.tail;
+}
+
+void DwellDetector::QueueExpire(MonotonicQueue& q) {
+    while (q.tail != q.head && q.seq[q.head & m_mask] < m_begin) {
+        ++q.head;
+    }
+}
+
+void DwellDetector::EvictOldest() {
+    ++m_begin;
+    QueueExpire(m_minX);
+    QueueExpire(m_maxX);
+    QueueExpire(m_minY);
+    QueueExpire(m_maxY);
+}
+
+void DwellDetector::Grow() {
+    // Slots are sequence numbers masked, re-place every live entry under the new mask
+    const size_t capacity = m_samples.size() * 2;
+    const size_t mask = capacity - 1;
+
+    std::vector<Sample> samples(capacity);
+    for (uint64_t seq = m_begin; seq < m_end; ++seq) {
+        samples[seq & mask] = At(seq);
+    }
+    for (MonotonicQueue* q : {&m_minX, &m_maxX, &m_minY, &m_maxY}) {
+        std::vector<uint64_t> entries(capacity);
+        for (uint64_t i = q->head; i < q->tail; ++i) {
+            entries[i & mask] = q->seq[i & m_mask];
+        }
+        q->seq.swap(entries);
+    }
+    m_samples.swap(samples);
+    m_mask = mask;
+}
+
+void DwellDetector::AddSample(float x, float y, uint64_t timestamp) {
+    // Ring full: evict the oldest sample if it leaves the window with this
+    // one, otherwise the window needs more room
+    if (GetSampleCount() == m_samples.size()) {
+        if (timestamp - At(m_begin).timestamp >= m_windowUs) {
+            EvictOldest();
+        } else {
+            Grow();
+        }
+    }
+
+    const uint64_t seq = m_end++;
+    Sample& sample = m_samples[seq & m_mask];
+    sample.x = x;
+    sample.y = y;
+    sample.timestamp = timestamp;
+
+    QueuePush(m_minX, seq, x, &Sample::x, [](float back, float v) { return back >= v; });
+    QueuePush(m_maxX, seq, x, &Sample::x, [](float back, float v) { return back <= v; });
+    QueuePush(m_minY, seq, y, &Sample::y, [](float back, float v) { return back >= v; });
+    QueuePush(m_maxY, seq, y, &Sample::y, [](float back, float v) { return back <= v; });
+
+    // Remove samples older than the window (the newest one always stays)
+    while (m_begin < m_end && (timestamp - At(m_begin).timestamp) >= m_windowUs) {
+        EvictOldest();
+    }
+}
+
+float DwellDetector::GetMinX() const { return At(m_minX.seq[m_minX.head & m_mask]).x; }
+float DwellDetector::GetMaxX() const { return At(m_maxX.seq[m_maxX.head & m_mask]).x; }
+float DwellDetector::GetMinY() const { return At(m_minY.seq[m_minY.head & m_mask]).y; }
+float DwellDetector::GetMaxY() const { return At(m_maxY.seq[m_maxY.head & m_mask]).y; }
+
+bool DwellDetector::IsStable() const {
+    if (GetSampleCount() <= 2) {
+        return false;
+    }
+    return (GetMaxX() - GetMinX()) < m_radius && (GetMaxY() - GetMinY()) < m_radius;
+}
+
+uint64_t DwellDetector::GetLastDelta() const {
+    if (GetSampleCount() < 2) {
+        return 0;
+    }
+    return At(m_end - 1).timestamp - At(m_end - 2).timestamp;
+}
+
+void DwellDetector::Reset() {
+    m_begin = 0;
+    m_end = 0;
+    QueueReset(m_minX);
+    QueueReset(m_maxX);
+    QueueReset(m_minY);
+    QueueReset(m_maxY);
+}
+
+bool DwellProgress::Advance(float elapsed, float hold) {
+    float oldProgress = m_progress;
+    m_progress += elapsed / hold;
+
+    if (m_progress >= 1.0f) {
+        return true;
+    }
+
+    // Only report a change every 5% (reduces refresh rate)
+    return static_cast<int>(m_progress * 20) != static_cast<int>(oldProgress * 20);
+}
+
+bool DwellProgress::Reset() {
+    if (m_progress > 0.0f) {
+        m_progress = 0.0f;
+        return true;
+    }
+    return false;
+}
@@ -3,15 +3,21 @@
 
 #ifdef USE_ESPEAK
 #include "espeak-ng/speak_lib.h"
-#include <wx/sound.h>
-#include <wx/file.h>
-#include <wx/filename.h>
-#include <wx/stdpaths.h>
 #endif
 
+// Length of the PCM chunks espeak hands to the callback: the first one is
+// queued to the audio device about this long after Speak()
+#define SYNTH_BUFFER_MS 20
+
 ESpeakEngine::ESpeakEngine()
     : m_initialized(false)
+    , m_streamOutput(false)
     , m_sampleRate(22050)
+    , m_hasPendingText(false)
+    , m_stopWorker(false)
+    , m_generation(0)
+    , m_synthGeneration(0)
+    , m_streamGeneration(0)
 {
 }
 
@@ -35,11 +41,14 @@ bool ESpeakEngine::Initialize(const wxString& espeakDataPath)
     const char* dataPath = pathBuffer.data();
 
     // Initialize espeak-ng
-    // AUDIO_OUTPUT_RETRIEVAL: We handle audio output ourselves
-    // buflength=0: Use default buffer
+    // AUDIO_OUTPUT_SYNCHRONOUS: chunks are handed to SynthCallback on the
+    // speech worker, which streams them to the audio device. Without a
+    // streaming backend espeak plays the audio itself (AUDIO_OUTPUT_PLAYBACK).
     // options: 1 = espeakINITIALIZE_PHONEME_EVENTS (not used but safe)
+    m_streamOutput = AudioStream::IsSupported();
     unsigned int options = 0;
-    int samplingRate = espeak_Initialize(AUDIO_OUTPUT_RETRIEVAL, 0, dataPath, options);
+    int samplingRate = espeak_Initialize(m_streamOutput ? AUDIO_OUTPUT_SYNCHRONOUS : AUDIO_OUTPUT_PLAYBACK,
+                                         SYNTH_BUFFER_MS, dataPath, options);
 
     if (samplingRate < 0) {
         wxLogError("ESpeakEngine: Failed to initialize espeak (error %d)", samplingRate);
@@ -47,7 +56,13 @@ bool ESpeakEngine::Initialize(const wxString& espeakDataPath)
     }
 
     m_sampleRate = samplingRate;
-    wxLogMessage("ESpeakEngine: Initialized with sample rate %d Hz", m_sampleRate);
+    if (m_streamOutput && !m_audioStream.Open(m_sampleRate)) {
+        wxLogError("ESpeakEngine: No audio output device");
+        espeak_Terminate();
+        return false;
+    }
+    wxLogMessage("ESpeakEngine: Initialized with sample rate %d Hz (%s)", m_sampleRate,
+                 m_streamOutput ? "streamed to waveOut" : "espeak audio output");
 
     // Set synthesis callback
     // Cast to the correct function pointer type expected by espeak
@@ -68,6 +83,9 @@ bool ESpeakEngine::Initialize(const wxString& espeakDataPath)
     espeak_SetParameter(espeakPITCH, 50, 0);  // Default pitch
     espeak_SetParameter(espeakVOLUME, 100, 0); // Default volume
 
+    m_stopWorker = false;
+    m_speechThread = std::thread(&ESpeakEngine::SpeechWorkerLoop, this);
+
     m_initialized = true;
     return true;
 #else
@@ -79,15 +97,36 @@ bool ESpeakEngine::Initialize(const wxString& espeakDataPath)
 void ESpeakEngine::Shutdown()
 {
 #ifdef USE_ESPEAK
+    if (!m_initialized) {
+        return;
+    }
+
+    // The worker holds m_espeakLock while it synthesizes
+    StopSpeechWorker();
+
     std::lock_guard<std::mutex> lock(m_espeakLock);
+    espeak_Cancel();
+    espeak_Terminate();
+    m_audioStream.Close();
+    m_initialized = false;
+    wxLogMessage("ESpeakEngine: Shut down");
+#endif
+}
 
-    if (m_initialized) {
-        espeak_Cancel();
-        espeak_Terminate();
-        m_initialized = false;
-        wxLogMessage("ESpeakEngine: Shut down");
+void ESpeakEngine::StopSpeechWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestLock);
+        m_stopWorker = true;
+        m_hasPendingText = false;
+        m_generation++;
+        m_audioStream.Reset();
+    }
+    m_requestCondition.notify_one();
+
+    if (m_speechThread.joinable()) {
+        m_speechThread.join();
     }
-#endif
 }
 
 void ESpeakEngine::Speak(const wxString& text)
@@ -103,38 +142,22 @@ void ESpeakEngine::Speak(const wxString& text)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(m_espeakLock);
-
-    // Clear previous audio data
-    {
-        std::lock_guard<std::mutex> audioLock(m_audioLock);
-        m_audioData.clear();
+    // A new phrase replaces the one being spoken. Playback is cut before the
+    // worker can pick up the text, so the new phrase itself is never cut.
+    if (!m_streamOutput) {
+        std::lock_guard<std::mutex> lock(m_espeakLock);
+        espeak_Cancel();
     }
-
-    // Convert text to UTF-8 encoding
-    wxCharBuffer textBuffer = text.ToUTF8();
-    const char* utf8Text = textBuffer.data();
-    size_t textLength = strlen(utf8Text);
-
-    // Synthesize speech
-    int result = espeak_Synth(
-        utf8Text,
-        textLength + 1,
-        0,
-        POS_SENTENCE,
-        0,
-        espeakCHARS_UTF8,
-        NULL,
-        this
-    );
-
-    if (result != EE_OK) {
-        wxLogError("ESpeakEngine: espeak_Synth failed with error %d", result);
-        return;
+    {
+        std::lock_guard<std::mutex> lock(m_requestLock);
+        m_generation++;
+        m_audioStream.Reset();
+        m_pendingText = std::string(text.ToUTF8());
+        m_hasPendingText = true;
     }
-
-    // Wait for synthesis to complete
-    espeak_Synchronize();
+    m_requestCondition.notify_one();
+#else
+    wxUnusedVar(text);
 #endif
 }
 
@@ -145,12 +168,61 @@ void ESpeakEngine::Stop()
         return;
     }
 
-    std::lock_guard<std::mutex> lock(m_espeakLock);
-    espeak_Cancel();
+    // The synthesis in progress aborts on its next chunk (SynthCallback)
+    {
+        std::lock_guard<std::mutex> lock(m_requestLock);
+        m_generation++;
+        m_hasPendingText = false;
+        m_audioStream.Reset();
+    }
+
+    if (!m_streamOutput) {
+        std::lock_guard<std::mutex> lock(m_espeakLock);
+        espeak_Cancel();
+    }
+#endif
+}
+
+void ESpeakEngine::SpeechWorkerLoop()
+{
+#ifdef USE_ESPEAK
+    for (;;) {
+        std::string text;
+        {
+            std::unique_lock<std::mutex> lock(m_requestLock);
+            m_requestCondition.wait(lock, [this] { return m_stopWorker || m_hasPendingText; });
+            if (m_stopWorker) {
+                return;
+            }
+            text.swap(m_pendingText);
+            m_hasPendingText = false;
+            m_synthGeneration = m_generation.load();
+            // Reset() is only called under m_requestLock, so a cancel after
+            // this point is seen by every later Write/Flush of the utterance
+            m_streamGeneration = m_audioStream.GetGeneration();
+        }
+
+        std::lock_guard<std::mutex> lock(m_espeakLock);
+
+        // Returns when the synthesis is complete or aborted by the callback
+        // (playback mode: when espeak has queued it)
+        int result = espeak_Synth(
+            text.c_str(),
+            text.size() + 1,
+            0,
+            POS_SENTENCE,
+            0,
+            espeakCHARS_UTF8,
+            NULL,
+            this
+        );
 
-    // Clear audio buffer
-    std::lock_guard<std::mutex> audioLock(m_audioLock);
-    m_audioData.clear();
+        if (result != EE_OK) {
+            wxLogError("ESpeakEngine: espeak_Synth failed with error %d", result);
+        } else if (m_streamOutput && m_synthGeneration == m_generation.load()) {
+            m_audioStream.Flush(m_streamGeneration);
+        }
+    }
 #endif
 }
 
@@ -216,93 +288,25 @@ int ESpeakEngine::SynthCallback(short *wav, int numsamples, void* eventsPtr)
 
     if (events && events->user_data) {
         ESpeakEngine* engine = static_cast<ESpeakEngine*>(events->user_data);
-        engine->HandleSynthCallback(wav, numsamples);
+        return engine->HandleSynthCallback(wav, numsamples);
     }
 #endif
 
     return 0;
 }
 
-void ESpeakEngine::HandleSynthCallback(short *wav, int numsamples)
+int ESpeakEngine::HandleSynthCallback(short *wav, int numsamples)
 {
-#ifdef USE_ESPEAK
-    if (wav == nullptr || numsamples == 0) {
-        // Synthesis complete - play accumulated audio
-        PlayAudio();
-        return;
+    // Stop() or a newer Speak(): abort the rest of this synthesis
+    if (m_synthGeneration != m_generation.load()) {
+        return 1;
     }
 
-    // Append audio samples to buffer
-    std::lock_guard<std::mutex> lock(m_audioLock);
-    const char* wavBytes = reinterpret_cast<const char*>(wav);
-    size_t bytesToAdd = numsamples * 2;
-    m_audioData.insert(m_audioData.end(), wavBytes, wavBytes + bytesToAdd);
-#endif
-}
-
-void ESpeakEngine::PlayAudio()
-{
-#ifdef USE_ESPEAK
-    std::lock_guard<std::mutex> lock(m_audioLock);
-
-    if (m_audioData.empty()) {
-        return;
+    if (!m_streamOutput || wav == nullptr || numsamples <= 0) {
+        return 0;
     }
 
-    // Create WAV header for PCM audio data
-    struct WAVHeader {
-        char riff[4];           // "RIFF"
-        uint32_t fileSize;      // File size - 8 bytes
-        char wave[4];           // "WAVE"
-        char fmt[4];            // "fmt "
-        uint32_t fmtSize;       // Size of fmt chunk (16 for PCM)
-        uint16_t audioFormat;   // 1 = PCM
-        uint16_t numChannels;   // 1 = mono
-        uint32_t sampleRate;    // Sample rate
-        uint32_t byteRate;      // sampleRate * numChannels * bitsPerSample/8
-        uint16_t blockAlign;    // numChannels * bitsPerSample/8
-        uint16_t bitsPerSample; // 16 bits
-        char data[4];           // "data"
-        uint32_t dataSize;      // Size of audio data
-    };
-
-    WAVHeader header;
-    memcpy(header.riff, "RIFF", 4);
-    header.fileSize = 36 + m_audioData.size();
-    memcpy(header.wave, "WAVE", 4);
-    memcpy(header.fmt, "fmt ", 4);
-    header.fmtSize = 16;
-    header.audioFormat = 1;
-    header.numChannels = 1;
-    header.sampleRate = m_sampleRate;
-    header.bitsPerSample = 16;
-    header.byteRate = m_sampleRate * header.numChannels * header.bitsPerSample / 8;
-    header.blockAlign = header.numChannels * header.bitsPerSample / 8;
-    memcpy(header.data, "data", 4);
-    header.dataSize = m_audioData.size();
-
-    // Combine header and audio data
-    m_wavData.clear();
-    m_wavData.reserve(sizeof(WAVHeader) + m_audioData.size());
-    const char* headerBytes = reinterpret_cast<const char*>(&header);
-    m_wavData.insert(m_wavData.end(), headerBytes, headerBytes + sizeof(WAVHeader));
-    m_wavData.insert(m_wavData.end(), m_audioData.begin(), m_audioData.end());
-
-    // Write to temporary file for async playback
-    // wxSound on Windows requires a file path for async playback
-    wxString tempDir = wxStandardPaths::Get().GetTempDir();
-    wxString tempFile = tempDir + wxFILE_SEP_PATH + "espeak_temp.wav";
-
-    wxFile file;
-    if (file.Create(tempFile, true)) {
-        file.Write(m_wavData.data(), m_wavData.size());
-        file.Close();
-
-        // Play asynchronously (non-blocking)
-        wxSound sound(tempFile);
-        if (sound.IsOk()) {
-            sound.Play(wxSOUND_ASYNC);
-        }
-    }
-#endif
+    // Blocks while the device queue is full, fails when playback was reset
+    return m_audioStream.Write(reinterpret_cast<const int16_t*>(wav), static_cast<size_t>(numsamples),
+                               m_streamGeneration) ? 0 : 1;
 }
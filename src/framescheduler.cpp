@@ -0,0 +1,176 @@
+#include "framescheduler.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#include <dwmapi.h>
+#endif
+
+wxDEFINE_EVENT(wxEVT_FRAME_TICK, wxThreadEvent);
+
+// Weight of the newest sample in the moving averages
+static const double STATS_SMOOTHING = 0.05;
+
+static int64_t steady_now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void update_average(double& average, double value) {
+    average = (average == 0.0) ? value : average + STATS_SMOOTHING * (value - average);
+}
+
+FrameScheduler::FrameScheduler(wxEvtHandler* target)
+    : m_target(target)
+    , m_running(false)
+    , m_framePending(false)
+    , m_tickInFlight(false)
+    , m_fallbackRateHz(60)
+    , m_requestsCoalesced(0)
+    , m_lastFrameStartUs(0)
+    , m_frameStartUs(0)
+{
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    Stop();
+}
+
+void FrameScheduler::Start()
+{
+    if (m_running.exchange(true)) {
+        return;
+    }
+
+    m_tickInFlight = false;
+    m_thread = std::thread(&FrameScheduler::ThreadLoop, this);
+}
+
+void FrameScheduler::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running.exchange(false)) {
+            return;
+        }
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void FrameScheduler::SetFallbackRate(int hz)
+{
+    m_fallbackRateHz = std::max(1, hz);
+}
+
+void FrameScheduler::RequestFrame()
+{
+    if (m_framePending.exchange(true)) {
+        // Already waiting for the next vblank, this change rides along
+        m_requestsCoalesced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_one();
+}
+
+void FrameScheduler::BeginFrame()
+{
+    m_framePending = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tickInFlight = false;
+    }
+    m_condition.notify_one();
+
+    m_frameStartUs = steady_now_us();
+}
+
+void FrameScheduler::EndFrame(bool rendered)
+{
+    if (!rendered) {
+        m_stats.framesSkipped++;
+        return;
+    }
+
+    int64_t now = steady_now_us();
+    double renderMs = (now - m_frameStartUs) / 1000.0;
+    m_stats.lastRenderMs = renderMs;
+    m_stats.maxRenderMs = std::max(m_stats.maxRenderMs, renderMs);
+    update_average(m_stats.averageRenderMs, renderMs);
+
+    if (m_lastFrameStartUs > 0) {
+        double intervalMs = (m_frameStartUs - m_lastFrameStartUs) / 1000.0;
+        m_stats.lastIntervalMs = intervalMs;
+        m_stats.maxIntervalMs = std::max(m_stats.maxIntervalMs, intervalMs);
+        update_average(m_stats.averageIntervalMs, intervalMs);
+    }
+    m_lastFrameStartUs = m_frameStartUs;
+    m_stats.framesRendered++;
+}
+
+FrameStats FrameScheduler::GetStats() const
+{
+    FrameStats stats = m_stats;
+    stats.requestsCoalesced = m_requestsCoalesced.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void FrameScheduler::ResetStats()
+{
+    m_stats = FrameStats();
+    m_requestsCoalesced = 0;
+    m_lastFrameStartUs = 0;
+}
+
+void FrameScheduler::WaitForVBlank()
+{
+#ifdef __WXMSW__
+    // Blocks until the compositor presented the next frame
+    if (SUCCEEDED(::DwmFlush())) {
+        return;
+    }
+#endif
+
+    // No compositor: sleep until the next tick boundary of the nominal rate
+    const int64_t periodUs = 1000000 / m_fallbackRateHz.load();
+    int64_t now = steady_now_us();
+    int64_t next = (now / periodUs + 1) * periodUs;
+    std::this_thread::sleep_for(std::chrono::microseconds(next - now));
+}
+
+void FrameScheduler::ThreadLoop()
+{
+    while (m_running) {
+        {
+            // Sleep until a frame is wanted and the previous tick was consumed
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() {
+                return !m_running || (m_framePending && !m_tickInFlight);
+            });
+            if (!m_running) {
+                break;
+            }
+        }
+
+        WaitForVBlank();
+
+        if (!m_running) {
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tickInFlight = true;
+        }
+        wxQueueEvent(m_target, new wxThreadEvent(wxEVT_FRAME_TICK));
+    }
+}
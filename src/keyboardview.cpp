@@ -1,4 +1,5 @@
 #include "keyboardview.h"
+#include "trace.h"
 #include <wx/dcbuffer.h>
 #include <algorithm>
 #include <cmath>
@@ -20,15 +21,19 @@ KeyboardView::KeyboardView(wxWindow *parent)
     , m_enterKey(nullptr)
     , m_swipeToggleKey(nullptr)
     , m_speakKey(nullptr)
+    , m_layoutValid(false)
+    , m_keyboardOffsetX(0.0f)
     , m_shiftActive(false)
     , m_capsLockActive(false)
     , m_altgrActive(false)
     , m_gazePosition(0, 0)
     , m_currentHoveredKey(nullptr)
     , m_lastUpdateTime(wxGetLocalTimeMillis())
+    , m_lastTimestamp(0)
     , m_dwellTimeMs(800)
     , m_recordingSwipe(false)
     , m_previousGazePosition(0, 0)
+    , m_swipeProgressInterval(0)
     , m_normalColor(240, 240, 240)
     , m_hoverColor(102, 204, 255)
     , m_progressColor(0, 150, 255)
@@ -37,6 +42,8 @@ KeyboardView::KeyboardView(wxWindow *parent)
     , m_keySize(50.0f)  // Initial value, will be updated in UpdateKeyGeometries
     , OnLetterSelected(nullptr)
     , OnSwipeCompleted(nullptr)
+    , OnSwipeProgress(nullptr)
+    , OnSwipeCancelled(nullptr)
     , OnSpacePressed(nullptr)
     , OnBackspacePressed(nullptr)
     , OnDeleteWordPressed(nullptr)
@@ -76,7 +83,9 @@ void KeyboardView::SetSwipeEnabled(bool enabled)
 
         // Clear swipe state when disabling
         if (!m_swipeEnabled) {
-            m_recordingSwipe = false;
+            if (m_recordingSwipe) {
+                CancelSwipeRecording();
+            }
             ClearSwipePath();
         }
 
@@ -85,16 +94,26 @@ void KeyboardView::SetSwipeEnabled(bool enabled)
             m_swipeToggleKey->SetModifierActive(m_swipeEnabled);
         }
 
+        AddFullDamage();
         Refresh();
     }
 }
 
-void KeyboardView::UpdateGazePosition(float x, float y)
+void KeyboardView::UpdateGazePosition(float x, float y, uint64_t timestamp)
 {
+    TRACE_SCOPE("keyboard gaze");
     wxLongLong currentTime = wxGetLocalTimeMillis();
     float deltaMs = (currentTime - m_lastUpdateTime).ToDouble();
     m_lastUpdateTime = currentTime;
 
+    // Sample clock: same result live and when a recorded session is replayed
+    if (timestamp > 0) {
+        deltaMs = (m_lastTimestamp > 0 && timestamp > m_lastTimestamp)
+            ? static_cast<float>(timestamp - m_lastTimestamp) / 1000.0f
+            : 0.0f;
+        m_lastTimestamp = timestamp;
+    }
+
     // Store previous position for exit direction detection
     m_previousGazePosition = m_gazePosition;
 
@@ -104,49 +123,23 @@ void KeyboardView::UpdateGazePosition(float x, float y)
     // Find key at current position
     KeyButton* hoveredKey = FindKeyAtPosition(m_gazePosition);
 
-    // Calculate swipe zone boundaries based on keyboard geometry
-    // Swipe zone: Rows 0-3 (character keys only, NOT including spacebar row)
-    wxSize clientSize = GetClientSize();
-    if (clientSize.GetWidth() > 0 && clientSize.GetHeight() > 0) {
-        // Calculate key size (same as UpdateKeyGeometries)
-        float availableHeight = clientSize.GetHeight() - m_keySpacing * 8;
-        float keyHeight = availableHeight / 7.0f;
-        float availableWidth = clientSize.GetWidth() - m_keySpacing * 13;
-        float keyWidth = availableWidth / 12.0f;
-        float keySize = std::min(keyWidth, keyHeight) * 1.2f;
-
-        // Calculate keyboard offset (for centered keyboard)
-        float keyboardWidth = 12.0f * keySize + 11.0f * m_keySpacing;
-        float keyboardOffsetX = (clientSize.GetWidth() - keyboardWidth) / 2.0f;
-
-        // Swipe zone boundaries (relative to keyboard position)
-        float swipeZoneTop = 0.0f;  // Top of row 0
-        float swipeZoneBottom = 4.0f * (keySize + m_keySpacing);  // Top of spacebar row (row 4)
-        float swipeZoneLeft = keyboardOffsetX;  // Left edge of centered keyboard
-        float swipeZoneRight = keyboardOffsetX + keyboardWidth;  // Right edge of centered keyboard
-
-        // Swipe detection based on actual keyboard geometry
+    // Swipe detection based on the zone cached by UpdateKeyGeometries
+    if (m_layoutValid) {
         if (m_swipeEnabled) {
-            bool insideSwipeZone = (m_gazePosition.m_y >= swipeZoneTop &&
-                                   m_gazePosition.m_y < swipeZoneBottom &&
-                                   m_gazePosition.m_x >= swipeZoneLeft &&
-                                   m_gazePosition.m_x <= swipeZoneRight);
-
-            bool wasInsideSwipeZone = (m_previousGazePosition.m_y >= swipeZoneTop &&
-                                      m_previousGazePosition.m_y < swipeZoneBottom &&
-                                      m_previousGazePosition.m_x >= swipeZoneLeft &&
-                                      m_previousGazePosition.m_x <= swipeZoneRight);
+            bool insideSwipeZone = IsInSwipeZone(m_gazePosition);
+            bool wasInsideSwipeZone = IsInSwipeZone(m_previousGazePosition);
 
             if (insideSwipeZone) {
                 // Inside swipe zone - start recording if not already
                 if (!m_recordingSwipe) {
                     StartSwipeRecording();
                 }
-                // Record point with normalization (same as HeyEyeTracker)
+                // Record point with normalization (same as HeyEyeTracker),
+                // smoothed and resampled by m_swipeFilter
                 if (m_recordingSwipe) {
                     // Normalize coordinates to match the model's expected input range
                     // Adjust for keyboard offset - subtract offset to get keyboard-relative position
-                    float keyboardRelativeX = m_gazePosition.m_x - keyboardOffsetX;
+                    float keyboardRelativeX = m_gazePosition.m_x - m_keyboardOffsetX;
                     float keyboardRelativeY = m_gazePosition.m_y;
 
                     // Original HeyEyeTracker formula (using keyboard-relative coordinates):
@@ -155,13 +148,33 @@ void KeyboardView::UpdateGazePosition(float x, float y)
                     float x_normalized = keyboardRelativeX / (13.0f * m_keySize) * 260.0f - 10.0f;
                     float y_normalized = 100.0f - keyboardRelativeY / (5.0f * m_keySize) * 100.0f;
 
-                    m_swipePath.push_back(std::make_pair(x_normalized, y_normalized));
+                    uint64_t sampleTime = timestamp > 0
+                        ? timestamp
+                        : static_cast<uint64_t>(currentTime.GetValue()) * 1000;
+                    size_t previousCount = m_swipePath.size();
+                    m_swipeFilter.Add(x_normalized, y_normalized, sampleTime, m_swipePath);
+
+                    // Trail grows by the segments the sample produced (none during a fixation)
+                    if (m_swipePath.size() > previousCount) {
+                        wxPoint2DDouble firstPoint = SwipePointToLocal(m_swipePath[previousCount > 0 ? previousCount - 1 : 0]);
+                        wxRect2DDouble segment(firstPoint.m_x, firstPoint.m_y, 0, 0);
+                        for (size_t i = previousCount; i < m_swipePath.size(); ++i) {
+                            segment.Union(SwipePointToLocal(m_swipePath[i]));
+                        }
+                        segment.Inset(-4, -4);
+                        AddDamage(segment);
+
+                        if (m_swipeProgressInterval > 0 && OnSwipeProgress &&
+                            previousCount / m_swipeProgressInterval != m_swipePath.size() / m_swipeProgressInterval) {
+                            OnSwipeProgress(m_swipePath);
+                        }
+                    }
                 }
             } else if (wasInsideSwipeZone && m_recordingSwipe) {
                 // Exiting swipe zone - determine direction
                 // Y axis: increases downward (0 at top, higher values at bottom)
 
-                if (m_gazePosition.m_y < swipeZoneTop) {
+                if (m_gazePosition.m_y < m_swipeZone.GetTop()) {
                     // Exiting from TOP (going upward) - PREDICT WORD
                     if (m_swipePath.size() > 5) {
                         wxLogMessage("Swipe: Exiting from TOP - predicting word (%zu points)", m_swipePath.size());
@@ -169,14 +182,12 @@ void KeyboardView::UpdateGazePosition(float x, float y)
                     } else {
                         // Not enough points - cancel
                         wxLogMessage("Swipe: Exiting from TOP but not enough points (%zu) - canceling", m_swipePath.size());
-                        m_recordingSwipe = false;
-                        m_swipePath.clear();
+                        CancelSwipeRecording();
                     }
                 } else {
                     // Exiting from BOTTOM, LEFT, or RIGHT - CANCEL
                     wxLogMessage("Swipe: Exiting from bottom/left/right - canceling (%zu points)", m_swipePath.size());
-                    m_recordingSwipe = false;
-                    m_swipePath.clear();
+                    CancelSwipeRecording();
                 }
             }
         }
@@ -188,16 +199,21 @@ void KeyboardView::UpdateGazePosition(float x, float y)
         if (m_currentHoveredKey) {
             m_currentHoveredKey->SetHovered(false);
             m_currentHoveredKey->SetProgress(0.0f);
+            AddDamage(m_currentHoveredKey->GetGeometry());
         }
 
         m_currentHoveredKey = hoveredKey;
 
         if (m_currentHoveredKey) {
             m_currentHoveredKey->SetHovered(true);
+            AddDamage(m_currentHoveredKey->GetGeometry());
         }
     } else if (m_currentHoveredKey) {
         // Continue hovering on same key
-        UpdateDwellProgress(m_currentHoveredKey, deltaMs);
+        KeyButton* key = m_currentHoveredKey;
+        if (UpdateDwellProgress(key, deltaMs)) {
+            AddDamage(key->GetGeometry());
+        }
     }
 
     Refresh();
@@ -208,6 +224,8 @@ void KeyboardView::StartSwipeRecording()
     if (m_swipeEnabled) {
         m_recordingSwipe = true;
         m_swipePath.clear();
+        m_swipeFilter.Reset();
+        AddFullDamage();
     }
 }
 
@@ -215,20 +233,69 @@ void KeyboardView::StopSwipeRecording()
 {
     if (m_recordingSwipe) {
         m_recordingSwipe = false;
+        m_swipeFilter.Finish(m_swipePath);
 
         if (!m_swipePath.empty() && OnSwipeCompleted) {
             OnSwipeCompleted(m_swipePath);
         }
         m_swipePath.clear();
+        AddFullDamage();
+    }
+}
+
+void KeyboardView::CancelSwipeRecording()
+{
+    m_recordingSwipe = false;
+    m_swipePath.clear();
+    AddFullDamage();
+
+    if (OnSwipeCancelled) {
+        OnSwipeCancelled();
     }
 }
 
 void KeyboardView::ClearSwipePath()
 {
     m_swipePath.clear();
+    AddFullDamage();
     Refresh();
 }
 
+wxPoint2DDouble KeyboardView::SwipePointToLocal(const std::pair<float, float>& point) const
+{
+    // Inverse of: x_norm = (x - offset) / (13 * keySize) * 260 - 10
+    //             y_norm = 100 - y / (5 * keySize) * 100
+    float x_pixel = (point.first + 10.0f) / 260.0f * (13.0f * m_keySize) + m_keyboardOffsetX;
+    float y_pixel = (100.0f - point.second) / 100.0f * (5.0f * m_keySize);
+    return wxPoint2DDouble(x_pixel, y_pixel);
+}
+
+bool KeyboardView::TakeDamage(wxRect& rect)
+{
+    if (m_damage.IsEmpty()) {
+        return false;
+    }
+
+    rect = m_damage;
+    m_damage = wxRect();
+    return true;
+}
+
+void KeyboardView::AddDamage(const wxRect2DDouble& area)
+{
+    // Round outwards, plus room for the 2px outline
+    wxRect rect(static_cast<int>(std::floor(area.m_x)) - 2,
+                static_cast<int>(std::floor(area.m_y)) - 2,
+                static_cast<int>(std::ceil(area.m_width)) + 5,
+                static_cast<int>(std::ceil(area.m_height)) + 5);
+    m_damage = m_damage.IsEmpty() ? rect : m_damage.Union(rect);
+}
+
+void KeyboardView::AddFullDamage()
+{
+    m_damage = wxRect(GetClientSize());
+}
+
 std::map<wxChar, std::pair<float, float>> KeyboardView::GetKeyboardCoordinates() const
 {
     std::map<wxChar, std::pair<float, float>> coords;
@@ -291,16 +358,11 @@ void KeyboardView::RenderToDC(wxDC& dc)
         dc.SetPen(wxPen(m_swipePathColor, 3));
         dc.SetBrush(*wxTRANSPARENT_BRUSH);
 
-        // Calculate keyboard offset for denormalization
-        wxSize clientSize = GetClientSize();
-        float keyboardWidth = 12.0f * m_keySize + 11.0f * m_keySpacing;
-        float keyboardOffsetX = (clientSize.GetWidth() - keyboardWidth) / 2.0f;
-
         // Helper lambda to de-normalize coordinates for visualization
         // Inverse of: x_norm = (x - offset) / (13 * keySize) * 260 - 10
         //             y_norm = 100 - y / (5 * keySize) * 100
-        auto denormalize = [this, keyboardOffsetX](float x_norm, float y_norm) -> wxPoint {
-            float x_pixel = (x_norm + 10.0f) / 260.0f * (13.0f * m_keySize) + keyboardOffsetX;
+        auto denormalize = [this](float x_norm, float y_norm) -> wxPoint {
+            float x_pixel = (x_norm + 10.0f) / 260.0f * (13.0f * m_keySize) + m_keyboardOffsetX;
             float y_pixel = (100.0f - y_norm) / 100.0f * (5.0f * m_keySize);
             return wxPoint(static_cast<int>(x_pixel), static_cast<int>(y_pixel));
         };
@@ -355,6 +417,7 @@ void KeyboardView::OnSize(wxSizeEvent& event)
 {
     event.Skip();
     UpdateKeyGeometries();
+    AddFullDamage();
     Refresh();
 }
 
@@ -560,6 +623,9 @@ void KeyboardView::UpdateKeyGeometries()
 {
     wxSize clientSize = GetClientSize();
     if (clientSize.GetWidth() <= 0 || clientSize.GetHeight() <= 0) {
+        m_layoutValid = false;
+        m_keyGrid.Clear();
+        m_gridKeys.clear();
         return;
     }
 
@@ -582,6 +648,10 @@ void KeyboardView::UpdateKeyGeometries()
     // Calculate total keyboard width (12 keys) for centering
     float keyboardWidth = 12.0f * keySize + 11.0f * m_keySpacing;
     float keyboardOffsetX = (clientSize.GetWidth() - keyboardWidth) / 2.0f;
+    m_keyboardOffsetX = keyboardOffsetX;
+
+    // Swipe zone: from the top of row 0 to the top of the spacebar row (row 4)
+    m_swipeZone = wxRect2DDouble(keyboardOffsetX, 0.0f, keyboardWidth, 4.0f * (keySize + m_keySpacing));
 
     // Position regular keys in 4 rows (centered horizontally)
     size_t keyIndex = 0;
@@ -673,73 +743,51 @@ void KeyboardView::UpdateKeyGeometries()
         wxRect2DDouble rect(-1000, -1000, keySize, keySize);
         m_speakKey->SetGeometry(rect);
     }
+
+    // Lookup table for FindKeyAtPosition, one cell per key pitch. The speak
+    // key is left out: it is parked off-screen and EyeOverlay hit-tests SPEAK.
+    m_keyGrid.Clear();
+    m_gridKeys.clear();
+    auto addToGrid = [this](KeyButton* key) {
+        if (!key) return;
+        wxRect2DDouble rect = key->GetGeometry();
+        m_keyGrid.Add(static_cast<float>(rect.m_x), static_cast<float>(rect.m_y),
+                      static_cast<float>(rect.m_width), static_cast<float>(rect.m_height));
+        m_gridKeys.push_back(key);
+    };
+    addToGrid(m_spaceKey);
+    addToGrid(m_swipeToggleKey);
+    addToGrid(m_backspaceKey);
+    addToGrid(m_deleteWordKey);
+    addToGrid(m_shiftKey);
+    addToGrid(m_capsLockKey);
+    addToGrid(m_altgrKey);
+    addToGrid(m_enterKey);
+    for (KeyButton* key : m_keys) {
+        addToGrid(key);
+    }
+    m_keyGrid.Build(keySize + m_keySpacing);
+    m_layoutValid = true;
 }
 
-void KeyboardView::UpdateDwellProgress(KeyButton *key, float deltaMs)
+bool KeyboardView::UpdateDwellProgress(KeyButton *key, float deltaMs)
 {
-    if (!key) return;
+    if (!key) return false;
 
-    float currentProgress = key->GetProgress();
-    float progressIncrement = deltaMs / m_dwellTimeMs;
-    key->SetProgress(currentProgress + progressIncrement);
+    return key->AdvanceProgress(deltaMs, static_cast<float>(m_dwellTimeMs));
 }
 
-KeyButton* KeyboardView::FindKeyAtPosition(const wxPoint2DDouble &pos)
+KeyButton* KeyboardView::FindKeyAtPosition(const wxPoint2DDouble &pos) const
 {
-    // Check space bar (larger target)
-    if (m_spaceKey && m_spaceKey->Contains(pos)) {
-        return m_spaceKey;
-    }
-
-    // Check control buttons
-    if (m_swipeToggleKey && m_swipeToggleKey->Contains(pos)) {
-        return m_swipeToggleKey;
-    }
-    if (m_backspaceKey && m_backspaceKey->Contains(pos)) {
-        return m_backspaceKey;
-    }
-    if (m_deleteWordKey && m_deleteWordKey->Contains(pos)) {
-        return m_deleteWordKey;
-    }
-
-    // Check modifier keys
-    if (m_shiftKey && m_shiftKey->Contains(pos)) {
-        return m_shiftKey;
-    }
-    if (m_capsLockKey && m_capsLockKey->Contains(pos)) {
-        return m_capsLockKey;
-    }
-    if (m_altgrKey && m_altgrKey->Contains(pos)) {
-        return m_altgrKey;
-    }
-    if (m_backspaceKey && m_backspaceKey->Contains(pos)) {
-        return m_backspaceKey;
-    }
-    if (m_deleteWordKey && m_deleteWordKey->Contains(pos)) {
-        return m_deleteWordKey;
-    }
-    if (m_enterKey && m_enterKey->Contains(pos)) {
-        return m_enterKey;
-    }
-
-    // Check swipe toggle key
-    if (m_swipeToggleKey && m_swipeToggleKey->Contains(pos)) {
-        return m_swipeToggleKey;
-    }
-
-    // Check speak key
-    if (m_speakKey && m_speakKey->Contains(pos)) {
-        return m_speakKey;
-    }
-
-    // Check regular keys
-    for (KeyButton* key : m_keys) {
-        if (key->Contains(pos)) {
-            return key;
-        }
-    }
+    int index = m_keyGrid.Find(static_cast<float>(pos.m_x), static_cast<float>(pos.m_y));
+    return index == KeyGrid::NOT_FOUND ? nullptr : m_gridKeys[index];
+}
 
-    return nullptr;
+bool KeyboardView::IsInSwipeZone(const wxPoint2DDouble &pos) const
+{
+    // Bottom edge exclusive (spacebar row), right edge inclusive
+    return pos.m_y >= m_swipeZone.GetTop() && pos.m_y < m_swipeZone.GetBottom() &&
+           pos.m_x >= m_swipeZone.GetLeft() && pos.m_x <= m_swipeZone.GetRight();
 }
 
 void KeyboardView::ToggleShift()
@@ -748,6 +796,7 @@ void KeyboardView::ToggleShift()
     if (m_shiftKey) {
         m_shiftKey->SetModifierActive(m_shiftActive);
     }
+    AddFullDamage();
     Refresh();
 }
 
@@ -764,6 +813,7 @@ void KeyboardView::ToggleCapsLock()
     if (m_capsLockKey) {
         m_capsLockKey->SetModifierActive(m_capsLockActive);
     }
+    AddFullDamage();
     Refresh();
 }
 
@@ -773,6 +823,7 @@ void KeyboardView::ToggleAltGr()
     if (m_altgrKey) {
         m_altgrKey->SetModifierActive(m_altgrActive);
     }
+    AddFullDamage();
     Refresh();
 }
 
@@ -799,15 +850,31 @@ wxChar KeyboardView::GetEffectiveCharacter(KeyButton* key)
 std::vector<KeyRenderInfo> KeyboardView::GetKeysForRendering() const
 {
     std::vector<KeyRenderInfo> renderInfo;
+    GetKeysForRendering(renderInfo);
+    return renderInfo;
+}
+
+void KeyboardView::GetKeysForRendering(std::vector<KeyRenderInfo>& renderInfo) const
+{
+    // Entries are overwritten in place so a reused vector keeps its strings' storage
+    size_t count = 0;
+
+    // Helper lambda to fill render info from a key
+    auto addRenderInfo = [this, &renderInfo, &count](KeyButton* key) {
+        if (!key) return;
+        if (count == renderInfo.size()) {
+            renderInfo.emplace_back();
+        }
+        KeyRenderInfo& info = renderInfo[count++];
 
-    // Helper lambda to create render info from a key
-    auto makeRenderInfo = [this](KeyButton* key) -> KeyRenderInfo {
-        KeyRenderInfo info;
         info.geometry = key->GetGeometry();
         info.progress = key->GetProgress();
         info.isHovered = key->IsHovered();
         info.isModifierActive = key->IsModifierActive();
         info.keyType = key->GetKeyType();
+        info.primaryLabel.clear();
+        info.shiftLabel.clear();
+        info.altgrLabel.clear();
 
         if (key->GetKeyType() == KeyType::Character) {
             // For character keys, show ALL three layers (primary, shift, altgr)
@@ -816,19 +883,19 @@ std::vector<KeyRenderInfo> KeyboardView::GetKeysForRendering() const
             // Primary character (center/bottom)
             wxChar primaryChar = key->GetPrimaryCharacter();
             if (primaryChar != 0) {
-                info.primaryLabel = wxString(&primaryChar, 1);
+                info.primaryLabel = primaryChar;
             }
 
             // Shift character (top-left)
             wxChar shiftChar = key->GetShiftCharacter();
             if (shiftChar != 0 && shiftChar != primaryChar) {
-                info.shiftLabel = wxString(&shiftChar, 1);
+                info.shiftLabel = shiftChar;
             }
 
             // AltGr character (top-right)
             wxChar altgrChar = key->GetAltGrCharacter();
             if (altgrChar != 0) {
-                info.altgrLabel = wxString(&altgrChar, 1);
+                info.altgrLabel = altgrChar;
             }
 
             // Determine which character layer is currently active
@@ -844,49 +911,23 @@ std::vector<KeyRenderInfo> KeyboardView::GetKeysForRendering() const
             info.primaryLabel = key->GetLabel();
             info.activeLayer = KeyRenderInfo::Primary;
         }
-
-        return info;
     };
 
     // Add all regular keys
     for (KeyButton* key : m_keys) {
-        renderInfo.push_back(makeRenderInfo(key));
+        addRenderInfo(key);
     }
 
-    // Add space bar
-    if (m_spaceKey) {
-        renderInfo.push_back(makeRenderInfo(m_spaceKey));
-    }
-
-    // Add swipe toggle key
-    if (m_swipeToggleKey) {
-        renderInfo.push_back(makeRenderInfo(m_swipeToggleKey));
-    }
+    // Space bar, swipe toggle, speak and modifier keys
+    addRenderInfo(m_spaceKey);
+    addRenderInfo(m_swipeToggleKey);
+    addRenderInfo(m_speakKey);
+    addRenderInfo(m_shiftKey);
+    addRenderInfo(m_capsLockKey);
+    addRenderInfo(m_altgrKey);
+    addRenderInfo(m_backspaceKey);
+    addRenderInfo(m_deleteWordKey);
+    addRenderInfo(m_enterKey);
 
-    // Add speak key
-    if (m_speakKey) {
-        renderInfo.push_back(makeRenderInfo(m_speakKey));
-    }
-
-    // Add modifier keys
-    if (m_shiftKey) {
-        renderInfo.push_back(makeRenderInfo(m_shiftKey));
-    }
-    if (m_capsLockKey) {
-        renderInfo.push_back(makeRenderInfo(m_capsLockKey));
-    }
-    if (m_altgrKey) {
-        renderInfo.push_back(makeRenderInfo(m_altgrKey));
-    }
-    if (m_backspaceKey) {
-        renderInfo.push_back(makeRenderInfo(m_backspaceKey));
-    }
-    if (m_deleteWordKey) {
-        renderInfo.push_back(makeRenderInfo(m_deleteWordKey));
-    }
-    if (m_enterKey) {
-        renderInfo.push_back(makeRenderInfo(m_enterKey));
-    }
-
-    return renderInfo;
+    renderInfo.resize(count);
 }
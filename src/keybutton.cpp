@@ -10,7 +10,6 @@ KeyButton::KeyButton(wxChar primary, wxChar shift, wxChar altgr, const wxRect2DD
     , m_label(wxEmptyString)
     , m_geometry(geometry)
     , m_hovered(false)
-    , m_progress(0.0f)
     , m_modifierActive(false)
     , OnActivated(nullptr)
 {
@@ -24,7 +23,6 @@ KeyButton::KeyButton(KeyType type, const wxString& label, const wxRect2DDouble&
     , m_label(label)
     , m_geometry(geometry)
     , m_hovered(false)
-    , m_progress(0.0f)
     , m_modifierActive(false)
     , OnActivated(nullptr)
 {
@@ -35,21 +33,35 @@ void KeyButton::SetHovered(bool hovered)
     if (m_hovered != hovered) {
         m_hovered = hovered;
         if (!hovered) {
-            m_progress = 0.0f; // Reset progress when hover ends
+            m_progress.Reset(); // Reset progress when hover ends
         }
     }
 }
 
 void KeyButton::SetProgress(float progress)
 {
-    m_progress = std::max(0.0f, std::min(1.0f, progress));
+    m_progress.Set(std::max(0.0f, std::min(1.0f, progress)));
 
     // Call activation callback when progress reaches 100%
-    if (m_progress >= 1.0f && OnActivated) {
+    if (m_progress.IsComplete() && OnActivated) {
         OnActivated();
     }
 }
 
+bool KeyButton::AdvanceProgress(float elapsed, float dwellTime)
+{
+    bool changed = m_progress.Advance(elapsed, dwellTime);
+
+    if (m_progress.IsComplete()) {
+        m_progress.Set(1.0f);
+        if (OnActivated) {
+            OnActivated();
+        }
+        return true;
+    }
+    return changed;
+}
+
 void KeyButton::Draw(wxDC& dc, const wxColour& normalColor, const wxColour& hoverColor, const wxColour& progressColor,
                      bool shiftActive, bool capsActive, bool altgrActive)
 {
@@ -151,7 +163,8 @@ void KeyButton::Draw(wxDC& dc, const wxColour& normalColor, const wxColour& hove
     }
 
     // Draw progress arc if there's any progress
-    if (m_progress > 0.0f && m_progress < 1.0f) {
+    float progress = m_progress.Get();
+    if (progress > 0.0f && progress < 1.0f) {
         dc.SetPen(wxPen(progressColor, 4));
         dc.SetBrush(*wxTRANSPARENT_BRUSH);
 
@@ -162,7 +175,7 @@ void KeyButton::Draw(wxDC& dc, const wxColour& normalColor, const wxColour& hove
         // wxDC::DrawEllipticArc uses degrees (0-360)
         // Start at top (270 degrees) and go clockwise
         double startAngle = 90.0;  // Top of circle
-        double endAngle = 90.0 - (360.0 * m_progress);  // Clockwise
+        double endAngle = 90.0 - (360.0 * progress);  // Clockwise
 
         dc.DrawEllipticArc(
             static_cast<int>(arcRect.m_x),
@@ -175,7 +188,7 @@ void KeyButton::Draw(wxDC& dc, const wxColour& normalColor, const wxColour& hove
     }
 
     // Draw full circle if progress is complete
-    if (m_progress >= 1.0f) {
+    if (m_progress.IsComplete()) {
         dc.SetPen(wxPen(progressColor, 4));
         dc.SetBrush(*wxTRANSPARENT_BRUSH);
 
@@ -0,0 +1,235 @@
+#include "keycapatlas.h"
+
+KeyCapAtlas::KeyCapAtlas()
+    : m_color(102, 204, 255)
+    , m_renderedCount(0)
+{
+}
+
+void KeyCapAtlas::SetColor(const wxColour& color)
+{
+    if (color != m_color) {
+        m_color = color;
+        Clear();
+    }
+}
+
+void KeyCapAtlas::Clear()
+{
+    m_slots.clear();
+    m_labelSlots.clear();
+    m_renderedCount = 0;
+}
+
+bool KeyCapAtlas::Matches(const Slot& slot, const KeyRenderInfo& info, int width, int height) const
+{
+    return slot.width == width && slot.height == height && slot.keyType == info.keyType &&
+           slot.primaryLabel == info.primaryLabel && slot.shiftLabel == info.shiftLabel &&
+           slot.altgrLabel == info.altgrLabel;
+}
+
+const wxGraphicsBitmap& KeyCapAtlas::GetKeyCap(wxGraphicsContext* gc, size_t slotIndex, const KeyRenderInfo& info, int width, int height)
+{
+    if (slotIndex >= m_slots.size()) {
+        m_slots.resize(slotIndex + 1);
+    }
+
+    Slot& slot = m_slots[slotIndex];
+    if (!Matches(slot, info, width, height)) {
+        // Layout or labels changed: forget every variant of this key
+        slot = Slot();
+        slot.width = width;
+        slot.height = height;
+        slot.keyType = info.keyType;
+        slot.primaryLabel = info.primaryLabel;
+        slot.shiftLabel = info.shiftLabel;
+        slot.altgrLabel = info.altgrLabel;
+    }
+
+    Background background = BackgroundNone;
+    if (info.isModifierActive) {
+        background = BackgroundModifier;
+    } else if (info.isHovered) {
+        background = BackgroundHover;
+    }
+
+    wxGraphicsBitmap& cap = slot.caps[info.activeLayer][background];
+    if (cap.IsNull()) {
+        cap = RenderKeyCap(gc, info, width, height, background);
+        m_renderedCount++;
+    }
+    return cap;
+}
+
+const wxGraphicsBitmap& KeyCapAtlas::GetLabelCap(wxGraphicsContext* gc, size_t slotIndex, const wxString& label,
+                                                 int width, int height, LabelCapStyle style)
+{
+    if (slotIndex >= m_labelSlots.size()) {
+        m_labelSlots.resize(slotIndex + 1);
+    }
+
+    LabelSlot& slot = m_labelSlots[slotIndex];
+    if (slot.width != width || slot.height != height || slot.label != label) {
+        slot = LabelSlot();
+        slot.width = width;
+        slot.height = height;
+        slot.label = label;
+    }
+
+    wxGraphicsBitmap& cap = slot.caps[style];
+    if (cap.IsNull()) {
+        cap = RenderLabelCap(gc, label, width, height, style);
+        m_renderedCount++;
+    }
+    return cap;
+}
+
+wxGraphicsBitmap KeyCapAtlas::RenderKeyCap(wxGraphicsContext* gc, const KeyRenderInfo& info, int width, int height, Background background) const
+{
+    wxGraphicsRenderer* renderer = gc->GetRenderer();
+
+    // Transparent 32-bit surface, same format as the overlay back buffer
+    wxBitmap bitmap(width + 2 * MARGIN, height + 2 * MARGIN, 32);
+    bitmap.UseAlpha();
+
+    wxMemoryDC mdc(bitmap);
+    wxGraphicsContext* capGC = renderer->CreateContext(mdc);
+    if (!capGC) {
+        return wxGraphicsBitmap();
+    }
+
+    capGC->SetCompositionMode(wxCOMPOSITION_CLEAR);
+    capGC->DrawRectangle(0, 0, bitmap.GetWidth(), bitmap.GetHeight());
+    capGC->SetCompositionMode(wxCOMPOSITION_OVER);
+    capGC->SetAntialiasMode(wxANTIALIAS_DEFAULT);
+
+    const wxColour& color = m_color;
+    int keyX = MARGIN;
+    int keyY = MARGIN;
+    int centerX = keyX + width / 2;
+    int centerY = keyY + height / 2;
+
+    // Key background (with modifier highlighting)
+    if (background == BackgroundModifier) {
+        // Active modifier keys get a filled background
+        capGC->SetBrush(wxBrush(wxColour(color.Red(), color.Green(), color.Blue(), 100)));
+    } else if (background == BackgroundHover) {
+        // Hovered keys get a lighter background
+        capGC->SetBrush(wxBrush(wxColour(color.Red(), color.Green(), color.Blue(), 50)));
+    } else {
+        capGC->SetBrush(*wxTRANSPARENT_BRUSH);
+    }
+
+    capGC->SetPen(wxPen(color, 2));
+    capGC->DrawRoundedRectangle(keyX, keyY, width, height, 5);
+
+    // Active character: larger and bold (the one that will be typed)
+    wxFont activeFont(20, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
+    // Inactive characters: smaller and normal weight
+    wxFont inactiveFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
+    // Dimmed color for inactive characters
+    wxColour inactiveColor(color.Red(), color.Green(), color.Blue(), 150);
+
+    if (info.keyType == KeyType::Character) {
+        const int padding = 4;  // Padding from key edges
+
+        // Shift character (top-left)
+        if (!info.shiftLabel.IsEmpty()) {
+            bool isActive = (info.activeLayer == KeyRenderInfo::Shift);
+            capGC->SetFont(isActive ? activeFont : inactiveFont, isActive ? color : inactiveColor);
+            double textWidth, textHeight;
+            capGC->GetTextExtent(info.shiftLabel, &textWidth, &textHeight);
+
+            if (isActive) {
+                capGC->DrawText(info.shiftLabel, centerX - textWidth/2, centerY - textHeight/2);
+            } else {
+                capGC->DrawText(info.shiftLabel, keyX + padding, keyY + padding);
+            }
+        }
+
+        // AltGr character (top-right)
+        if (!info.altgrLabel.IsEmpty()) {
+            bool isActive = (info.activeLayer == KeyRenderInfo::AltGr);
+            capGC->SetFont(isActive ? activeFont : inactiveFont, isActive ? color : inactiveColor);
+            double textWidth, textHeight;
+            capGC->GetTextExtent(info.altgrLabel, &textWidth, &textHeight);
+
+            if (isActive) {
+                capGC->DrawText(info.altgrLabel, centerX - textWidth/2, centerY - textHeight/2);
+            } else {
+                capGC->DrawText(info.altgrLabel, keyX + width - textWidth - padding, keyY + padding);
+            }
+        }
+
+        // Primary character (center, or bottom when another layer is active)
+        if (!info.primaryLabel.IsEmpty()) {
+            bool isActive = (info.activeLayer == KeyRenderInfo::Primary);
+            capGC->SetFont(isActive ? activeFont : inactiveFont, isActive ? color : inactiveColor);
+            double textWidth, textHeight;
+            capGC->GetTextExtent(info.primaryLabel, &textWidth, &textHeight);
+
+            if (isActive) {
+                capGC->DrawText(info.primaryLabel, centerX - textWidth/2, centerY - textHeight/2);
+            } else {
+                capGC->DrawText(info.primaryLabel, centerX - textWidth/2, keyY + height - textHeight - padding);
+            }
+        }
+    } else {
+        // For modifier keys, just draw the primary label centered
+        capGC->SetFont(activeFont, color);
+        double textWidth, textHeight;
+        capGC->GetTextExtent(info.primaryLabel, &textWidth, &textHeight);
+        capGC->DrawText(info.primaryLabel, centerX - textWidth/2, centerY - textHeight/2);
+    }
+
+    delete capGC;
+    mdc.SelectObject(wxNullBitmap);
+
+    return renderer->CreateBitmap(bitmap);
+}
+
+wxGraphicsBitmap KeyCapAtlas::RenderLabelCap(wxGraphicsContext* gc, const wxString& label, int width, int height, LabelCapStyle style) const
+{
+    wxGraphicsRenderer* renderer = gc->GetRenderer();
+
+    wxBitmap bitmap(width + 2 * MARGIN, height + 2 * MARGIN, 32);
+    bitmap.UseAlpha();
+
+    wxMemoryDC mdc(bitmap);
+    wxGraphicsContext* capGC = renderer->CreateContext(mdc);
+    if (!capGC) {
+        return wxGraphicsBitmap();
+    }
+
+    capGC->SetCompositionMode(wxCOMPOSITION_CLEAR);
+    capGC->DrawRectangle(0, 0, bitmap.GetWidth(), bitmap.GetHeight());
+    capGC->SetCompositionMode(wxCOMPOSITION_OVER);
+    capGC->SetAntialiasMode(wxANTIALIAS_DEFAULT);
+
+    const wxColour& color = m_color;
+
+    // Same pens, brushes and font as the overlay drew these buttons with
+    if (style == LabelCapCircle || style == LabelCapCircleSelected) {
+        capGC->SetPen(wxPen(color, style == LabelCapCircleSelected ? 3 : 1));
+        capGC->SetBrush(*wxTRANSPARENT_BRUSH);
+        capGC->DrawEllipse(MARGIN, MARGIN, width, height);
+    } else {
+        capGC->SetPen(wxPen(color, 2));
+        if (style == LabelCapButtonActive) {
+            capGC->SetBrush(wxBrush(wxColour(color.Red(), color.Green(), color.Blue(), 100)));
+        } else {
+            capGC->SetBrush(*wxTRANSPARENT_BRUSH);
+        }
+        capGC->DrawRoundedRectangle(MARGIN, MARGIN, width, height, 10);
+    }
+
+    capGC->SetFont(wxFont(12, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD), color);
+    double textWidth, textHeight;
+    capGC->GetTextExtent(label, &textWidth, &textHeight);
+    capGC->DrawText(label, MARGIN + width / 2 - textWidth/2, MARGIN + height / 2 - textHeight/2);
+
+    delete capGC;
+    mdc.SelectObject(wxNullBitmap);
+
+    return renderer->CreateBitmap(bitmap);
+}
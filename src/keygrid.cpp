@@ -0,0 +1,145 @@
+#include "keygrid.h"
+#include <algorithm>
+#include <cmath>
+
+KeyGrid::KeyGrid()
+    : m_originX(0.0f)
+    , m_originY(0.0f)
+    , m_cellSize(1.0f)
+    , m_columns(0)
+    , m_rows(0)
+{
+}
+
+void KeyGrid::Clear()
+{
+    m_rects.clear();
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_columns = 0;
+    m_rows = 0;
+}
+
+int KeyGrid::Add(float x, float y, float width, float height)
+{
+    m_rects.push_back(Rect{x, y, x + width, y + height});
+    return static_cast<int>(m_rects.size() - 1);
+}
+
+void KeyGrid::Build(float cellSize)
+{
+    m_cellStart.clear();
+    m_cellItems.clear();
+    m_columns = 0;
+    m_rows = 0;
+
+    // Empty rectangles can never be hit, they do not extend the grid either
+    bool any = false;
+    float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f;
+    for (const Rect& rect : m_rects) {
+        if (!(rect.right > rect.left && rect.bottom > rect.top)) {
+            continue;
+        }
+        if (!any) {
+            left = rect.left;
+            top = rect.top;
+            right = rect.right;
+            bottom = rect.bottom;
+            any = true;
+        } else {
+            left = std::min(left, rect.left);
+            top = std::min(top, rect.top);
+            right = std::max(right, rect.right);
+            bottom = std::max(bottom, rect.bottom);
+        }
+    }
+    if (!any) {
+        return;
+    }
+
+    if (!(cellSize > 0.0f)) {
+        cellSize = std::max(right - left, bottom - top) / 16.0f;
+    }
+    int columns = 0;
+    int rows = 0;
+    for (;;) {
+        columns = std::max(1, static_cast<int>(std::ceil((right - left) / cellSize)));
+        rows = std::max(1, static_cast<int>(std::ceil((bottom - top) / cellSize)));
+        if (static_cast<size_t>(columns) * static_cast<size_t>(rows) <= MAX_CELLS) {
+            break;
+        }
+        cellSize *= 2.0f;
+    }
+
+    m_originX = left;
+    m_originY = top;
+    m_cellSize = cellSize;
+    m_columns = columns;
+    m_rows = rows;
+
+    // Cells covered by a rectangle, right/bottom edges are exclusive
+    auto cellRange = [this](const Rect& rect, int& c0, int& c1, int& r0, int& r1) {
+        c0 = std::max(0, static_cast<int>(std::floor((rect.left - m_originX) / m_cellSize)));
+        c1 = std::min(m_columns - 1, static_cast<int>(std::ceil((rect.right - m_originX) / m_cellSize)) - 1);
+        r0 = std::max(0, static_cast<int>(std::floor((rect.top - m_originY) / m_cellSize)));
+        r1 = std::min(m_rows - 1, static_cast<int>(std::ceil((rect.bottom - m_originY) / m_cellSize)) - 1);
+    };
+
+    // Two passes (count, then fill) into one flat array
+    const size_t cellCount = static_cast<size_t>(m_columns) * m_rows;
+    m_cellStart.assign(cellCount + 1, 0);
+    for (const Rect& rect : m_rects) {
+        if (!(rect.right > rect.left && rect.bottom > rect.top)) {
+            continue;
+        }
+        int c0, c1, r0, r1;
+        cellRange(rect, c0, c1, r0, r1);
+        for (int row = r0; row <= r1; ++row) {
+            for (int column = c0; column <= c1; ++column) {
+                m_cellStart[row * m_columns + column + 1]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < cellCount; ++i) {
+        m_cellStart[i + 1] += m_cellStart[i];
+    }
+
+    m_cellItems.resize(m_cellStart[cellCount]);
+    std::vector<uint32_t> next(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t index = 0; index < m_rects.size(); ++index) {
+        const Rect& rect = m_rects[index];
+        if (!(rect.right > rect.left && rect.bottom > rect.top)) {
+            continue;
+        }
+        int c0, c1, r0, r1;
+        cellRange(rect, c0, c1, r0, r1);
+        for (int row = r0; row <= r1; ++row) {
+            for (int column = c0; column <= c1; ++column) {
+                m_cellItems[next[row * m_columns + column]++] = static_cast<uint32_t>(index);
+            }
+        }
+    }
+}
+
+int KeyGrid::Find(float x, float y) const
+{
+    if (m_columns == 0) {
+        return NOT_FOUND;
+    }
+
+    // Written so that NaN coordinates fall outside as well
+    const float gridX = (x - m_originX) / m_cellSize;
+    const float gridY = (y - m_originY) / m_cellSize;
+    if (!(gridX >= 0.0f && gridY >= 0.0f && gridX < m_columns && gridY < m_rows)) {
+        return NOT_FOUND;
+    }
+
+    const size_t cell = static_cast<size_t>(gridY) * m_columns + static_cast<size_t>(gridX);
+    for (uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i) {
+        const Rect& rect = m_rects[m_cellItems[i]];
+        if (x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom) {
+            return static_cast<int>(m_cellItems[i]);
+        }
+    }
+    return NOT_FOUND;
+}
@@ -0,0 +1,151 @@
+#include "languagecontext.h"
+#include "kenlmutil.h"
+#include <algorithm>
+#include <exception>
+
+LanguageContext::LanguageContext()
+    : m_leadingSpaces(0)
+    , m_model(nullptr)
+{
+}
+
+void LanguageContext::AppendCharacter(const std::string& character)
+{
+    if (character.empty()) {
+        return;
+    }
+
+    // Words are separated by spaces only, like the former wxSplit(text, ' ')
+    if (character == " ") {
+        if (m_words.empty()) {
+            m_leadingSpaces++;
+        } else {
+            m_words.back().spacesAfter++;
+        }
+        return;
+    }
+
+    if (m_words.empty() || m_words.back().spacesAfter > 0) {
+        m_words.push_back(Word());
+    }
+    m_words.back().text += character;
+    InvalidateLastWord();
+}
+
+void LanguageContext::AppendText(const std::string& text)
+{
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t space = text.find(' ', start);
+        if (space == std::string::npos) {
+            space = text.size();
+        }
+        if (space > start) {
+            AppendCharacter(text.substr(start, space - start));
+        }
+        if (space < text.size()) {
+            AppendCharacter(" ");
+        }
+        start = space + 1;
+    }
+}
+
+void LanguageContext::DeleteLastCharacter()
+{
+    if (m_words.empty()) {
+        if (m_leadingSpaces > 0) {
+            m_leadingSpaces--;
+        }
+        return;
+    }
+
+    Word& last = m_words.back();
+    if (last.spacesAfter > 0) {
+        last.spacesAfter--;
+        return;
+    }
+
+    // Drop one UTF-8 code point: continuation bytes, then the lead byte
+    while (!last.text.empty() && (static_cast<unsigned char>(last.text.back()) & 0xC0) == 0x80) {
+        last.text.pop_back();
+    }
+    if (!last.text.empty()) {
+        last.text.pop_back();
+    }
+
+    if (last.text.empty()) {
+        m_words.pop_back();
+    } else {
+        InvalidateLastWord();
+    }
+}
+
+void LanguageContext::DeleteLastWord()
+{
+    // The text is cut after its last space: only a word being typed goes
+    if (!m_words.empty() && m_words.back().spacesAfter == 0) {
+        m_words.pop_back();
+    }
+}
+
+void LanguageContext::Clear()
+{
+    m_words.clear();
+    m_leadingSpaces = 0;
+}
+
+void LanguageContext::InvalidateLastWord()
+{
+    m_words.back().scored = false;
+}
+
+LmContext LanguageContext::GetContext(const lm::base::Model* model)
+{
+    LmContext context;
+#ifdef USE_KENLM
+    if (!model) {
+        return context;
+    }
+
+    // States of another model are meaningless
+    if (model != m_model) {
+        for (Word& word : m_words) {
+            word.scored = false;
+        }
+        m_model = model;
+    }
+
+    if (!m_words.empty() && m_words.back().scored) {
+        return m_words.back().context;
+    }
+
+    // Same order of operations as scoring the last words from <s> in one go
+    lm::ngram::State state = kenlm_begin_state(model);
+    float logProb = 0.0f;
+    try {
+        lm::ngram::State out_state;
+        const size_t first = m_words.size() > CONTEXT_WORDS ? m_words.size() - CONTEXT_WORDS : 0;
+        for (size_t i = first; i < m_words.size(); ++i) {
+            lm::WordIndex wordIndex = kenlm_index(model, m_words[i].text);
+            lm::FullScoreReturn ret = kenlm_full_score(model, state, wordIndex, out_state);
+            logProb += ret.prob;
+            state = out_state;
+        }
+    } catch (const std::exception&) {
+        // Fall back to the begin state, as a context that cannot be scored
+        state = kenlm_begin_state(model);
+        logProb = 0.0f;
+    }
+
+    context.state = kenlm_to_lm_state(state);
+    context.logProb = logProb;
+    context.valid = true;
+    if (!m_words.empty()) {
+        m_words.back().context = context;
+        m_words.back().scored = true;
+    }
+#else
+    (void)model;
+#endif
+    return context;
+}
@@ -1,11 +1,14 @@
 #include "lightgbm_ranker.h"
-#include "ranking_features.h"
+#include "candidatebatch.h"
+#include "treeensemble.h"
 
 #ifdef USE_LIGHTGBM
 #include <LightGBM/c_api.h>
 #endif
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <stdexcept>
 #include <cstring>
 
@@ -16,12 +19,16 @@ public:
     void* booster;
 #endif
     bool is_loaded;
+    Backend backend;
+    TreeEnsemble trees;
+    std::string load_message;
 
     Impl() :
 #ifdef USE_LIGHTGBM
         booster(nullptr),
 #endif
-        is_loaded(false) {}
+        is_loaded(false),
+        backend(BACKEND_AUTO) {}
 
     ~Impl() {
 #ifdef USE_LIGHTGBM
@@ -31,58 +38,87 @@ public:
 #endif
     }
 
-    int get_num_features() const {
-        return 39;  // Match feature_list.json
+    // Reused between predictions
+    std::vector<double> scores;
+
+#ifdef USE_LIGHTGBM
+    bool load_booster(const std::string& model_path) {
+        int num_iterations = 0;
+        if (LGBM_BoosterCreateFromModelfile(model_path.c_str(), &num_iterations,
+                                            reinterpret_cast<BoosterHandle*>(&booster)) != 0) {
+            booster = nullptr;
+            return false;
+        }
+
+        // The batch columns are fixed, refuse a model trained on another feature list
+        int num_features = 0;
+        if (LGBM_BoosterGetNumFeature(booster, &num_features) != 0 || num_features != FEATURE_COUNT) {
+            free_booster();
+            return false;
+        }
+        return true;
+    }
+
+    void free_booster() {
+        if (booster != nullptr) {
+            LGBM_BoosterFree(booster);
+            booster = nullptr;
+        }
+    }
+
+    void predict_booster(const float* data, int rows, double* out) {
+        int64_t out_len;
+        int result = LGBM_BoosterPredictForMat(
+            booster,
+            data,
+            C_API_DTYPE_FLOAT32,  // data type
+            rows,                 // nrow
+            FEATURE_COUNT,        // ncol
+            1,                    // is_row_major
+            C_API_PREDICT_NORMAL, // predict_type
+            0,                    // start_iteration (0 means from start)
+            -1,                   // num_iteration (-1 means best iteration)
+            "",                   // parameter
+            &out_len,
+            out
+        );
+
+        if (result != 0) {
+            throw std::runtime_error("LightGBM prediction failed");
+        }
     }
 
-    std::vector<double> features_to_array(const CandidateFeatures& features) {
-        // CRITICAL: Order must match feature_list.json from training EXACTLY!
-        std::vector<double> arr;
-        arr.reserve(get_num_features());
-
-        // Feature order from feature_list.json:
-        arr.push_back(features.dtw_raw);                    // 0
-        arr.push_back(features.dtw_normalized_by_max);      // 1
-        arr.push_back(features.dtw_normalized_by_min);      // 2
-        arr.push_back(features.dtw_normalized_by_sum);      // 3
-        arr.push_back(features.len_swipe);                  // 4
-        arr.push_back(features.len_word);                   // 5
-        arr.push_back(features.path_length_ratio);          // 6
-        arr.push_back(features.word_length);                // 7
-        arr.push_back(features.lm_score);                   // 8
-        arr.push_back(features.faiss_distance);             // 9
-        arr.push_back(features.faiss_rank);                 // 10
-        arr.push_back(features.dtw_distance);               // 11
-        arr.push_back(features.dtw_rank);                   // 12
-        arr.push_back(features.lm_normalized);              // 13
-        arr.push_back(features.faiss_normalized);           // 14
-        arr.push_back(features.dtw_normalized);             // 15
-        arr.push_back(features.lm_zscore);                  // 16
-        arr.push_back(features.faiss_zscore);               // 17
-        arr.push_back(features.dtw_zscore);                 // 18
-        arr.push_back(features.lm_gap_to_best);             // 19
-        arr.push_back(features.faiss_gap_to_best);          // 20
-        arr.push_back(features.dtw_gap_to_best);            // 21
-        arr.push_back(features.lm_percentile);              // 22
-        arr.push_back(features.faiss_percentile);           // 23
-        arr.push_back(features.dtw_percentile);             // 24
-        arr.push_back(features.rank_agreement);             // 25
-        arr.push_back(features.min_rank);                   // 26
-        arr.push_back(features.is_top_faiss);               // 27
-        arr.push_back(features.is_top_dtw);                 // 28
-        arr.push_back(features.is_top_in_both);             // 29
-        arr.push_back(features.log_faiss_distance);         // 30
-        arr.push_back(features.log_dtw_distance);           // 31
-        arr.push_back(features.inv_faiss_distance);         // 32
-        arr.push_back(features.inv_dtw_distance);           // 33
-        arr.push_back(features.faiss_rank_reciprocal);      // 34
-        arr.push_back(features.dtw_rank_reciprocal);        // 35
-        arr.push_back(features.lm_faiss_interaction);       // 36
-        arr.push_back(features.lm_dtw_interaction);         // 37
-        arr.push_back(features.faiss_dtw_interaction);      // 38
-
-        return arr;
+    // Largest score difference between both backends on rows that straddle
+    // the split thresholds (values on, just below and above them, 0, NaN)
+    double validate_trees() {
+        const int probe_rows = 512;
+        std::vector<float> probes(probe_rows * FEATURE_COUNT);
+        uint32_t state = 12345;
+        for (size_t i = 0; i < probes.size(); ++i) {
+            float& value = probes[i];
+            const std::vector<double>& thresholds = trees.GetFeatureThresholds(static_cast<int>(i % FEATURE_COUNT));
+            state = state * 1664525u + 1013904223u;
+            uint32_t pick = state >> 8;
+            if (thresholds.empty() || pick % 16 == 0) {
+                value = (pick % 32 == 0) ? NAN : 0.0f;
+                continue;
+            }
+            double threshold = thresholds[(pick / 16) % thresholds.size()];
+            double offsets[3] = {0.0, -1e-3 * (std::fabs(threshold) + 1e-3), 1e-3 * (std::fabs(threshold) + 1e-3)};
+            value = static_cast<float>(threshold + offsets[(pick / 4) % 3]);
+        }
+
+        std::vector<double> expected(probe_rows), actual(probe_rows);
+        predict_booster(probes.data(), probe_rows, expected.data());
+        trees.Predict(probes.data(), probe_rows, FEATURE_COUNT, actual.data());
+
+        double max_error = 0.0;
+        for (int i = 0; i < probe_rows; ++i) {
+            max_error = std::max(max_error, std::fabs(expected[i] - actual[i]));
+        }
+        return max_error;
     }
+#endif
 };
 
 // Public interface implementation
@@ -93,106 +129,119 @@ LightGBMRanker::~LightGBMRanker() {
     delete pimpl;
 }
 
-bool LightGBMRanker::load_model(const std::string& model_path) {
+bool LightGBMRanker::load_model(const std::string& model_path, Backend backend) {
+    pimpl->is_loaded = false;
+    pimpl->load_message.clear();
+
+    std::string tree_error;
+    bool trees_ok = false;
+    if (backend != BACKEND_C_API) {
+        trees_ok = pimpl->trees.Load(model_path, tree_error);
+        if (trees_ok && pimpl->trees.GetFeatureCount() != FEATURE_COUNT) {
+            tree_error = "model feature count does not match the candidate batch";
+            trees_ok = false;
+        }
+    }
+
 #ifdef USE_LIGHTGBM
-    int num_iterations = 0;
-    int result = LGBM_BoosterCreateFromModelfile(model_path.c_str(), &num_iterations,
-                                                   reinterpret_cast<BoosterHandle*>(&pimpl->booster));
+    pimpl->free_booster();
+    bool booster_ok = pimpl->load_booster(model_path);
+
+    if (trees_ok && booster_ok) {
+        // Same split rule, tree order and transform: only rounding may differ
+        double max_error = pimpl->validate_trees();
+        char message[128];
+        snprintf(message, sizeof(message), "compiled trees validated against the C API, max score difference %g", max_error);
+        pimpl->load_message = message;
+        if (max_error > 1e-9 && backend == BACKEND_AUTO) {
+            pimpl->load_message += ", keeping the C API";
+            trees_ok = false;
+        }
+    } else if (!trees_ok && backend != BACKEND_C_API) {
+        pimpl->load_message = "compiled trees unavailable: " + tree_error;
+    }
 
-    if (result != 0) {
-        pimpl->is_loaded = false;
+    if (trees_ok && backend != BACKEND_C_API) {
+        pimpl->free_booster();  // Not needed any more
+        pimpl->backend = BACKEND_COMPILED;
+    } else if (booster_ok && backend != BACKEND_COMPILED) {
+        pimpl->backend = BACKEND_C_API;
+    } else {
         return false;
     }
+#else
+    if (!trees_ok) {
+        pimpl->load_message = (backend == BACKEND_C_API) ? "LightGBM support not compiled"
+                                                         : "compiled trees unavailable: " + tree_error;
+        return false;
+    }
+    pimpl->load_message = "compiled trees (LightGBM runtime not compiled, not validated)";
+    pimpl->backend = BACKEND_COMPILED;
+#endif
 
     pimpl->is_loaded = true;
     return true;
-#else
-    (void)model_path;
-    pimpl->is_loaded = false;
-    return false;
-#endif
 }
 
-bool LightGBMRanker::is_model_loaded() const {
-    return pimpl->is_loaded;
+LightGBMRanker::Backend LightGBMRanker::get_backend() const {
+    return pimpl->backend;
 }
 
-std::vector<float> LightGBMRanker::predict(const std::vector<CandidateFeatures>& candidates) {
-#ifdef USE_LIGHTGBM
-    if (!pimpl->is_loaded || pimpl->booster == nullptr) {
-        throw std::runtime_error("LightGBM model not loaded");
+const char* LightGBMRanker::get_backend_name() const {
+    switch (pimpl->backend) {
+        case BACKEND_C_API: return "LightGBM C API";
+        case BACKEND_COMPILED: return "compiled trees";
+        default: return "none";
     }
+}
 
-    if (candidates.empty()) {
-        return std::vector<float>();
-    }
+const std::string& LightGBMRanker::get_load_message() const {
+    return pimpl->load_message;
+}
 
-    int num_features = pimpl->get_num_features();
-    int num_candidates = candidates.size();
+bool LightGBMRanker::is_model_loaded() const {
+    return pimpl->is_loaded;
+}
 
-    // Prepare data in row-major format
-    std::vector<double> data;
-    data.reserve(num_candidates * num_features);
+void LightGBMRanker::predict(const CandidateBatch& batch, std::vector<double>& scores) {
+    if (!pimpl->is_loaded) {
+        throw std::runtime_error("LightGBM model not loaded");
+    }
 
-    for (const auto& cand : candidates) {
-        std::vector<double> feature_array = pimpl->features_to_array(cand);
-        data.insert(data.end(), feature_array.begin(), feature_array.end());
+    scores.resize(batch.GetRowCount());
+    if (batch.IsEmpty()) {
+        return;
     }
 
-    // Predict
-    int64_t out_len;
-    std::vector<double> out_result(num_candidates);
-
-    int result = LGBM_BoosterPredictForMat(
-        pimpl->booster,
-        data.data(),
-        C_API_DTYPE_FLOAT64,  // data type
-        num_candidates,       // nrow
-        num_features,         // ncol
-        1,                    // is_row_major
-        C_API_PREDICT_NORMAL, // predict_type
-        0,                    // start_iteration (0 means from start)
-        -1,                   // num_iteration (-1 means best iteration)
-        "",                   // parameter
-        &out_len,
-        out_result.data()
-    );
-
-    if (result != 0) {
-        throw std::runtime_error("LightGBM prediction failed");
+    if (pimpl->backend == BACKEND_COMPILED) {
+        pimpl->trees.Predict(batch.GetData(), batch.GetRowCount(), FEATURE_COUNT, scores.data());
+        return;
     }
 
-    // Convert double to float
-    std::vector<float> scores(out_result.begin(), out_result.end());
-    return scores;
+#ifdef USE_LIGHTGBM
+    pimpl->predict_booster(batch.GetData(), static_cast<int>(batch.GetRowCount()), scores.data());
 #else
-    (void)candidates;
     throw std::runtime_error("LightGBM support not compiled");
 #endif
 }
 
-std::vector<size_t> LightGBMRanker::rank_candidates(const std::vector<CandidateFeatures>& candidates) {
-    std::vector<float> scores = predict(candidates);
+void LightGBMRanker::rank_candidates(const CandidateBatch& batch, std::vector<size_t>& order) {
+    predict(batch, pimpl->scores);
+    const std::vector<double>& scores = pimpl->scores;
 
     // Create indices
-    std::vector<size_t> indices(scores.size());
-    for (size_t i = 0; i < indices.size(); ++i) {
-        indices[i] = i;
+    order.resize(scores.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
     }
 
     // Sort indices by score (descending - higher score is better)
-    std::sort(indices.begin(), indices.end(), [&scores](size_t a, size_t b) {
+    std::sort(order.begin(), order.end(), [&scores](size_t a, size_t b) {
         return scores[a] > scores[b];
     });
-
-    return indices;
 }
 
-std::string LightGBMRanker::get_best_candidate(const std::vector<CandidateFeatures>& candidates) {
-    if (candidates.empty()) {
-        return "";
-    }
-
-    std::vector<size_t> ranked = rank_candidates(candidates);
-    return candidates[ranked[0]].word;
+size_t LightGBMRanker::get_best_candidate(const CandidateBatch& batch) {
+    predict(batch, pimpl->scores);
+    return std::max_element(pimpl->scores.begin(), pimpl->scores.end()) - pimpl->scores.begin();
 }
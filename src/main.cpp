@@ -32,12 +32,10 @@ bool HeyEyeApp::OnInit()
     wxLogMessage("Combining ML swipe prediction and letter-by-letter input");
     wxLogMessage("");
 
-    // Initialize gaze tracker
+    // Initialize gaze tracker: mouse control right away, the Tobii device is
+    // discovered while the overlay is built and the models load
     m_gazeTracker = new GazeTracker();
-    if (!m_gazeTracker->Initialize()) {
-        wxLogWarning("Warning: Gaze tracker initialization failed");
-        wxLogMessage("Running in manual mode for testing");
-    }
+    m_gazeTracker->InitializeAsync();
 
     // Create overlay interface
     m_overlay = new EyeOverlay(m_gazeTracker, nullptr);
@@ -50,12 +48,8 @@ bool HeyEyeApp::OnInit()
     wxString assetsPath = wxGetCwd() + wxT("/assets");
     wxLogMessage("Looking for assets in: %s", assetsPath);
 
-    if (m_overlay->GetTextEngine()->Initialize(assetsPath)) {
-        wxLogMessage("Text engine initialized successfully");
-    } else {
-        wxLogWarning("Text engine initialization incomplete");
-        wxLogMessage("ML features may not be available");
-    }
+    // Models load on a thread pool, swipe prediction switches on when ready
+    m_overlay->GetTextEngine()->InitializeAsync(assetsPath);
 
     wxLogMessage("");
     wxLogMessage("=== Application Ready ===");
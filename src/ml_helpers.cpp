@@ -2,11 +2,20 @@
 
 #ifdef USE_FAISS
 #include "faiss/IndexFlat.h"
+#include <faiss/IndexHNSW.h>
+#include <faiss/IndexIVF.h>
+#include <faiss/IndexIVFFlat.h>
+#include <faiss/IndexIVFPQ.h>
+#include <faiss/IndexPQ.h>
+#include <faiss/IndexScalarQuantizer.h>
 #include <faiss/index_io.h>
 #endif
 
+#include <algorithm>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 // msgpack-c is header-only, so we can include it directly
 #ifdef USE_MSGPACK
@@ -53,16 +62,20 @@ load_vocab(const std::string& filepath) {
 
 faiss::Index* load_faiss_index(const std::string& filepath) {
 #ifdef USE_FAISS
-    faiss::Index* loadedIndex = faiss::read_index(filepath.c_str());
-
-    // Optional: Use dynamic_cast if you know the type and want to cast safely
-    auto* flatIndex = dynamic_cast<faiss::IndexFlatIP*>(loadedIndex);
-    if (flatIndex) {
-        std::cout << "Index loaded with " << flatIndex->ntotal << " vectors in it." << std::endl;
-        return flatIndex;
-    } else {
+    faiss::Index* loadedIndex = nullptr;
+    try {
+        loadedIndex = faiss::read_index(filepath.c_str());
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read FAISS index " << filepath << ": " << e.what() << std::endl;
         return nullptr;
     }
+
+    // The ranker was trained on inner product similarities (higher = closer)
+    if (loadedIndex->metric_type != faiss::METRIC_INNER_PRODUCT) {
+        std::cerr << "Warning: FAISS index does not use inner product, ranking features will be off" << std::endl;
+    }
+    std::cout << "Index loaded with " << loadedIndex->ntotal << " vectors in it." << std::endl;
+    return loadedIndex;
 #else
     (void)filepath;
     std::cerr << "FAISS support not compiled" << std::endl;
@@ -70,8 +83,79 @@ faiss::Index* load_faiss_index(const std::string& filepath) {
 #endif
 }
 
+std::string describe_faiss_index(const faiss::Index* index) {
+#ifdef USE_FAISS
+    if (!index) {
+        return "none";
+    }
+
+    // Most derived types first: IndexIVFPQ and IndexIVFScalarQuantizer are IndexIVF too
+    std::ostringstream out;
+    const faiss::IndexIVF* ivf = faiss::try_extract_index_ivf(index);
+    if (ivf) {
+        out << "IVF" << ivf->nlist << ",";
+        if (auto* ivfpq = dynamic_cast<const faiss::IndexIVFPQ*>(ivf)) {
+            out << "PQ" << ivfpq->pq.M << "x" << ivfpq->pq.nbits;
+        } else if (dynamic_cast<const faiss::IndexIVFScalarQuantizer*>(ivf)) {
+            out << "SQ";
+        } else if (dynamic_cast<const faiss::IndexIVFFlat*>(ivf)) {
+            out << "Flat";
+        } else {
+            out << "other";
+        }
+    } else if (dynamic_cast<const faiss::IndexHNSWFlat*>(index)) {
+        out << "HNSW,Flat";
+    } else if (dynamic_cast<const faiss::IndexHNSW*>(index)) {
+        out << "HNSW";
+    } else if (auto* pq = dynamic_cast<const faiss::IndexPQ*>(index)) {
+        out << "PQ" << pq->pq.M << "x" << pq->pq.nbits;
+    } else if (dynamic_cast<const faiss::IndexScalarQuantizer*>(index)) {
+        out << "SQ";
+    } else if (dynamic_cast<const faiss::IndexFlat*>(index)) {
+        out << "Flat";
+    } else {
+        out << "other";
+    }
+
+    out << " (" << (index->metric_type == faiss::METRIC_INNER_PRODUCT ? "IP" : "L2")
+        << ", " << index->ntotal << " x " << index->d << ")";
+    return out.str();
+#else
+    (void)index;
+    return "none";
+#endif
+}
+
+std::string set_faiss_search_parameters(faiss::Index* index, int nprobe, int ef_search) {
+#ifdef USE_FAISS
+    if (!index) {
+        return std::string();
+    }
+
+    // Set on the index itself: searches only run on the prediction thread
+    std::ostringstream out;
+    if (faiss::IndexIVF* ivf = faiss::try_extract_index_ivf(index)) {
+        if (nprobe > 0) {
+            ivf->nprobe = std::min<size_t>(nprobe, ivf->nlist);
+        }
+        out << "nprobe " << ivf->nprobe << " of " << ivf->nlist << " lists";
+    } else if (auto* hnsw = dynamic_cast<faiss::IndexHNSW*>(index)) {
+        if (ef_search > 0) {
+            hnsw->hnsw.efSearch = ef_search;
+        }
+        out << "efSearch " << hnsw->hnsw.efSearch;
+    }
+    return out.str();
+#else
+    (void)index;
+    (void)nprobe;
+    (void)ef_search;
+    return std::string();
+#endif
+}
+
 std::map<faiss::idx_t, float> search_faiss_index(
-    std::vector<float>* query,
+    const std::vector<float>* query,
     faiss::Index* index,
     int k_nearest
 ) {
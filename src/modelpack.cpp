@@ -0,0 +1,117 @@
+#include "modelpack.h"
+#include <cstdlib>
+#include <fstream>
+
+static std::string trim(const std::string& text) {
+    const char* spaces = " \t\r\n";
+    size_t begin = text.find_first_not_of(spaces);
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(spaces);
+    return text.substr(begin, end - begin + 1);
+}
+
+static bool file_exists(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return file.is_open();
+}
+
+bool ModelPack::IsKnownPrecision(const std::string& precision)
+{
+    return precision == "fp32" || precision == "fp16" ||
+           precision == "int8-dynamic" || precision == "int8-static";
+}
+
+ModelPack ModelPack::Default(const std::string& assetsDir)
+{
+    ModelPack pack;
+    pack.name = "default";
+    pack.precision = "fp32";
+    pack.embeddings = "fp32";
+    pack.encoderPath = assetsDir + "/swipe_encoder.onnx";
+    pack.indexPath = assetsDir + "/index.faiss";
+    return pack;
+}
+
+bool ModelPack::Load(const std::string& assetsDir, const std::string& name, ModelPack& pack, std::string& error)
+{
+    pack = ModelPack();
+
+    // A pack is one directory below packs/, not a path
+    if (name.empty() || name == "." || name == ".." || name.find_first_of("/\\:") != std::string::npos) {
+        error = "invalid model pack name '" + name + "'";
+        return false;
+    }
+
+    const std::string directory = assetsDir + "/packs/" + name;
+    const std::string manifestPath = directory + "/pack.ini";
+    std::ifstream manifest(manifestPath);
+    if (!manifest.is_open()) {
+        error = "cannot open " + manifestPath;
+        return false;
+    }
+
+    pack.name = name;
+    pack.precision = "fp32";
+    pack.embeddings = "fp32";
+    std::string encoderFile = "swipe_encoder.onnx";
+    std::string indexFile = "index.faiss";
+    int format = 0;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(manifest, line)) {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') {
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            error = manifestPath + ":" + std::to_string(lineNumber) + ": expected key = value";
+            return false;
+        }
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+
+        if (key == "format") {
+            format = std::atoi(value.c_str());
+        } else if (key == "version") {
+            pack.version = value;
+        } else if (key == "precision") {
+            pack.precision = value;
+        } else if (key == "embeddings") {
+            pack.embeddings = value;
+        } else if (key == "encoder") {
+            encoderFile = value;
+        } else if (key == "index") {
+            indexFile = value;
+        } else {
+            error = manifestPath + ":" + std::to_string(lineNumber) + ": unknown key '" + key + "'";
+            return false;
+        }
+    }
+
+    if (format != FORMAT_VERSION) {
+        error = manifestPath + ": unsupported pack format " + std::to_string(format);
+        return false;
+    }
+    if (!IsKnownPrecision(pack.precision)) {
+        error = manifestPath + ": unknown precision '" + pack.precision + "'";
+        return false;
+    }
+
+    pack.encoderPath = directory + "/" + encoderFile;
+    pack.indexPath = directory + "/" + indexFile;
+    if (!file_exists(pack.encoderPath)) {
+        error = "model pack encoder not found: " + pack.encoderPath;
+        return false;
+    }
+    if (!file_exists(pack.indexPath)) {
+        error = "model pack index not found: " + pack.indexPath;
+        return false;
+    }
+    return true;
+}
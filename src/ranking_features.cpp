@@ -1,8 +1,15 @@
 #include "ranking_features.h"
+#include "candidatebatch.h"
+#include "vocabulary.h"
+#include "dtwengine.h"
+#include "dtwprefixcache.h"
+#include "threadpool.h"
+#include "trace.h"
 #include <cmath>
 #include <algorithm>
 #include <limits>
-#include <set>
+#include <unordered_set>
+#include <queue>
 #include <cstring>
 
 
@@ -34,12 +41,23 @@ void init_keyboard_coords() {
 }
 
 // DTW distance computation for multivariate sequences
-// Optimized version using two rows instead of full matrix to save memory
 float dtw_multivariate(const std::vector<std::pair<float, float>>& A,
                        const std::vector<std::pair<float, float>>& B,
                        int window) {
+    std::vector<float> points;
+    points.reserve(B.size() * 2);
+    for (const auto& point : B) {
+        points.push_back(point.first);
+        points.push_back(point.second);
+    }
+    return dtw_multivariate(A, points.data(), static_cast<int>(B.size()), window);
+}
+
+// Optimized version using two rows instead of full matrix to save memory
+float dtw_multivariate(const std::vector<std::pair<float, float>>& A,
+                       const float* B, int m,
+                       int window) {
     int n = A.size();
-    int m = B.size();
 
     if (n == 0 || m == 0) return 0.0f;
 
@@ -62,8 +80,8 @@ float dtw_multivariate(const std::vector<std::pair<float, float>>& A,
 
         for (int j = jstart; j <= jend; ++j) {
             // Euclidean distance in 2D
-            float dx = A[i-1].first - B[j-1].first;
-            float dy = A[i-1].second - B[j-1].second;
+            float dx = A[i-1].first - B[2*(j-1)];
+            float dy = A[i-1].second - B[2*(j-1) + 1];
             float cost = std::sqrt(dx*dx + dy*dy);
 
             float min_val = std::min(prev_row[j], curr_row[j-1]);
@@ -92,158 +110,275 @@ std::vector<std::pair<float, float>> get_word_path(const std::string& word) {
 }
 
 // Forward declaration - implemented in ranking_features_helper.cpp
-CandidateFeatures compute_enhanced_features(
-    const std::string& word,
-    float lm_score,
-    float faiss_distance,
-    int faiss_rank,
-    float dtw_distance,
-    int dtw_rank,
-    const std::vector<float>& lm_scores_all,
-    const std::vector<float>& faiss_distances_all,
-    const std::vector<float>& dtw_distances_all,
-    float dtw_raw,
-    float dtw_normalized_by_max,
-    float dtw_normalized_by_min,
-    float dtw_normalized_by_sum,
-    int len_swipe,
-    int len_word,
-    float path_length_ratio,
-    int word_length
-);
+void compute_batch_features(CandidateBatch& batch, ThreadPool* pool);
+
+// Expand FAISS results into unique candidate words
+std::vector<CandidateRef> collect_candidates(
+    const std::map<faiss::idx_t, float>& faiss_results,
+    const Vocabulary& vocab
+) {
+    std::vector<CandidateRef> candidates;
+    candidates.reserve(faiss_results.size() * 2);
+    std::unordered_set<uint32_t> seen_words;
+    seen_words.reserve(faiss_results.size() * 2);
+
+    int faiss_rank = 1;
+    for (const auto& faiss_pair : faiss_results) {
+        faiss::idx_t vocab_idx = faiss_pair.first;
+
+        if (vocab.HasKey(vocab_idx)) {
+            for (uint32_t word_id = vocab.GetKeyWordBegin(vocab_idx); word_id < vocab.GetKeyWordEnd(vocab_idx); ++word_id) {
+                // Same spelling under an earlier key: keep the first (best ranked) one
+                if (!seen_words.insert(vocab.GetCanonicalWord(word_id)).second) {
+                    continue;
+                }
+
+                CandidateRef candidate;
+                candidate.word_id = word_id;
+                candidate.vocab_idx = vocab_idx;
+                candidate.faiss_distance = faiss_pair.second;
+                candidate.faiss_rank = faiss_rank;
+                candidates.push_back(candidate);
+            }
+        }
+
+        faiss_rank++;
+    }
+
+    return candidates;
+}
 
 // Compute all features for candidates given the raw inputs
-std::vector<CandidateFeatures> compute_all_features(
+void compute_all_features(
     const std::vector<std::pair<float, float>>& swipe_path,
-    const std::map<faiss::idx_t, float>& faiss_results,
-    const std::map<int, std::vector<std::string>>* vocab,
-    const std::vector<std::string>* vocabKeys,
+    const Vocabulary& vocab,
+    const std::vector<CandidateRef>& candidates,
     const std::vector<float>& lm_scores,
-    const std::vector<std::string>& candidate_words
+    CandidateBatch& batch,
+    const DtwOptions& dtw_options,
+    ThreadPool* pool,
+    DtwPrefixCache* prefix_cache
 ) {
-    // First pass: collect all candidate data for normalization
-    struct TempCandidateData {
-        std::string word;
-        float lm_score;
-        float faiss_distance;
-        int faiss_rank;
-        float dtw_raw;
-        float dtw_normalized_by_max;
-        float dtw_normalized_by_min;
-        float dtw_normalized_by_sum;
-        int len_swipe;
+    TRACE_SCOPE("features");
+    batch.Clear();
+
+    int len_swipe = swipe_path.size();
+
+    // Words of one key are consecutive and share its path, DTW runs once per key
+    struct KeyRun {
+        size_t begin;  // Candidate range [begin, end)
+        size_t end;
         int len_word;
-        float path_length_ratio;
-        int word_length;
+        float dtw_raw;
     };
+    std::vector<KeyRun> runs;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (runs.empty() || candidates[i].vocab_idx != candidates[runs.back().begin].vocab_idx) {
+            runs.push_back({i, i + 1, 0, 0.0f});
+        } else {
+            runs.back().end = i + 1;
+        }
+    }
 
-    std::vector<TempCandidateData> temp_candidates;
-    std::set<std::string> seen_words;
+    auto normalized_by_max = [len_swipe](float dtw_raw, int len_word) {
+        int max_len = std::max(len_swipe, len_word);
+        return (max_len > 0) ? (dtw_raw / max_len) : 0.0f;
+    };
 
-    int len_swipe = swipe_path.size();
-    int faiss_rank = 1;
-    size_t lm_idx = 0;
+    // Rows left by earlier prefixes of this swipe (unbounded DTW only, a band
+    // depends on the final length). Entries are created here, serially.
+    std::vector<DtwPrefixCache::Entry*> cached_rows;
+    if (prefix_cache && dtw_options.window < 0) {
+        prefix_cache->Prepare(swipe_path);
+        cached_rows.resize(runs.size());
+        for (size_t r = 0; r < runs.size(); ++r) {
+            cached_rows[r] = &prefix_cache->GetEntry(candidates[runs[r].begin].vocab_idx);
+        }
+    }
 
-    for (const auto& faiss_pair : faiss_results) {
-        int vocab_idx = faiss_pair.first;
-        float faiss_distance = faiss_pair.second;
+    // Pruning keeps the prune_top_k best dtw_normalized_by_max values of the
+    // chunk; a key that cannot beat the worst of them is dropped (INF)
+    const size_t prune_top_k = dtw_options.prune_top_k > 0 ? dtw_options.prune_top_k : 0;
+    auto compute_dtw = [&](size_t first, size_t last) {
+        DtwEngine dtw;  // Scratch buffers are per thread
+        dtw.SetQuery(swipe_path, dtw_options.window);
+        std::priority_queue<float> best_dtw;
+
+        for (size_t r = first; r < last; ++r) {
+            KeyRun& run = runs[r];
+            size_t path_points = 0;
+            const float* word_path = vocab.GetKeyPath(candidates[run.begin].vocab_idx, path_points);
+            run.len_word = static_cast<int>(path_points);
+
+            if (!cached_rows.empty()) {
+                // Exact distance; above the threshold it is dropped like an
+                // abandoned one, which leaves the pruned set unchanged
+                run.dtw_raw = DtwPrefixCache::Extend(*cached_rows[r], swipe_path, word_path, run.len_word);
+                if (prune_top_k > 0 && best_dtw.size() >= prune_top_k &&
+                    run.dtw_raw > best_dtw.top() * std::max(len_swipe, run.len_word)) {
+                    run.dtw_raw = DtwEngine::INF;
+                }
+            } else if (prune_top_k > 0 && best_dtw.size() >= prune_top_k) {
+                float threshold = best_dtw.top() * std::max(len_swipe, run.len_word);
+                run.dtw_raw = dtw.DistanceIfBelow(word_path, run.len_word, threshold);
+            } else {
+                run.dtw_raw = dtw.Distance(word_path, run.len_word);
+            }
 
-        const auto& words_for_idx = vocab->at(vocab_idx);
+            if (prune_top_k > 0 && run.dtw_raw < DtwEngine::INF) {
+                float value = normalized_by_max(run.dtw_raw, run.len_word);
+                for (size_t word = run.begin; word < run.end; ++word) {
+                    best_dtw.push(value);
+                    if (best_dtw.size() > prune_top_k) {
+                        best_dtw.pop();
+                    }
+                }
+            }
+        }
+    };
 
-        for (const std::string& word : words_for_idx) {
-            if (seen_words.count(word) > 0) {
-                continue;
+    // Chunks are the same with or without a pool, so is the pruned set;
+    // pruning needs enough keys per chunk to find a useful threshold
+    const size_t dtw_grain = std::max<size_t>(16, 4 * prune_top_k);
+    {
+        TRACE_SCOPE("dtw");
+        if (pool && runs.size() > dtw_grain) {
+            pool->ParallelFor(runs.size(), dtw_grain, compute_dtw);
+        } else {
+            for (size_t first = 0; first < runs.size(); first += dtw_grain) {
+                compute_dtw(first, std::min(runs.size(), first + dtw_grain));
             }
-            seen_words.insert(word);
-
-            // Get word path and compute DTW
-            std::vector<std::pair<float, float>> word_path = get_word_path(vocabKeys->at(vocab_idx));
-            int len_word = word_path.size();
-
-            float dtw_raw = dtw_multivariate(swipe_path, word_path);
-
-            int max_len = std::max(len_swipe, len_word);
-            int min_len = std::min(len_swipe, len_word);
-            int sum_len = len_swipe + len_word;
-
-            float dtw_normalized_by_max = (max_len > 0) ? (dtw_raw / max_len) : 0.0f;
-            float dtw_normalized_by_min = (min_len > 0) ? (dtw_raw / min_len) : 0.0f;
-            float dtw_normalized_by_sum = (sum_len > 0) ? (dtw_raw / sum_len) : 0.0f;
-
-            float path_length_ratio = (len_word > 0) ? ((float)len_swipe / len_word) : 0.0f;
-            int word_length = word.length();
-
-            float lm_score = (lm_idx < lm_scores.size()) ? lm_scores[lm_idx++] : 0.0f;
-
-            TempCandidateData temp;
-            temp.word = word;
-            temp.lm_score = lm_score;
-            temp.faiss_distance = faiss_distance;
-            temp.faiss_rank = faiss_rank;
-            temp.dtw_raw = dtw_raw;
-            temp.dtw_normalized_by_max = dtw_normalized_by_max;
-            temp.dtw_normalized_by_min = dtw_normalized_by_min;
-            temp.dtw_normalized_by_sum = dtw_normalized_by_sum;
-            temp.len_swipe = len_swipe;
-            temp.len_word = len_word;
-            temp.path_length_ratio = path_length_ratio;
-            temp.word_length = word_length;
-
-            temp_candidates.push_back(temp);
         }
+    }
 
-        faiss_rank++;
+    // Chunks prune against their own top k: keep exactly the words within the
+    // global top k (ties included) so the result is the same as a serial scan
+    float prune_cutoff = DtwEngine::INF;
+    if (prune_top_k > 0) {
+        std::vector<float> kept;
+        for (const KeyRun& run : runs) {
+            if (run.dtw_raw < DtwEngine::INF) {
+                kept.insert(kept.end(), run.end - run.begin, normalized_by_max(run.dtw_raw, run.len_word));
+            }
+        }
+        if (kept.size() > prune_top_k) {
+            std::nth_element(kept.begin(), kept.begin() + (prune_top_k - 1), kept.end());
+            prune_cutoff = kept[prune_top_k - 1];
+        }
     }
 
+    for (const KeyRun& run : runs) {
+        const float dtw_raw = run.dtw_raw;
+        const int len_word = run.len_word;
+        if (dtw_raw >= DtwEngine::INF) {
+            continue;  // Pruned
+        }
+
+        int min_len = std::min(len_swipe, len_word);
+        int sum_len = len_swipe + len_word;
+
+        float dtw_normalized_by_max = normalized_by_max(dtw_raw, len_word);
+        float dtw_normalized_by_min = (min_len > 0) ? (dtw_raw / min_len) : 0.0f;
+        float dtw_normalized_by_sum = (sum_len > 0) ? (dtw_raw / sum_len) : 0.0f;
+        float path_length_ratio = (len_word > 0) ? ((float)len_swipe / len_word) : 0.0f;
+
+        if (dtw_normalized_by_max > prune_cutoff) {
+            continue;
+        }
+
+        for (size_t i = run.begin; i < run.end; ++i) {
+            const CandidateRef& candidate = candidates[i];
+
+            float* row = batch.GetRow(batch.AddRow(candidate.word_id));
+            row[FEATURE_DTW_RAW] = dtw_raw;
+            row[FEATURE_DTW_NORMALIZED_BY_MAX] = dtw_normalized_by_max;
+            row[FEATURE_DTW_NORMALIZED_BY_MIN] = dtw_normalized_by_min;
+            row[FEATURE_DTW_NORMALIZED_BY_SUM] = dtw_normalized_by_sum;
+            row[FEATURE_LEN_SWIPE] = len_swipe;
+            row[FEATURE_LEN_WORD] = len_word;
+            row[FEATURE_PATH_LENGTH_RATIO] = path_length_ratio;
+            row[FEATURE_WORD_LENGTH] = vocab.GetWord(candidate.word_id).length();
+            row[FEATURE_LM_SCORE] = (i < lm_scores.size()) ? lm_scores[i] : 0.0f;
+            row[FEATURE_FAISS_DISTANCE] = candidate.faiss_distance;
+            row[FEATURE_FAISS_RANK] = candidate.faiss_rank;
+            row[FEATURE_DTW_DISTANCE] = dtw_normalized_by_max;
+        }
+    }
+
+    const size_t count = batch.GetRowCount();
+
     // Sort by DTW to assign DTW ranks
-    std::vector<size_t> dtw_indices(temp_candidates.size());
+    std::vector<size_t> dtw_indices(count);
     for (size_t i = 0; i < dtw_indices.size(); ++i) {
         dtw_indices[i] = i;
     }
     std::sort(dtw_indices.begin(), dtw_indices.end(), [&](size_t a, size_t b) {
-        return temp_candidates[a].dtw_normalized_by_max < temp_candidates[b].dtw_normalized_by_max;
+        return batch.Get(a, FEATURE_DTW_DISTANCE) < batch.Get(b, FEATURE_DTW_DISTANCE);
     });
-
-    std::vector<int> dtw_ranks(temp_candidates.size());
     for (size_t i = 0; i < dtw_indices.size(); ++i) {
-        dtw_ranks[dtw_indices[i]] = i + 1;
+        batch.GetRow(dtw_indices[i])[FEATURE_DTW_RANK] = i + 1;
     }
 
-    // Extract arrays for normalization
-    std::vector<float> lm_scores_all, faiss_distances_all, dtw_distances_all;
-    for (const auto& cand : temp_candidates) {
-        lm_scores_all.push_back(cand.lm_score);
-        faiss_distances_all.push_back(cand.faiss_distance);
-        dtw_distances_all.push_back(cand.dtw_normalized_by_max);
-    }
+    // Normalizations, percentiles and the other batch-relative features
+    compute_batch_features(batch, pool);
+}
 
-    // Second pass: compute full features
-    std::vector<CandidateFeatures> result;
-    for (size_t i = 0; i < temp_candidates.size(); ++i) {
-        const auto& temp = temp_candidates[i];
-
-        CandidateFeatures features = compute_enhanced_features(
-            temp.word,
-            temp.lm_score,
-            temp.faiss_distance,
-            temp.faiss_rank,
-            temp.dtw_normalized_by_max,
-            dtw_ranks[i],
-            lm_scores_all,
-            faiss_distances_all,
-            dtw_distances_all,
-            temp.dtw_raw,
-            temp.dtw_normalized_by_max,
-            temp.dtw_normalized_by_min,
-            temp.dtw_normalized_by_sum,
-            temp.len_swipe,
-            temp.len_word,
-            temp.path_length_ratio,
-            temp.word_length
-        );
-
-        result.push_back(features);
+std::vector<CandidateFeatures> compute_all_features(
+    const std::vector<std::pair<float, float>>& swipe_path,
+    const Vocabulary& vocab,
+    const std::vector<CandidateRef>& candidates,
+    const std::vector<float>& lm_scores,
+    const DtwOptions& dtw_options,
+    ThreadPool* pool,
+    DtwPrefixCache* prefix_cache
+) {
+    CandidateBatch batch;
+    compute_all_features(swipe_path, vocab, candidates, lm_scores, batch, dtw_options, pool, prefix_cache);
+
+    std::vector<CandidateFeatures> result(batch.GetRowCount());
+    for (size_t i = 0; i < result.size(); ++i) {
+        const float* row = batch.GetRow(i);
+        CandidateFeatures& features = result[i];
+        features.word = std::string(vocab.GetWord(batch.GetWordId(i)));
+        features.lm_score = row[FEATURE_LM_SCORE];
+        features.faiss_distance = row[FEATURE_FAISS_DISTANCE];
+        features.faiss_rank = static_cast<int>(row[FEATURE_FAISS_RANK]);
+        features.dtw_distance = row[FEATURE_DTW_DISTANCE];
+        features.dtw_rank = static_cast<int>(row[FEATURE_DTW_RANK]);
+        features.lm_normalized = row[FEATURE_LM_NORMALIZED];
+        features.faiss_normalized = row[FEATURE_FAISS_NORMALIZED];
+        features.dtw_normalized = row[FEATURE_DTW_NORMALIZED];
+        features.lm_zscore = row[FEATURE_LM_ZSCORE];
+        features.faiss_zscore = row[FEATURE_FAISS_ZSCORE];
+        features.dtw_zscore = row[FEATURE_DTW_ZSCORE];
+        features.lm_gap_to_best = row[FEATURE_LM_GAP_TO_BEST];
+        features.faiss_gap_to_best = row[FEATURE_FAISS_GAP_TO_BEST];
+        features.dtw_gap_to_best = row[FEATURE_DTW_GAP_TO_BEST];
+        features.lm_percentile = row[FEATURE_LM_PERCENTILE];
+        features.faiss_percentile = row[FEATURE_FAISS_PERCENTILE];
+        features.dtw_percentile = row[FEATURE_DTW_PERCENTILE];
+        features.rank_agreement = static_cast<int>(row[FEATURE_RANK_AGREEMENT]);
+        features.min_rank = static_cast<int>(row[FEATURE_MIN_RANK]);
+        features.is_top_faiss = row[FEATURE_IS_TOP_FAISS];
+        features.is_top_dtw = row[FEATURE_IS_TOP_DTW];
+        features.is_top_in_both = row[FEATURE_IS_TOP_IN_BOTH];
+        features.log_faiss_distance = row[FEATURE_LOG_FAISS_DISTANCE];
+        features.log_dtw_distance = row[FEATURE_LOG_DTW_DISTANCE];
+        features.inv_faiss_distance = row[FEATURE_INV_FAISS_DISTANCE];
+        features.inv_dtw_distance = row[FEATURE_INV_DTW_DISTANCE];
+        features.faiss_rank_reciprocal = row[FEATURE_FAISS_RANK_RECIPROCAL];
+        features.dtw_rank_reciprocal = row[FEATURE_DTW_RANK_RECIPROCAL];
+        features.lm_faiss_interaction = row[FEATURE_LM_FAISS_INTERACTION];
+        features.lm_dtw_interaction = row[FEATURE_LM_DTW_INTERACTION];
+        features.faiss_dtw_interaction = row[FEATURE_FAISS_DTW_INTERACTION];
+        features.dtw_raw = row[FEATURE_DTW_RAW];
+        features.dtw_normalized_by_max = row[FEATURE_DTW_NORMALIZED_BY_MAX];
+        features.dtw_normalized_by_min = row[FEATURE_DTW_NORMALIZED_BY_MIN];
+        features.dtw_normalized_by_sum = row[FEATURE_DTW_NORMALIZED_BY_SUM];
+        features.len_swipe = static_cast<int>(row[FEATURE_LEN_SWIPE]);
+        features.len_word = static_cast<int>(row[FEATURE_LEN_WORD]);
+        features.path_length_ratio = row[FEATURE_PATH_LENGTH_RATIO];
+        features.word_length = static_cast<int>(row[FEATURE_WORD_LENGTH]);
     }
-
     return result;
 }
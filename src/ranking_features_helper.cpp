@@ -1,123 +1,142 @@
 #include "ranking_features.h"
+#include "candidatebatch.h"
+#include "threadpool.h"
 #include <cmath>
 #include <algorithm>
 
-// Helper function to compute enhanced features for a single candidate
-CandidateFeatures compute_enhanced_features(
-    const std::string& word,
-    float lm_score,
-    float faiss_distance,
-    int faiss_rank,
-    float dtw_distance,
-    int dtw_rank,
-    const std::vector<float>& lm_scores_all,
-    const std::vector<float>& faiss_distances_all,
-    const std::vector<float>& dtw_distances_all,
-    float dtw_raw,
-    float dtw_normalized_by_max,
-    float dtw_normalized_by_min,
-    float dtw_normalized_by_sum,
-    int len_swipe,
-    int len_word,
-    float path_length_ratio,
-    int word_length
-) {
-    CandidateFeatures features;
-    features.word = word;
+namespace {
+
+// Statistics of one feature column over all candidates of the swipe
+struct ColumnStats {
+    float min;
+    float max;
+    float mean;
+    float std;
+    std::vector<float> sorted;  // For percentiles
+};
+
+// Same summation order as the former per-candidate loops, so the values are
+// bit-identical to what the ranker was trained with
+void compute_column_stats(const std::vector<float>& values, ColumnStats& stats) {
+    stats.min = *std::min_element(values.begin(), values.end());
+    stats.max = *std::max_element(values.begin(), values.end());
+
+    float sum = 0.0f;
+    for (float v : values) sum += v;
+    stats.mean = sum / values.size();
+
+    float var = 0.0f;
+    for (float v : values) var += (v - stats.mean) * (v - stats.mean);
+    stats.std = std::sqrt(var / values.size());
+
+    stats.sorted = values;
+    std::sort(stats.sorted.begin(), stats.sorted.end());
+}
 
-    const float epsilon = 1e-6f;
+// Fraction of the column strictly below / above value
+float fraction_below(const ColumnStats& stats, float value) {
+    size_t count = std::lower_bound(stats.sorted.begin(), stats.sorted.end(), value) - stats.sorted.begin();
+    return (float)count / stats.sorted.size();
+}
 
-    // Core features
-    features.lm_score = lm_score;
-    features.faiss_distance = faiss_distance;
-    features.faiss_rank = faiss_rank;
-    features.dtw_distance = dtw_distance;
-    features.dtw_rank = dtw_rank;
+float fraction_above(const ColumnStats& stats, float value) {
+    size_t count = stats.sorted.end() - std::upper_bound(stats.sorted.begin(), stats.sorted.end(), value);
+    return (float)count / stats.sorted.size();
+}
 
-    // Min-max normalization
-    float lm_min = *std::min_element(lm_scores_all.begin(), lm_scores_all.end());
-    float lm_max = *std::max_element(lm_scores_all.begin(), lm_scores_all.end());
-    features.lm_normalized = (lm_score - lm_min) / (lm_max - lm_min + epsilon);
+// Enhanced features of a single candidate. Reads the core columns (LM score,
+// FAISS distance and rank, DTW distance and rank) from the row and writes the
+// derived ones next to them.
+void compute_enhanced_features(
+    float* row,
+    const ColumnStats& lm,
+    const ColumnStats& faiss,
+    const ColumnStats& dtw
+) {
+    const float lm_score = row[FEATURE_LM_SCORE];
+    const float faiss_distance = row[FEATURE_FAISS_DISTANCE];
+    const int faiss_rank = static_cast<int>(row[FEATURE_FAISS_RANK]);
+    const float dtw_distance = row[FEATURE_DTW_DISTANCE];
+    const int dtw_rank = static_cast<int>(row[FEATURE_DTW_RANK]);
 
-    float faiss_min = *std::min_element(faiss_distances_all.begin(), faiss_distances_all.end());
-    float faiss_max = *std::max_element(faiss_distances_all.begin(), faiss_distances_all.end());
-    features.faiss_normalized = (faiss_distance - faiss_min) / (faiss_max - faiss_min + epsilon);
+    const float epsilon = 1e-6f;
 
-    float dtw_min = *std::min_element(dtw_distances_all.begin(), dtw_distances_all.end());
-    float dtw_max = *std::max_element(dtw_distances_all.begin(), dtw_distances_all.end());
-    features.dtw_normalized = (dtw_distance - dtw_min) / (dtw_max - dtw_min + epsilon);
+    // Min-max normalization
+    row[FEATURE_LM_NORMALIZED] = (lm_score - lm.min) / (lm.max - lm.min + epsilon);
+    row[FEATURE_FAISS_NORMALIZED] = (faiss_distance - faiss.min) / (faiss.max - faiss.min + epsilon);
+    row[FEATURE_DTW_NORMALIZED] = (dtw_distance - dtw.min) / (dtw.max - dtw.min + epsilon);
 
     // Z-score normalization
-    float lm_sum = 0.0f, faiss_sum = 0.0f, dtw_sum = 0.0f;
-    for (float v : lm_scores_all) lm_sum += v;
-    for (float v : faiss_distances_all) faiss_sum += v;
-    for (float v : dtw_distances_all) dtw_sum += v;
-
-    float lm_mean = lm_sum / lm_scores_all.size();
-    float faiss_mean = faiss_sum / faiss_distances_all.size();
-    float dtw_mean = dtw_sum / dtw_distances_all.size();
-
-    float lm_var = 0.0f, faiss_var = 0.0f, dtw_var = 0.0f;
-    for (float v : lm_scores_all) lm_var += (v - lm_mean) * (v - lm_mean);
-    for (float v : faiss_distances_all) faiss_var += (v - faiss_mean) * (v - faiss_mean);
-    for (float v : dtw_distances_all) dtw_var += (v - dtw_mean) * (v - dtw_mean);
-
-    float lm_std = std::sqrt(lm_var / lm_scores_all.size());
-    float faiss_std = std::sqrt(faiss_var / faiss_distances_all.size());
-    float dtw_std = std::sqrt(dtw_var / dtw_distances_all.size());
-
-    features.lm_zscore = (lm_score - lm_mean) / (lm_std + epsilon);
-    features.faiss_zscore = (faiss_distance - faiss_mean) / (faiss_std + epsilon);
-    features.dtw_zscore = (dtw_distance - dtw_mean) / (dtw_std + epsilon);
+    row[FEATURE_LM_ZSCORE] = (lm_score - lm.mean) / (lm.std + epsilon);
+    row[FEATURE_FAISS_ZSCORE] = (faiss_distance - faiss.mean) / (faiss.std + epsilon);
+    row[FEATURE_DTW_ZSCORE] = (dtw_distance - dtw.mean) / (dtw.std + epsilon);
 
     // Gap to best
-    features.lm_gap_to_best = lm_max - lm_score;
-    features.faiss_gap_to_best = faiss_distance - faiss_min;
-    features.dtw_gap_to_best = dtw_distance - dtw_min;
-
-    // Percentile features
-    int lm_count = 0, faiss_count = 0, dtw_count = 0;
-    for (float v : lm_scores_all) if (v < lm_score) lm_count++;
-    for (float v : faiss_distances_all) if (v > faiss_distance) faiss_count++;
-    for (float v : dtw_distances_all) if (v > dtw_distance) dtw_count++;
+    row[FEATURE_LM_GAP_TO_BEST] = lm.max - lm_score;
+    row[FEATURE_FAISS_GAP_TO_BEST] = faiss_distance - faiss.min;
+    row[FEATURE_DTW_GAP_TO_BEST] = dtw_distance - dtw.min;
 
-    features.lm_percentile = (float)lm_count / lm_scores_all.size();
-    features.faiss_percentile = (float)faiss_count / faiss_distances_all.size();
-    features.dtw_percentile = (float)dtw_count / dtw_distances_all.size();
+    // Percentile features (higher LM score, lower distances are better)
+    row[FEATURE_LM_PERCENTILE] = fraction_below(lm, lm_score);
+    row[FEATURE_FAISS_PERCENTILE] = fraction_above(faiss, faiss_distance);
+    row[FEATURE_DTW_PERCENTILE] = fraction_above(dtw, dtw_distance);
 
     // Rank agreement features
-    features.rank_agreement = std::abs(faiss_rank - dtw_rank);
-    features.min_rank = std::min(faiss_rank, dtw_rank);
-    features.is_top_faiss = (faiss_rank == 1) ? 1.0f : 0.0f;
-    features.is_top_dtw = (dtw_rank == 1) ? 1.0f : 0.0f;
-    features.is_top_in_both = (faiss_rank == 1 && dtw_rank == 1) ? 1.0f : 0.0f;
+    row[FEATURE_RANK_AGREEMENT] = std::abs(faiss_rank - dtw_rank);
+    row[FEATURE_MIN_RANK] = std::min(faiss_rank, dtw_rank);
+    row[FEATURE_IS_TOP_FAISS] = (faiss_rank == 1) ? 1.0f : 0.0f;
+    row[FEATURE_IS_TOP_DTW] = (dtw_rank == 1) ? 1.0f : 0.0f;
+    row[FEATURE_IS_TOP_IN_BOTH] = (faiss_rank == 1 && dtw_rank == 1) ? 1.0f : 0.0f;
 
     // Log and inverse features
-    features.log_faiss_distance = std::log(faiss_distance + epsilon);
-    features.log_dtw_distance = std::log(dtw_distance + epsilon);
-    features.inv_faiss_distance = 1.0f / (faiss_distance + epsilon);
-    features.inv_dtw_distance = 1.0f / (dtw_distance + epsilon);
+    row[FEATURE_LOG_FAISS_DISTANCE] = std::log(faiss_distance + epsilon);
+    row[FEATURE_LOG_DTW_DISTANCE] = std::log(dtw_distance + epsilon);
+    row[FEATURE_INV_FAISS_DISTANCE] = 1.0f / (faiss_distance + epsilon);
+    row[FEATURE_INV_DTW_DISTANCE] = 1.0f / (dtw_distance + epsilon);
 
     // Rank reciprocals
-    features.faiss_rank_reciprocal = 1.0f / faiss_rank;
-    features.dtw_rank_reciprocal = 1.0f / dtw_rank;
+    row[FEATURE_FAISS_RANK_RECIPROCAL] = 1.0f / faiss_rank;
+    row[FEATURE_DTW_RANK_RECIPROCAL] = 1.0f / dtw_rank;
 
     // Interaction features
-    features.lm_faiss_interaction = lm_score * faiss_distance;
-    features.lm_dtw_interaction = lm_score * dtw_distance;
-    features.faiss_dtw_interaction = faiss_distance * dtw_distance;
-
-    // Raw DTW metrics
-    features.dtw_raw = dtw_raw;
-    features.dtw_normalized_by_max = dtw_normalized_by_max;
-    features.dtw_normalized_by_min = dtw_normalized_by_min;
-    features.dtw_normalized_by_sum = dtw_normalized_by_sum;
-
-    // Path metrics
-    features.len_swipe = len_swipe;
-    features.len_word = len_word;
-    features.path_length_ratio = path_length_ratio;
-    features.word_length = word_length;
-
-    return features;
+    row[FEATURE_LM_FAISS_INTERACTION] = lm_score * faiss_distance;
+    row[FEATURE_LM_DTW_INTERACTION] = lm_score * dtw_distance;
+    row[FEATURE_FAISS_DTW_INTERACTION] = faiss_distance * dtw_distance;
+}
+
+} // namespace
+
+// Batch-relative features of every row: statistics are computed once per
+// swipe (O(n log n) for the percentile sorts), then one pass over the rows
+void compute_batch_features(CandidateBatch& batch, ThreadPool* pool) {
+    const size_t count = batch.GetRowCount();
+    if (count == 0) {
+        return;
+    }
+
+    std::vector<float> values(count);
+    ColumnStats lm, faiss, dtw;
+    const RankingFeature columns[3] = {FEATURE_LM_SCORE, FEATURE_FAISS_DISTANCE, FEATURE_DTW_DISTANCE};
+    ColumnStats* stats[3] = {&lm, &faiss, &dtw};
+    for (int c = 0; c < 3; ++c) {
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = batch.Get(i, columns[c]);
+        }
+        compute_column_stats(values, *stats[c]);
+    }
+
+    // Each candidate writes its own row
+    auto compute_rows = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            compute_enhanced_features(batch.GetRow(i), lm, faiss, dtw);
+        }
+    };
+
+    // Rows are cheap now, only split large batches
+    const size_t grain = 256;
+    if (pool && count > grain) {
+        pool->ParallelFor(count, grain, compute_rows);
+    } else {
+        compute_rows(0, count);
+    }
 }
@@ -0,0 +1,81 @@
+#include "screencapture.h"
+#include <wx/dcscreen.h>
+
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#include <dwmapi.h>
+
+// Older SDKs only know WDA_MONITOR
+#ifndef WDA_EXCLUDEFROMCAPTURE
+#define WDA_EXCLUDEFROMCAPTURE 0x00000011
+#endif
+#endif
+
+ScreenCapture::ScreenCapture()
+    : m_window(nullptr)
+    , m_excluded(false)
+{
+}
+
+bool ScreenCapture::ExcludeFromCapture(wxWindow* window)
+{
+    m_window = window;
+    m_excluded = false;
+
+#ifdef __WXMSW__
+    if (window && ::SetWindowDisplayAffinity((HWND)window->GetHWND(), WDA_EXCLUDEFROMCAPTURE)) {
+        m_excluded = true;
+    } else {
+        wxLogMessage("ScreenCapture: WDA_EXCLUDEFROMCAPTURE not available (error %lu), hiding overlay for captures",
+                     static_cast<unsigned long>(::GetLastError()));
+    }
+#endif
+
+    return m_excluded;
+}
+
+void ScreenCapture::WaitForComposition()
+{
+#ifdef __WXMSW__
+    // One DwmFlush is one composed frame; the second guarantees the frame
+    // without the window reached the desktop surface we read from
+    if (SUCCEEDED(::DwmFlush())) {
+        ::DwmFlush();
+        return;
+    }
+#endif
+    wxMilliSleep(50);  // No compositor information: keep the old safety delay
+}
+
+bool ScreenCapture::CaptureRegion(const wxRect& screenRect, wxBitmap& bitmap)
+{
+    if (screenRect.IsEmpty()) {
+        return false;
+    }
+
+    bool hidden = false;
+    if (!m_excluded && m_window && m_window->IsShown()) {
+        m_window->Hide();
+        WaitForComposition();
+        hidden = true;
+    }
+
+    if (!bitmap.IsOk() || bitmap.GetWidth() != screenRect.width || bitmap.GetHeight() != screenRect.height) {
+        bitmap = wxBitmap(screenRect.width, screenRect.height);
+    }
+
+    wxScreenDC screenDC;
+    wxMemoryDC memDC(bitmap);
+    bool ok = memDC.Blit(0, 0, screenRect.width, screenRect.height, &screenDC, screenRect.x, screenRect.y);
+    memDC.SelectObject(wxNullBitmap);
+
+    if (hidden) {
+        m_window->Show();
+    }
+
+    if (!ok) {
+        wxLogWarning("ScreenCapture: Failed to capture region (%d, %d, %d, %d)",
+                     screenRect.x, screenRect.y, screenRect.width, screenRect.height);
+    }
+    return ok;
+}
@@ -0,0 +1,224 @@
+#include "sessionrecorder.h"
+#include <cstring>
+#include <iostream>
+
+static const char SESSION_MAGIC[8] = {'H', 'E', 'Y', 'E', 'S', 'E', 'S', '1'};
+
+// Longest swipe / text accepted when loading (a corrupted length stops the load)
+#define MAX_SESSION_SWIPE_POINTS 100000
+#define MAX_SESSION_STRING 65536
+
+SessionRecorder::SessionRecorder()
+    : m_buffer(64 * 1024)
+    , m_gazeCount(0)
+    , m_swipeCount(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    Close();
+}
+
+bool SessionRecorder::Open(const std::string& filepath, const SessionGeometry& geometry)
+{
+    Close();
+
+    m_file.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+    m_file.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "Failed to create session recording: " << filepath << std::endl;
+        return false;
+    }
+
+    m_file.write(SESSION_MAGIC, sizeof(SESSION_MAGIC));
+    const uint32_t version = VERSION;
+    Write(version);
+    Write(geometry.overlayWidth);
+    Write(geometry.overlayHeight);
+    Write(geometry.keyboardX);
+    Write(geometry.keyboardY);
+    Write(geometry.keyboardWidth);
+    Write(geometry.keyboardHeight);
+    m_gazeCount = 0;
+    m_swipeCount = 0;
+    return true;
+}
+
+void SessionRecorder::Close()
+{
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+void SessionRecorder::RecordGaze(float x, float y, uint64_t timestamp)
+{
+    if (!m_file.is_open()) return;
+    Write(static_cast<uint8_t>(RECORD_GAZE));
+    Write(x);
+    Write(y);
+    Write(timestamp);
+    m_gazeCount++;
+}
+
+void SessionRecorder::RecordKeyboardVisible(bool visible, uint64_t timestamp)
+{
+    if (!m_file.is_open()) return;
+    Write(static_cast<uint8_t>(RECORD_KEYBOARD));
+    Write(static_cast<uint8_t>(visible ? 1 : 0));
+    Write(timestamp);
+}
+
+void SessionRecorder::RecordSwipe(const std::vector<std::pair<float, float>>& path, const std::string& context,
+                                  uint64_t timestamp)
+{
+    if (!m_file.is_open()) return;
+    Write(static_cast<uint8_t>(RECORD_SWIPE));
+    Write(timestamp);
+    Write(static_cast<uint32_t>(path.size()));
+    for (const auto& point : path) {
+        Write(point.first);
+        Write(point.second);
+    }
+    WriteString(context);
+    m_swipeCount++;
+}
+
+void SessionRecorder::RecordWord(const std::string& word)
+{
+    if (!m_file.is_open()) return;
+    Write(static_cast<uint8_t>(RECORD_WORD));
+    WriteString(word);
+}
+
+void SessionRecorder::WriteString(const std::string& text)
+{
+    Write(static_cast<uint32_t>(text.size()));
+    m_file.write(text.data(), text.size());
+}
+
+namespace {
+
+// Bounds-checked little endian reader over the loaded file
+class SessionReader
+{
+public:
+    SessionReader(const std::vector<char>& bytes) : m_bytes(bytes), m_offset(0) {}
+
+    template <typename T>
+    bool Read(T& value)
+    {
+        if (m_bytes.size() - m_offset < sizeof(T)) return false;
+        std::memcpy(&value, m_bytes.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(std::string& text)
+    {
+        uint32_t length;
+        if (!Read(length) || length > MAX_SESSION_STRING || m_bytes.size() - m_offset < length) return false;
+        text.assign(m_bytes.data() + m_offset, length);
+        m_offset += length;
+        return true;
+    }
+
+    bool AtEnd() const { return m_offset == m_bytes.size(); }
+
+private:
+    const std::vector<char>& m_bytes;
+    size_t m_offset;
+};
+
+}
+
+bool SessionRecorder::Load(const std::string& filepath, SessionData& data, std::string& error)
+{
+    data = SessionData();
+
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        error = "cannot open " + filepath;
+        return false;
+    }
+    std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(bytes.data(), bytes.size())) {
+        error = "cannot read " + filepath;
+        return false;
+    }
+
+    SessionReader reader(bytes);
+    char magic[sizeof(SESSION_MAGIC)];
+    uint32_t version = 0;
+    if (!reader.Read(magic) || std::memcmp(magic, SESSION_MAGIC, sizeof(magic)) != 0 || !reader.Read(version)) {
+        error = "not a session recording";
+        return false;
+    }
+    if (version != VERSION) {
+        error = "unsupported session version " + std::to_string(version);
+        return false;
+    }
+    SessionGeometry& geometry = data.geometry;
+    if (!reader.Read(geometry.overlayWidth) || !reader.Read(geometry.overlayHeight) ||
+        !reader.Read(geometry.keyboardX) || !reader.Read(geometry.keyboardY) ||
+        !reader.Read(geometry.keyboardWidth) || !reader.Read(geometry.keyboardHeight)) {
+        error = "truncated header";
+        return false;
+    }
+
+    bool keyboardVisible = false;
+    while (!reader.AtEnd()) {
+        uint8_t type;
+        reader.Read(type);
+
+        bool complete = false;
+        if (type == RECORD_GAZE) {
+            SessionData::Gaze gaze;
+            complete = reader.Read(gaze.x) && reader.Read(gaze.y) && reader.Read(gaze.timestamp);
+            if (complete) {
+                gaze.keyboardVisible = keyboardVisible;
+                data.gaze.push_back(gaze);
+            }
+        } else if (type == RECORD_KEYBOARD) {
+            uint8_t visible;
+            uint64_t timestamp;
+            complete = reader.Read(visible) && reader.Read(timestamp);
+            if (complete) {
+                keyboardVisible = visible != 0;
+            }
+        } else if (type == RECORD_SWIPE) {
+            SessionData::Swipe swipe;
+            uint32_t points = 0;
+            complete = reader.Read(swipe.timestamp) && reader.Read(points) && points <= MAX_SESSION_SWIPE_POINTS;
+            for (uint32_t i = 0; complete && i < points; ++i) {
+                std::pair<float, float> point;
+                complete = reader.Read(point.first) && reader.Read(point.second);
+                swipe.path.push_back(point);
+            }
+            complete = complete && reader.ReadString(swipe.context);
+            if (complete) {
+                swipe.gazeIndex = data.gaze.size();
+                data.swipes.push_back(std::move(swipe));
+            }
+        } else if (type == RECORD_WORD) {
+            std::string word;
+            complete = reader.ReadString(word);
+            if (complete && !data.swipes.empty()) {
+                data.swipes.back().word = word;
+            }
+        } else {
+            error = "unknown record type " + std::to_string(type);
+            return false;
+        }
+
+        if (!complete) {
+            // Recording cut short, keep what was read
+            std::cerr << "Session recording truncated after " << data.gaze.size() << " gaze samples: "
+                      << filepath << std::endl;
+            break;
+        }
+    }
+    return true;
+}
@@ -7,6 +7,10 @@ Settings::Settings()
     , m_holdTime(800)
     , m_cursorDelay(50)
     , m_autoShowKeyboard(true)
+    , m_swipeMinCutoff(1.0f)
+    , m_swipeBeta(0.02f)
+    , m_swipeFixationRadius(1.0f)
+    , m_swipeResampleStep(2.0f)
     , m_zoomFactor(3.0f)
     , m_backgroundOpacity(170)
     , m_colorR(102)
@@ -14,6 +18,23 @@ Settings::Settings()
     , m_colorB(255)
     , m_selectionWidth(300)
     , m_selectionHeight(300)
+    , m_trackedDisplay(-1)
+    , m_encoderIntraOpThreads(0)
+    , m_encoderGraphOptimization(3)
+    , m_encoderCpuMemArena(false)
+    , m_dtwWindow(-1)
+    , m_dtwPruneTopK(0)
+    , m_rankingThreads(0)
+    , m_faissTopK(100)
+    , m_faissNprobe(16)
+    , m_faissEfSearch(128)
+    , m_speculativeInterval(24)
+    , m_rankerBackend(0)
+    , m_candidateCount(5)
+    , m_executionProvider(0)
+    , m_recordSession(false)
+    , m_traceEnabled(false)
+    , m_showTraceStats(false)
 {
     // Get user config directory (AppData\Roaming\HeyEye on Windows)
     wxStandardPaths& paths = wxStandardPaths::Get();
@@ -60,6 +81,10 @@ void Settings::Load()
 
     // Keyboard
     m_autoShowKeyboard = m_config->ReadBool(wxT("/keyboard/auto_show_on_text_cursor"), true);
+    m_swipeMinCutoff = (float)m_config->ReadDouble(wxT("/keyboard/swipe_min_cutoff"), 1.0);
+    m_swipeBeta = (float)m_config->ReadDouble(wxT("/keyboard/swipe_beta"), 0.02);
+    m_swipeFixationRadius = (float)m_config->ReadDouble(wxT("/keyboard/swipe_fixation_radius"), 1.0);
+    m_swipeResampleStep = (float)m_config->ReadDouble(wxT("/keyboard/swipe_resample_step"), 2.0);
 
     // Zoom
     m_zoomFactor = (float)m_config->ReadDouble(wxT("/zoom/zoom_factor"), 3.0);
@@ -72,6 +97,30 @@ void Settings::Load()
     m_selectionWidth = m_config->ReadLong(wxT("/rendering/selection_print_size_width"), 300);
     m_selectionHeight = m_config->ReadLong(wxT("/rendering/selection_print_size_height"), 300);
 
+    // Display
+    m_trackedDisplay = m_config->ReadLong(wxT("/display/tracked_display"), -1);
+
+    // ML
+    m_encoderIntraOpThreads = m_config->ReadLong(wxT("/ml/encoder_intra_op_threads"), 0);
+    m_encoderGraphOptimization = m_config->ReadLong(wxT("/ml/encoder_graph_optimization"), 3);
+    m_encoderCpuMemArena = m_config->ReadBool(wxT("/ml/encoder_cpu_mem_arena"), false);
+    m_dtwWindow = m_config->ReadLong(wxT("/ml/dtw_window"), -1);
+    m_dtwPruneTopK = m_config->ReadLong(wxT("/ml/dtw_prune_top_k"), 0);
+    m_rankingThreads = m_config->ReadLong(wxT("/ml/ranking_threads"), 0);
+    m_faissTopK = m_config->ReadLong(wxT("/ml/faiss_top_k"), 100);
+    m_faissNprobe = m_config->ReadLong(wxT("/ml/faiss_nprobe"), 16);
+    m_faissEfSearch = m_config->ReadLong(wxT("/ml/faiss_ef_search"), 128);
+    m_speculativeInterval = m_config->ReadLong(wxT("/ml/speculative_interval"), 24);
+    m_rankerBackend = m_config->ReadLong(wxT("/ml/ranker_backend"), 0);
+    m_candidateCount = m_config->ReadLong(wxT("/ml/candidate_count"), 5);
+    m_executionProvider = m_config->ReadLong(wxT("/ml/execution_provider"), 0);
+    m_modelPack = m_config->Read(wxT("/ml/model_pack"), wxEmptyString);
+
+    // Debug
+    m_recordSession = m_config->ReadBool(wxT("/debug/record_session"), false);
+    m_traceEnabled = m_config->ReadBool(wxT("/debug/trace"), false);
+    m_showTraceStats = m_config->ReadBool(wxT("/debug/show_stats"), false);
+
     wxLogMessage("Settings loaded: wait=%dms, hold=%dms, cursor_delay=%dms, zoom=%.1f, opacity=%d, color=(%d,%d,%d), selection=%dx%d",
                  m_waitTime, m_holdTime, m_cursorDelay, m_zoomFactor, m_backgroundOpacity,
                  m_colorR, m_colorG, m_colorB, m_selectionWidth, m_selectionHeight);
@@ -88,6 +137,10 @@ void Settings::Save()
 
     // Keyboard
     m_config->Write(wxT("/keyboard/auto_show_on_text_cursor"), m_autoShowKeyboard);
+    m_config->Write(wxT("/keyboard/swipe_min_cutoff"), (double)m_swipeMinCutoff);
+    m_config->Write(wxT("/keyboard/swipe_beta"), (double)m_swipeBeta);
+    m_config->Write(wxT("/keyboard/swipe_fixation_radius"), (double)m_swipeFixationRadius);
+    m_config->Write(wxT("/keyboard/swipe_resample_step"), (double)m_swipeResampleStep);
 
     // Zoom
     m_config->Write(wxT("/zoom/zoom_factor"), (double)m_zoomFactor);
@@ -100,6 +153,30 @@ void Settings::Save()
     m_config->Write(wxT("/rendering/selection_print_size_width"), (long)m_selectionWidth);
     m_config->Write(wxT("/rendering/selection_print_size_height"), (long)m_selectionHeight);
 
+    // Display
+    m_config->Write(wxT("/display/tracked_display"), (long)m_trackedDisplay);
+
+    // ML
+    m_config->Write(wxT("/ml/encoder_intra_op_threads"), (long)m_encoderIntraOpThreads);
+    m_config->Write(wxT("/ml/encoder_graph_optimization"), (long)m_encoderGraphOptimization);
+    m_config->Write(wxT("/ml/encoder_cpu_mem_arena"), m_encoderCpuMemArena);
+    m_config->Write(wxT("/ml/dtw_window"), (long)m_dtwWindow);
+    m_config->Write(wxT("/ml/dtw_prune_top_k"), (long)m_dtwPruneTopK);
+    m_config->Write(wxT("/ml/ranking_threads"), (long)m_rankingThreads);
+    m_config->Write(wxT("/ml/faiss_top_k"), (long)m_faissTopK);
+    m_config->Write(wxT("/ml/faiss_nprobe"), (long)m_faissNprobe);
+    m_config->Write(wxT("/ml/faiss_ef_search"), (long)m_faissEfSearch);
+    m_config->Write(wxT("/ml/speculative_interval"), (long)m_speculativeInterval);
+    m_config->Write(wxT("/ml/ranker_backend"), (long)m_rankerBackend);
+    m_config->Write(wxT("/ml/candidate_count"), (long)m_candidateCount);
+    m_config->Write(wxT("/ml/execution_provider"), (long)m_executionProvider);
+    m_config->Write(wxT("/ml/model_pack"), m_modelPack);
+
+    // Debug
+    m_config->Write(wxT("/debug/record_session"), m_recordSession);
+    m_config->Write(wxT("/debug/trace"), m_traceEnabled);
+    m_config->Write(wxT("/debug/show_stats"), m_showTraceStats);
+
     // Flush to disk
     m_config->Flush();
 
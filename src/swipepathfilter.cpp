@@ -0,0 +1,124 @@
+#include "swipepathfilter.h"
+#include <cmath>
+
+static const float PI_F = 3.14159265358979f;
+static const float DEFAULT_DT = 1.0f / 60.0f;  // Repeated or missing timestamps
+
+SwipePathFilter::SwipePathFilter()
+{
+    Reset();
+}
+
+void SwipePathFilter::SetOptions(const SwipePathFilterOptions& options)
+{
+    m_options = options;
+    Reset();
+}
+
+void SwipePathFilter::Reset()
+{
+    m_started = false;
+    m_lastTimestamp = 0;
+    m_axisX = OneEuroAxis{0.0f, 0.0f};
+    m_axisY = OneEuroAxis{0.0f, 0.0f};
+    m_kept = Point(0.0f, 0.0f);
+    m_emitted = Point(0.0f, 0.0f);
+    m_sinceEmitted = 0.0f;
+    m_keptEmitted = false;
+}
+
+float SwipePathFilter::Alpha(float cutoffHz, float dt)
+{
+    const float tau = 1.0f / (2.0f * PI_F * cutoffHz);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+float SwipePathFilter::Smooth(OneEuroAxis& axis, float sample, float dt) const
+{
+    // Casiez et al. 2012: the cutoff rises with the (itself filtered) speed
+    const float derivative = (sample - axis.value) / dt;
+    const float derivativeAlpha = Alpha(m_options.derivativeCutoffHz, dt);
+    axis.derivative += derivativeAlpha * (derivative - axis.derivative);
+
+    const float cutoff = m_options.minCutoffHz + m_options.beta * std::fabs(axis.derivative);
+    axis.value += Alpha(cutoff, dt) * (sample - axis.value);
+    return axis.value;
+}
+
+void SwipePathFilter::Emit(const Point& point, std::vector<Point>& out)
+{
+    out.push_back(point);
+    m_emitted = point;
+    m_sinceEmitted = 0.0f;
+}
+
+void SwipePathFilter::Add(float x, float y, uint64_t timestamp, std::vector<Point>& out)
+{
+    if (!m_started) {
+        m_started = true;
+        m_lastTimestamp = timestamp;
+        m_axisX = OneEuroAxis{x, 0.0f};
+        m_axisY = OneEuroAxis{y, 0.0f};
+        m_kept = Point(x, y);
+        m_keptEmitted = true;
+        Emit(m_kept, out);
+        return;
+    }
+
+    float dt = DEFAULT_DT;
+    if (timestamp > m_lastTimestamp) {
+        dt = static_cast<float>(timestamp - m_lastTimestamp) / 1000000.0f;
+    }
+    m_lastTimestamp = timestamp;
+
+    Point sample(x, y);
+    if (m_options.minCutoffHz > 0.0f) {
+        sample.first = Smooth(m_axisX, x, dt);
+        sample.second = Smooth(m_axisY, y, dt);
+    }
+
+    // Fixation: stay on the previous kept point
+    float dx = sample.first - m_kept.first;
+    float dy = sample.second - m_kept.second;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    if (distance <= 0.0f || distance < m_options.fixationRadius) {
+        return;
+    }
+
+    if (m_options.resampleStep <= 0.0f) {
+        m_kept = sample;
+        m_keptEmitted = true;
+        Emit(sample, out);
+        return;
+    }
+
+    // Walk the segment m_kept -> sample, one output point per resampleStep
+    const float step = m_options.resampleStep;
+    Point from = m_kept;
+    float remaining = distance;
+    m_keptEmitted = false;
+    while (m_sinceEmitted + remaining >= step) {
+        const float advance = step - m_sinceEmitted;
+        const float t = advance / remaining;
+        Point point(from.first + (sample.first - from.first) * t,
+                    from.second + (sample.second - from.second) * t);
+        Emit(point, out);
+        from = point;
+        remaining -= advance;
+        if (remaining <= 0.0f) {
+            m_keptEmitted = true;
+            break;
+        }
+    }
+    m_sinceEmitted += remaining > 0.0f ? remaining : 0.0f;
+    m_kept = sample;
+}
+
+void SwipePathFilter::Finish(std::vector<Point>& out)
+{
+    // The stroke ends where the gaze was, not at the last full step
+    if (m_started && !m_keptEmitted && m_sinceEmitted > 0.0f) {
+        m_keptEmitted = true;
+        Emit(m_kept, out);
+    }
+}
@@ -1,13 +1,31 @@
 #include "textinputengine.h"
+#include "candidatebatch.h"
+#include "dtwprefixcache.h"
+#include "kenlmutil.h"
+#include "languagecontext.h"
 #include "lightgbm_ranker.h"
+#include "lrucache.h"
 #include "ranking_features.h"
 #include "ml_helpers.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "vocabulary.h"
 #include <wx/filename.h>
 #include <set>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <future>
+#include <unordered_map>
 
 // Include ML library headers when enabled
 #ifdef USE_ONNX
 #include "onnxruntime_cxx_api.h"
+#ifdef USE_DIRECTML
+#include "dml_provider_factory.h"
+#endif
 #endif
 
 #ifdef USE_FAISS
@@ -17,31 +35,275 @@
 
 #ifdef USE_KENLM
 #include "lm/model.hh"
+#include "lm/binary_format.hh"
 #endif
 
 #define MAX_LENGTH_SWIPE 520
 
+// (context state, word) -> LM score entries kept across swipes
+#define LM_SCORE_CACHE_SIZE 16384
+
+struct TextInputEngine::SwipeCache {
+    DtwPrefixCache dtwRows;                         // Rows of the longest prefix seen
+    LruCache<LmScoreKey, LmWordScore, LmScoreKeyHash> lmScores;
+    std::vector<std::pair<float, float>> lastPath;  // Last fully ranked path, its context and words
+    LmContext lastContext;
+    size_t lastTopK;
+    std::vector<std::string> lastWords;
+
+    SwipeCache() : lmScores(LM_SCORE_CACHE_SIZE), lastTopK(0) {}
+};
+
+// Posted by the prediction worker, handled on the GUI thread
+wxDEFINE_EVENT(wxEVT_SWIPE_PREDICTION_DONE, wxThreadEvent);
+// Posted by the startup thread once every load stage finished
+wxDEFINE_EVENT(wxEVT_ENGINE_INITIALIZED, wxThreadEvent);
+
+#ifdef USE_ONNX
+// Sequence lengths the encoder is bound for when its time axis is dynamic.
+// The shortest one that fits the swipe is used, the padding cost then scales
+// with the swipe length instead of always paying for MAX_LENGTH_SWIPE steps.
+static const int ENCODER_BUCKETS[] = {64, 128, 256, MAX_LENGTH_SWIPE};
+
+// Encoder inputs and output for one sequence length, alive for the whole
+// session: tensors wrap these buffers and are bound once, each swipe only
+// rewrites coordinates and mask
+struct EncoderBucket {
+    int length;
+    std::vector<float> points;       // [1, length, 2], padding = -200
+    std::vector<int64_t> positions;  // [1, length], constant 0..length-1
+    std::unique_ptr<bool[]> mask;    // [1, length], true = padding
+    std::vector<float> output;       // [1, embedding size] when the size is static
+    size_t filledPoints;             // Points written by the previous call
+    bool boundOutput;                // false: output shape is dynamic, runtime allocates it
+
+    Ort::Value pointsTensor;
+    Ort::Value positionsTensor;
+    Ort::Value maskTensor;
+    Ort::Value outputTensor;
+    Ort::IoBinding binding;
+
+    EncoderBucket(Ort::Session& session, int len)
+        : length(len)
+        , points(2 * len, -200.0f)
+        , positions(len)
+        , mask(new bool[len])
+        , filledPoints(0)
+        , boundOutput(false)
+        , pointsTensor(nullptr)
+        , positionsTensor(nullptr)
+        , maskTensor(nullptr)
+        , outputTensor(nullptr)
+        , binding(session)
+    {
+        for (int i = 0; i < len; ++i) {
+            positions[i] = i;
+            mask[i] = true;
+        }
+    }
+};
+
+struct TextInputEngine::EncoderContext {
+    std::vector<std::unique_ptr<EncoderBucket>> buckets;  // Ascending length, last = MAX_LENGTH_SWIPE
+    std::mutex mutex;  // Sync and worker predictions share the bindings
+};
+
+static void bind_encoder_bucket(Ort::Session& session, Ort::MemoryInfo& memoryInfo, EncoderBucket& bucket) {
+    std::array<int64_t, 3> input_shape{1, bucket.length, 2};
+    std::array<int64_t, 2> positions_shape{1, bucket.length};
+    std::array<int64_t, 2> mask_shape{1, bucket.length};
+
+    bucket.pointsTensor = Ort::Value::CreateTensor<float>(memoryInfo, bucket.points.data(), bucket.points.size(), input_shape.data(), input_shape.size());
+    bucket.positionsTensor = Ort::Value::CreateTensor<int64_t>(memoryInfo, bucket.positions.data(), bucket.positions.size(), positions_shape.data(), positions_shape.size());
+    bucket.maskTensor = Ort::Value::CreateTensor<bool>(memoryInfo, bucket.mask.get(), bucket.length, mask_shape.data(), mask_shape.size());
+
+    bucket.binding.BindInput("input", bucket.pointsTensor);
+    bucket.binding.BindInput("positions", bucket.positionsTensor);
+    bucket.binding.BindInput("mask", bucket.maskTensor);
+
+    // Bind a preallocated output when the embedding size is known up front
+    std::vector<int64_t> output_shape = session.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    if (output_shape.size() == 2 && output_shape[1] > 0) {
+        output_shape[0] = 1;
+        bucket.output.assign(static_cast<size_t>(output_shape[1]), 0.0f);
+        bucket.outputTensor = Ort::Value::CreateTensor<float>(memoryInfo, bucket.output.data(), bucket.output.size(), output_shape.data(), output_shape.size());
+        bucket.binding.BindOutput("output", bucket.outputTensor);
+        bucket.boundOutput = true;
+    } else {
+        bucket.binding.BindOutput("output", memoryInfo);
+    }
+}
+
+// Writes the last bucket.length points of swipePath, runs the encoder and
+// copies the embedding. Throws Ort::Exception.
+static void run_encoder_bucket(Ort::Session& session, EncoderBucket& bucket,
+                               const std::vector<std::pair<float, float>>& swipePath,
+                               std::vector<float>& embedding) {
+    size_t count = std::min(swipePath.size(), static_cast<size_t>(bucket.length));
+    size_t first = swipePath.size() - count;
+    for (size_t i = 0; i < count; ++i) {
+        bucket.points[2 * i] = swipePath[first + i].first;
+        bucket.points[2 * i + 1] = swipePath[first + i].second;
+        bucket.mask[i] = false;
+    }
+
+    // Pad with -200 only where the previous swipe left real points
+    for (size_t i = count; i < bucket.filledPoints; ++i) {
+        bucket.points[2 * i] = -200.0f;
+        bucket.points[2 * i + 1] = -200.0f;
+        bucket.mask[i] = true;
+    }
+    bucket.filledPoints = count;
+
+    session.Run(Ort::RunOptions{nullptr}, bucket.binding);
+
+    if (bucket.boundOutput) {
+        embedding.assign(bucket.output.begin(), bucket.output.end());
+        return;
+    }
+
+    std::vector<Ort::Value> outputTensor = bucket.binding.GetOutputValues();
+    if (outputTensor.size() > 0) {
+        int nb_embedding = outputTensor[0].GetTensorTypeAndShapeInfo().GetShape()[1];
+        const float* output_data = outputTensor[0].GetTensorData<float>();
+        embedding.assign(output_data, output_data + nb_embedding);
+    }
+}
+
+// Execution providers of TextInputEngineOptions::executionProvider
+enum EncoderProvider {
+    PROVIDER_CPU,
+    PROVIDER_DIRECTML,
+    PROVIDER_CUDA,
+    PROVIDER_OPENVINO
+};
+
+static const char* provider_name(EncoderProvider provider) {
+    switch (provider) {
+        case PROVIDER_DIRECTML: return "DirectML";
+        case PROVIDER_CUDA:     return "CUDA";
+        case PROVIDER_OPENVINO: return "OpenVINO";
+        default:                return "CPU";
+    }
+}
+
+// Providers to try in order for a setting, CPU always comes last
+static std::vector<EncoderProvider> provider_order(int setting) {
+    switch (setting) {
+        case 1:  return {PROVIDER_DIRECTML, PROVIDER_CUDA, PROVIDER_OPENVINO, PROVIDER_CPU};
+        case 2:  return {PROVIDER_DIRECTML, PROVIDER_CPU};
+        case 3:  return {PROVIDER_CUDA, PROVIDER_CPU};
+        case 4:  return {PROVIDER_OPENVINO, PROVIDER_CPU};
+        default: return {PROVIDER_CPU};
+    }
+}
+
+// Whether this ONNX Runtime build ships the provider
+static bool provider_available(EncoderProvider provider, const std::vector<std::string>& available) {
+    const char* ortName = "CPUExecutionProvider";
+    switch (provider) {
+        case PROVIDER_DIRECTML:
+#ifndef USE_DIRECTML
+            return false;  // Needs dml_provider_factory.h at build time
+#else
+            ortName = "DmlExecutionProvider";
+            break;
+#endif
+        case PROVIDER_CUDA:     ortName = "CUDAExecutionProvider"; break;
+        case PROVIDER_OPENVINO: ortName = "OpenVINOExecutionProvider"; break;
+        default: break;
+    }
+    return std::find(available.begin(), available.end(), ortName) != available.end();
+}
+
+// Throws Ort::Exception when the provider cannot be created (no device, missing runtime)
+static void append_provider(Ort::SessionOptions& options, EncoderProvider provider) {
+    switch (provider) {
+        case PROVIDER_DIRECTML:
+#ifdef USE_DIRECTML
+            // DirectML supports neither memory patterns nor parallel execution
+            options.DisableMemPattern();
+            options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+            Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_DML(options, 0));
+#endif
+            break;
+        case PROVIDER_CUDA: {
+            OrtCUDAProviderOptions cuda;
+            cuda.device_id = 0;
+            options.AppendExecutionProvider_CUDA(cuda);
+            break;
+        }
+        case PROVIDER_OPENVINO:
+            // The GPU device is the integrated one when it is the only one
+            options.AppendExecutionProvider_OpenVINO_V2({{"device_type", "GPU"}});
+            break;
+        default:
+            break;
+    }
+}
+#endif
+
+// Synthetic swipe for the padding check and the warm-up runs
+static std::vector<std::pair<float, float>> make_probe_swipe(size_t points) {
+    std::vector<std::pair<float, float>> probe;
+    probe.reserve(points);
+    for (size_t i = 0; i < points; ++i) {
+        probe.push_back(std::make_pair(-10.0f + 240.0f * i / std::max<size_t>(1, points - 1),
+                                       50.0f + 20.0f * std::sin(0.4f * i)));
+    }
+    return probe;
+}
+
 TextInputEngine::TextInputEngine()
     : m_initialized(false)
     , OnTextChanged(nullptr)
     , OnPredictionReady(nullptr)
     , OnTopKPredictionsReady(nullptr)
+    , OnProvisionalPrediction(nullptr)
+    , OnInitialized(nullptr)
+    , m_ortEnv(nullptr)
     , m_swipeEncoder(nullptr)
+    , m_encoderProvider("none")
+    , m_embeddingSize(0)
     , m_memoryInfo(nullptr)
+    , m_encoderContext(nullptr)
     , m_faissIndex(nullptr)
     , m_kenLM(nullptr)
     , m_lightGBM(nullptr)
     , m_vocab(nullptr)
-    , m_vocabKeys(nullptr)
+    , m_rankingPool(nullptr)
+    , m_candidateBatch(new CandidateBatch())
+    , m_swipeCache(new SwipeCache())
+    , m_hasPendingRequest(false)
+    , m_finalInFlight(false)
+    , m_stopWorker(false)
+    , m_latestRequestId(0)
+    , m_initializing(false)
 {
+    Bind(wxEVT_SWIPE_PREDICTION_DONE, &TextInputEngine::OnPredictionResult, this);
+    Bind(wxEVT_ENGINE_INITIALIZED, &TextInputEngine::OnInitializationDone, this);
+    m_predictionThread = std::thread(&TextInputEngine::PredictionWorkerLoop, this);
 }
 
 TextInputEngine::~TextInputEngine()
 {
+    // Loads cannot be interrupted, wait for a background initialization
+    if (m_startupThread.joinable()) {
+        m_startupThread.join();
+    }
+
+    // The worker uses the ML components, stop it before freeing them
+    StopPredictionWorker();
+    delete m_rankingPool;
+    delete m_candidateBatch;
+    delete m_swipeCache;
+
     // Clean up ML components
 #ifdef USE_ONNX
+    delete m_encoderContext;
     delete m_swipeEncoder;
     delete m_memoryInfo;
+    delete m_ortEnv;
 #endif
 
 #ifdef USE_FAISS
@@ -50,70 +312,235 @@ TextInputEngine::~TextInputEngine()
 
 #ifdef USE_KENLM
     if (m_kenLM) {
-        delete static_cast<lm::ngram::Model*>(m_kenLM);
+        delete static_cast<lm::base::Model*>(m_kenLM);
     }
 #endif
 
     delete m_lightGBM;
     delete m_vocab;
-    delete m_vocabKeys;
 }
 
 bool TextInputEngine::Initialize(const wxString& assetsPath)
 {
     wxLogMessage("TextInputEngine: Initializing with assets path: %s", assetsPath);
 
-    // Initialize keyboard coordinates for DTW
+    m_initialized = LoadAssets(assetsPath);
+    return m_initialized;
+}
+
+void TextInputEngine::InitializeAsync(const wxString& assetsPath)
+{
+    if (m_initializing.exchange(true)) {
+        wxLogWarning("TextInputEngine: Initialization already running");
+        return;
+    }
+    if (m_startupThread.joinable()) {
+        m_startupThread.join();
+    }
+
+    wxLogMessage("TextInputEngine: Initializing in background with assets path: %s", assetsPath);
+
+    // wxString copies are not guaranteed to be thread safe, force a deep copy
+    wxString path = assetsPath.Clone();
+    m_startupThread = std::thread([this, path]() {
+        bool ok = LoadAssets(path);
+        m_initialized = ok;
+        m_initializing = false;
+
+        wxThreadEvent* event = new wxThreadEvent(wxEVT_ENGINE_INITIALIZED);
+        event->SetInt(ok ? 1 : 0);
+        wxQueueEvent(this, event);
+    });
+}
+
+std::vector<StartupStage> TextInputEngine::GetStartupStages() const
+{
+    std::lock_guard<std::mutex> lock(m_startupMutex);
+    return m_startupStages;
+}
+
+void TextInputEngine::OnInitializationDone(wxThreadEvent& event)
+{
+    if (OnInitialized) {
+        OnInitialized(event.GetInt() != 0);
+    }
+}
+
+bool TextInputEngine::LoadAssets(const wxString& assetsPath)
+{
+    // Initialize keyboard coordinates for DTW (shared table, before any stage)
     init_keyboard_coords();
 
-    // Initialize ONNX Runtime for swipe encoding
-    wxString swipeModelPath = assetsPath + wxT("/swipe_encoder.onnx");
-    if (!LoadSwipeEncoder(swipeModelPath)) {
-        wxLogWarning("Failed to load swipe encoder");
-        return false;
+    // Encoder and index come from the same pack, a broken pack falls back to the FP32 files
+    const std::string assetsDir(assetsPath.ToUTF8());
+    m_modelPack = ModelPack::Default(assetsDir);
+    if (!m_options.modelPack.empty()) {
+        ModelPack pack;
+        std::string error;
+        if (ModelPack::Load(assetsDir, m_options.modelPack, pack, error)) {
+            m_modelPack = pack;
+        } else {
+            wxLogWarning("TextInputEngine: %s, using the default model files", wxString::FromUTF8(error.c_str()));
+        }
+    }
+    wxLogMessage("TextInputEngine: Model pack %s %s (encoder %s, index %s)",
+                 wxString::FromUTF8(m_modelPack.name.c_str()), wxString::FromUTF8(m_modelPack.version.c_str()),
+                 wxString::FromUTF8(m_modelPack.precision.c_str()), wxString::FromUTF8(m_modelPack.embeddings.c_str()));
+    const wxString encoderPath = wxString::FromUTF8(m_modelPack.encoderPath.c_str());
+    const wxString indexPath = wxString::FromUTF8(m_modelPack.indexPath.c_str());
+
+    struct StageTask {
+        const char* name;
+        bool required;
+        std::function<bool()> load;
+    };
+
+    // The stages touch disjoint members, so they can run in any order
+    std::vector<StageTask> tasks;
+
+    // ONNX Runtime swipe encoder
+    tasks.push_back({"swipe encoder", true, [this, encoderPath]() {
+        return LoadSwipeEncoder(encoderPath);
+    }});
+
+    // Vocabulary (prefer the mappable conversion, fall back to msgpack)
+    tasks.push_back({"vocabulary", true, [this, assetsPath]() {
+        wxString vocabPath = assetsPath + wxT("/vocab.bin");
+        if (!wxFileName::Exists(vocabPath)) {
+            vocabPath = assetsPath + wxT("/vocab.msgpck");
+        }
+        return LoadVocabulary(vocabPath);
+    }});
+
+    // FAISS index
+    tasks.push_back({"faiss index", true, [this, indexPath]() {
+        return LoadFaissIndex(indexPath);
+    }});
+
+    // KenLM (prefer the binary conversion, fall back to ARPA). None at all is
+    // fine and reported as skipped, a model that is present has to load.
+    wxString kenlmPath = assetsPath + wxT("/kenlm_model.binary");
+    const wxString kenlmArpaPath = assetsPath + wxT("/kenlm_model.arpa");
+    if (!wxFileName::Exists(kenlmPath)) {
+        kenlmPath = kenlmArpaPath;
+    } else if (wxFileName::Exists(kenlmArpaPath) &&
+               wxFileName(kenlmArpaPath).GetModificationTime() > wxFileName(kenlmPath).GetModificationTime()) {
+        wxLogWarning("KenLM binary is older than %s, rebuild it with the convert_kenlm target", kenlmArpaPath);
+    }
+    const bool haveKenLM = wxFileName::Exists(kenlmPath);
+    tasks.push_back({"kenlm", haveKenLM, [this, kenlmPath, haveKenLM]() {
+        return haveKenLM && LoadKenLM(kenlmPath);
+    }});
+
+    // LightGBM (optional, fallback scoring without it)
+    tasks.push_back({"lightgbm", false, [this, assetsPath]() {
+        wxString lgbmPath = assetsPath + wxT("/lightgbm_ranker.txt");
+        if (!wxFileName::Exists(lgbmPath)) {
+            wxLogMessage("LightGBM model not found (optional): %s", lgbmPath);
+            wxLogMessage("Will use fallback scoring for word prediction");
+            return false;
+        }
+        return LoadLightGBM(lgbmPath);
+    }});
+
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point startTime = Clock::now();
+
+    std::vector<std::future<StartupStage>> futures;
+    {
+        // One thread per stage up to the core count: the slowest stage bounds startup
+        ThreadPool pool(std::min<size_t>(tasks.size(), std::max(2u, std::thread::hardware_concurrency())));
+        for (const StageTask& task : tasks) {
+            futures.push_back(pool.Submit([&task]() {
+                StartupStage stage;
+                stage.name = task.name;
+                stage.required = task.required;
+
+                const Clock::time_point stageStart = Clock::now();
+                try {
+                    stage.loaded = task.load();
+                } catch (const std::exception& e) {
+                    wxLogWarning("TextInputEngine: Stage %s failed: %s", task.name, e.what());
+                }
+                stage.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - stageStart).count();
+                return stage;
+            }));
+        }
     }
 
-    // Load vocabulary
-    wxString vocabPath = assetsPath + wxT("/vocab.msgpck");
-    if (!LoadVocabulary(vocabPath)) {
-        wxLogWarning("Failed to load vocabulary");
-        return false;
+    std::vector<StartupStage> stages;
+    double serialMs = 0.0;
+    bool ok = true;
+    for (std::future<StartupStage>& future : futures) {
+        StartupStage stage = future.get();
+        wxLogMessage("TextInputEngine: Stage %-13s %s in %.1f ms", stage.name,
+                     stage.loaded ? "loaded" : (stage.required ? "FAILED" : "skipped"), stage.milliseconds);
+        if (stage.required && !stage.loaded) {
+            wxLogWarning("Failed to load %s", stage.name);
+            ok = false;
+        }
+        serialMs += stage.milliseconds;
+        stages.push_back(stage);
     }
 
-    // Load FAISS index
-    wxString indexPath = assetsPath + wxT("/index.faiss");
-    if (!LoadFaissIndex(indexPath)) {
-        wxLogWarning("Failed to load FAISS index");
-        return false;
+#ifdef USE_FAISS
+    // An index built from another encoder would load fine and search garbage
+    if (ok && m_faissIndex && m_embeddingSize != static_cast<size_t>(m_faissIndex->d)) {
+        wxLogError("TextInputEngine: Encoder embeddings have %zu dimensions, the FAISS index %d: "
+                   "encoder and index must come from the same model pack", m_embeddingSize, (int)m_faissIndex->d);
+        ok = false;
+    }
+#endif
+
+#ifdef USE_KENLM
+    // Resolve the LM index of every word once instead of per ranked candidate
+    if (m_vocab && m_kenLM) {
+        const lm::base::Model* model = static_cast<const lm::base::Model*>(m_kenLM);
+        bool stored = m_vocab->BindLanguageModel([model](const std::string& word) {
+            return static_cast<uint32_t>(kenlm_index(model, word));
+        });
+        wxLogMessage("Vocabulary: %s LM indices", stored ? "using stored" : "computed");
     }
+#endif
 
-    // Load KenLM
-    wxString kenlmPath = assetsPath + wxT("/kenlm_model.arpa");
-    if (wxFileName::Exists(kenlmPath) && !LoadKenLM(kenlmPath)) {
-        wxLogWarning("Failed to load KenLM");
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(m_startupMutex);
+        m_startupStages = stages;
     }
 
-    // Load LightGBM (optional)
-    wxString lgbmPath = assetsPath + wxT("/lightgbm_ranker.txt");
-    if (wxFileName::Exists(lgbmPath)) {
-        if (!LoadLightGBM(lgbmPath)) {
-            wxLogWarning("Failed to load LightGBM model");
-            // Don't fail initialization - LightGBM is optional
-        }
-    } else {
-        wxLogMessage("LightGBM model not found (optional): %s", lgbmPath);
-        wxLogMessage("Will use fallback scoring for word prediction");
+    const double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+    if (!ok) {
+        wxLogWarning("TextInputEngine: Initialization incomplete after %.1f ms, swipe prediction disabled", totalMs);
+        return false;
     }
 
-    m_initialized = true;
-    wxLogMessage("TextInputEngine: Initialization complete");
+    // Created before m_initialized is set, the prediction worker only reads it afterwards
+    size_t rankingThreads = m_options.rankingThreads > 0 ? m_options.rankingThreads
+                                                         : std::thread::hardware_concurrency();
+    if (!m_rankingPool && rankingThreads > 1) {
+        m_rankingPool = new ThreadPool(rankingThreads);
+    }
+    wxLogMessage("TextInputEngine: Ranking candidates on %zu thread(s)",
+                 m_rankingPool ? m_rankingPool->GetThreadCount() : size_t(1));
+
+    // One prediction end to end: faults in the mapped index, vocabulary and LM
+    // pages and wakes the ranking workers, so the first swipe runs at the
+    // speed of the next ones. No cache, nothing of it is kept.
+    PredictionTimings warmup;
+    const Clock::time_point warmupStart = Clock::now();
+    RunPrediction(make_probe_swipe(64), LmContext(), 1, nullptr, nullptr, &warmup);
+    wxLogMessage("TextInputEngine: Warm-up prediction in %.1f ms (encode %.1f, search %.1f, rank %.1f)",
+                 std::chrono::duration<double, std::milli>(Clock::now() - warmupStart).count(),
+                 warmup.encodeMs, warmup.searchMs, warmup.rankMs);
+
+    wxLogMessage("TextInputEngine: Initialization complete in %.1f ms (%.1f ms if loaded serially)", totalMs, serialMs);
     return true;
 }
 
 void TextInputEngine::AppendCharacter(wxChar c)
 {
     m_currentText << c;
+    m_languageContext.AppendCharacter(std::string(wxString(c).ToUTF8()));
 
     // Update word history when space is added (for consistency)
     if (c == wxT(' ')) {
@@ -144,6 +571,7 @@ void TextInputEngine::AppendCharacter(wxChar c)
 void TextInputEngine::AppendText(const wxString& text)
 {
     m_currentText << text;
+    m_languageContext.AppendText(std::string(text.ToUTF8()));
 
     // Update word history
     if (text.Contains(wxT(" "))) {
@@ -164,6 +592,7 @@ void TextInputEngine::DeleteLastCharacter()
 {
     if (!m_currentText.IsEmpty()) {
         m_currentText.RemoveLast();
+        m_languageContext.DeleteLastCharacter();
         if (OnTextChanged) {
             OnTextChanged(m_currentText);
         }
@@ -180,6 +609,7 @@ void TextInputEngine::DeleteLastWord()
     } else {
         m_currentText.Clear();
     }
+    m_languageContext.DeleteLastWord();
 
     if (!m_wordHistory.empty()) {
         m_wordHistory.pop_back();
@@ -194,6 +624,7 @@ void TextInputEngine::Clear()
 {
     m_currentText.Clear();
     m_wordHistory.clear();
+    m_languageContext.Clear();
     if (OnTextChanged) {
         OnTextChanged(m_currentText);
     }
@@ -211,16 +642,10 @@ wxString TextInputEngine::PredictFromSwipe(const std::vector<std::pair<float, fl
         return wxEmptyString;
     }
 
-    // Step 1: Encode swipe path to embedding
-    std::vector<float> embedding = EncodeSwipe(swipePath);
-
-    // Step 2: Search vocabulary for candidates
-    std::map<faiss::idx_t, float> candidates = SearchVocabulary(embedding, 100);
+    // No swipe cache: it belongs to the prediction worker
+    std::vector<std::string> words = RunPrediction(swipePath, GetLanguageContext(), 1, nullptr);
 
-    // Step 3: Rank candidates using LightGBM
-    std::string prediction = RankCandidates(swipePath, candidates);
-
-    wxString result = wxString::FromUTF8(prediction.c_str());
+    wxString result = words.empty() ? wxString() : wxString::FromUTF8(words[0].c_str());
     if (OnPredictionReady) {
         OnPredictionReady(result);
     }
@@ -228,22 +653,247 @@ wxString TextInputEngine::PredictFromSwipe(const std::vector<std::pair<float, fl
     return result;
 }
 
-std::vector<wxString> TextInputEngine::PredictTopKFromSwipe(const std::vector<std::pair<float, float>>& swipePath, int k)
+std::vector<wxString> TextInputEngine::PredictTopKFromSwipe(const std::vector<std::pair<float, float>>& swipePath, int k,
+                                                            PredictionTimings* timings)
 {
-    // TODO: Implement top-K prediction
-    // For now, return single prediction
     std::vector<wxString> results;
-    wxString prediction = PredictFromSwipe(swipePath);
-    if (!prediction.IsEmpty()) {
-        results.push_back(prediction);
+    if (!m_initialized) {
+        wxLogWarning("TextInputEngine not initialized");
+        return results;
+    }
+
+    if (swipePath.empty()) {
+        wxLogWarning("Empty swipe path");
+        return results;
     }
 
+    if (k <= 0) {
+        wxLogWarning("PredictTopKFromSwipe: invalid k %d", k);
+        return results;
+    }
+
+    std::vector<std::string> words = RunPrediction(swipePath, GetLanguageContext(), static_cast<size_t>(k), nullptr,
+                                                   nullptr, timings);
+    for (const std::string& word : words) {
+        results.push_back(wxString::FromUTF8(word.c_str()));
+    }
+
+    if (OnPredictionReady) {
+        OnPredictionReady(results.empty() ? wxString() : results[0]);
+    }
     if (OnTopKPredictionsReady) {
         OnTopKPredictionsReady(results);
     }
     return results;
 }
 
+void TextInputEngine::PredictFromSwipeAsync(const std::vector<std::pair<float, float>>& swipePath)
+{
+    if (!m_initialized) {
+        wxLogWarning("TextInputEngine not initialized");
+        return;
+    }
+
+    if (swipePath.empty()) {
+        wxLogWarning("Empty swipe path");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        // Replaces any request the worker has not picked up yet; a request
+        // already running sees the new id and is abandoned at the next stage.
+        m_pendingRequest.id = ++m_latestRequestId;
+        m_pendingRequest.swipePath = swipePath;
+        m_pendingRequest.context = GetLanguageContext();
+        m_pendingRequest.partial = false;
+        m_hasPendingRequest = true;
+        m_finalInFlight = true;
+    }
+    m_requestCondition.notify_one();
+}
+
+void TextInputEngine::CancelPendingPredictions()
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    m_hasPendingRequest = false;
+    m_finalInFlight = false;
+    ++m_latestRequestId;
+}
+
+void TextInputEngine::PredictPartialSwipeAsync(const std::vector<std::pair<float, float>>& swipePath)
+{
+    // Speculative only: quietly skipped while models load
+    if (!m_initialized || swipePath.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        // The previous swipe's word comes first, the next partial catches up
+        if (m_finalInFlight) {
+            return;
+        }
+        m_pendingRequest.id = ++m_latestRequestId;
+        m_pendingRequest.swipePath = swipePath;
+        m_pendingRequest.context = GetLanguageContext();
+        m_pendingRequest.partial = true;
+        m_hasPendingRequest = true;
+    }
+    m_requestCondition.notify_one();
+}
+
+void TextInputEngine::CancelPartialPredictions()
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    if (m_finalInFlight) {
+        return;
+    }
+    m_hasPendingRequest = false;
+    ++m_latestRequestId;
+}
+
+void TextInputEngine::PredictionWorkerLoop()
+{
+    TRACE_THREAD_NAME("prediction");
+    for (;;) {
+        PredictionRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_requestMutex);
+            m_requestCondition.wait(lock, [this] { return m_stopWorker || m_hasPendingRequest; });
+            if (m_stopWorker) {
+                return;
+            }
+            request = std::move(m_pendingRequest);
+            m_pendingRequest = PredictionRequest();
+            m_hasPendingRequest = false;
+        }
+
+        const uint64_t requestId = request.id;
+        auto isCancelled = [this, requestId]() {
+            return m_latestRequestId.load() != requestId;
+        };
+
+        // Partial runs keep as many words as a final one, so a gesture that
+        // ends on the last partial path is answered from the swipe cache
+        const size_t topK = static_cast<size_t>(std::max(1, m_options.candidateCount));
+        std::vector<std::string> words = RunPrediction(request.swipePath, request.context, topK, isCancelled, m_swipeCache);
+        if (isCancelled()) {
+            continue;
+        }
+
+        wxThreadEvent* event = new wxThreadEvent(wxEVT_SWIPE_PREDICTION_DONE);
+        event->SetPayload(PredictionResult{requestId, words, request.partial});
+        wxQueueEvent(this, event);
+    }
+}
+
+void TextInputEngine::StopPredictionWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_stopWorker = true;
+        m_hasPendingRequest = false;
+        ++m_latestRequestId;
+    }
+    m_requestCondition.notify_one();
+
+    if (m_predictionThread.joinable()) {
+        m_predictionThread.join();
+    }
+}
+
+void TextInputEngine::OnPredictionResult(wxThreadEvent& event)
+{
+    PredictionResult result = event.GetPayload<PredictionResult>();
+
+    // A newer swipe (or a cancel) arrived while this event was queued
+    if (result.id != m_latestRequestId.load()) {
+        return;
+    }
+
+    wxString prediction = result.words.empty() ? wxString() : wxString::FromUTF8(result.words[0].c_str());
+    if (result.partial) {
+        if (OnProvisionalPrediction) {
+            OnProvisionalPrediction(prediction);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_finalInFlight = false;
+    }
+    if (OnPredictionReady) {
+        OnPredictionReady(prediction);
+    }
+
+    if (OnTopKPredictionsReady) {
+        std::vector<wxString> results;
+        results.reserve(result.words.size());
+        for (const std::string& word : result.words) {
+            results.push_back(wxString::FromUTF8(word.c_str()));
+        }
+        OnTopKPredictionsReady(results);
+    }
+}
+
+std::vector<std::string> TextInputEngine::RunPrediction(const std::vector<std::pair<float, float>>& swipePath,
+                                                        const LmContext& context,
+                                                        size_t topK,
+                                                        const std::function<bool()>& isCancelled,
+                                                        SwipeCache* cache,
+                                                        PredictionTimings* timings)
+{
+    typedef std::chrono::steady_clock Clock;
+    TRACE_SCOPE("predict");
+
+    // The buffers below and the ranker's scores are shared by every caller
+    std::lock_guard<std::mutex> pipelineLock(m_pipelineMutex);
+
+    // Gesture ended without new points since the last partial prediction
+    if (cache && !cache->lastPath.empty() && swipePath == cache->lastPath &&
+        context == cache->lastContext && topK <= cache->lastTopK) {
+        return std::vector<std::string>(cache->lastWords.begin(),
+                                        cache->lastWords.begin() + std::min(topK, cache->lastWords.size()));
+    }
+
+    // Step 1: Encode swipe path to embedding
+    Clock::time_point stageStart = Clock::now();
+    std::vector<float>& embedding = m_embedding;
+    EncodeSwipe(swipePath, embedding);
+    if (timings) {
+        timings->encodeMs = std::chrono::duration<double, std::milli>(Clock::now() - stageStart).count();
+        stageStart = Clock::now();
+    }
+    if (isCancelled && isCancelled()) {
+        return std::vector<std::string>();
+    }
+
+    // Step 2: Search vocabulary for candidates
+    std::map<faiss::idx_t, float> candidates = SearchVocabulary(embedding, std::max(1, m_options.faissTopK));
+    if (timings) {
+        timings->searchMs = std::chrono::duration<double, std::milli>(Clock::now() - stageStart).count();
+        stageStart = Clock::now();
+    }
+    if (isCancelled && isCancelled()) {
+        return std::vector<std::string>();
+    }
+
+    // Step 3: Rank candidates using LightGBM
+    std::vector<std::string> words = RankCandidates(swipePath, candidates, context, topK, cache);
+    if (timings) {
+        timings->rankMs = std::chrono::duration<double, std::milli>(Clock::now() - stageStart).count();
+    }
+    if (cache) {
+        cache->lastPath = swipePath;
+        cache->lastContext = context;
+        cache->lastTopK = topK;
+        cache->lastWords = words;
+    }
+    return words;
+}
+
 float TextInputEngine::EvaluateSequence(const std::vector<wxString>& words)
 {
 #ifdef USE_KENLM
@@ -253,8 +903,8 @@ float TextInputEngine::EvaluateSequence(const std::vector<wxString>& words)
     }
 
     try {
-        lm::ngram::Model* model = static_cast<lm::ngram::Model*>(m_kenLM);
-        lm::ngram::State in_state = model->BeginSentenceState();
+        const lm::base::Model* model = static_cast<const lm::base::Model*>(m_kenLM);
+        lm::ngram::State in_state = kenlm_begin_state(model);
         lm::ngram::State out_state;
         float total_log_prob = 0.0f;
 
@@ -265,15 +915,15 @@ float TextInputEngine::EvaluateSequence(const std::vector<wxString>& words)
             }
 
             std::string stdWord = word.ToStdString();
-            lm::WordIndex wordIndex = model->GetVocabulary().Index(stdWord);
-            lm::FullScoreReturn ret = model->FullScore(in_state, wordIndex, out_state);
+            lm::WordIndex wordIndex = kenlm_index(model, stdWord);
+            lm::FullScoreReturn ret = kenlm_full_score(model, in_state, wordIndex, out_state);
             total_log_prob += ret.prob;
             in_state = out_state;
         }
 
         // Add end of sentence score
-        lm::WordIndex endSentence = model->GetVocabulary().EndSentence();
-        lm::FullScoreReturn ret = model->FullScore(in_state, endSentence, out_state);
+        lm::WordIndex endSentence = kenlm_end_sentence(model);
+        lm::FullScoreReturn ret = kenlm_full_score(model, in_state, endSentence, out_state);
         total_log_prob += ret.prob;
 
         return total_log_prob;
@@ -288,11 +938,11 @@ float TextInputEngine::EvaluateSequence(const std::vector<wxString>& words)
 #endif
 }
 
-TextInputEngine::KenLMResult TextInputEngine::EvaluateIncremental(const std::vector<wxString>& words, float initialLogProb, void* initialState)
+TextInputEngine::KenLMResult TextInputEngine::EvaluateIncremental(const std::vector<wxString>& words, float initialLogProb,
+                                                                  const LmState* initialState)
 {
     KenLMResult result;
     result.logProb = initialLogProb;
-    result.state = nullptr;
 
 #ifdef USE_KENLM
     if (!m_kenLM) {
@@ -301,15 +951,15 @@ TextInputEngine::KenLMResult TextInputEngine::EvaluateIncremental(const std::vec
     }
 
     try {
-        lm::ngram::Model* model = static_cast<lm::ngram::Model*>(m_kenLM);
+        const lm::base::Model* model = static_cast<const lm::base::Model*>(m_kenLM);
         lm::ngram::State in_state;
-        lm::ngram::State* out_state = new lm::ngram::State();
+        lm::ngram::State out_state;
 
         // Use provided state or begin sentence state
         if (initialState != nullptr) {
-            in_state = *static_cast<lm::ngram::State*>(initialState);
+            in_state = kenlm_from_lm_state(*initialState);
         } else {
-            in_state = model->BeginSentenceState();
+            in_state = kenlm_begin_state(model);
         }
 
         float total_log_prob = initialLogProb;
@@ -320,20 +970,20 @@ TextInputEngine::KenLMResult TextInputEngine::EvaluateIncremental(const std::vec
                 continue;
             }
 
-            std::string stdWord = word.ToStdString();
-            lm::WordIndex wordIndex = model->GetVocabulary().Index(stdWord);
-            lm::FullScoreReturn ret = model->FullScore(in_state, wordIndex, *out_state);
+            std::string stdWord(word.ToUTF8());
+            lm::WordIndex wordIndex = kenlm_index(model, stdWord);
+            lm::FullScoreReturn ret = kenlm_full_score(model, in_state, wordIndex, out_state);
             total_log_prob += ret.prob;
-            in_state = *out_state;
+            in_state = out_state;
         }
+        result.state = kenlm_to_lm_state(in_state);
 
         // Add end of sentence score
-        lm::WordIndex endSentence = model->GetVocabulary().EndSentence();
-        lm::FullScoreReturn ret = model->FullScore(in_state, endSentence, *out_state);
+        lm::WordIndex endSentence = kenlm_end_sentence(model);
+        lm::FullScoreReturn ret = kenlm_full_score(model, in_state, endSentence, out_state);
         total_log_prob += ret.prob;
 
         result.logProb = total_log_prob;
-        result.state = out_state;
         return result;
     } catch (const std::exception& e) {
         wxLogError("Error in incremental evaluation: %s", e.what());
@@ -347,25 +997,25 @@ TextInputEngine::KenLMResult TextInputEngine::EvaluateIncremental(const std::vec
 #endif
 }
 
-void* TextInputEngine::GetBeginSentenceState()
+LmState TextInputEngine::GetBeginSentenceState()
 {
 #ifdef USE_KENLM
     if (!m_kenLM) {
         wxLogWarning("KenLM not initialized");
-        return nullptr;
+        return LmState();
     }
+    return kenlm_to_lm_state(kenlm_begin_state(static_cast<const lm::base::Model*>(m_kenLM)));
+#else
+    return LmState();
+#endif
+}
 
-    try {
-        lm::ngram::Model* model = static_cast<lm::ngram::Model*>(m_kenLM);
-        lm::ngram::State* state = new lm::ngram::State();
-        *state = model->BeginSentenceState();
-        return state;
-    } catch (const std::exception& e) {
-        wxLogError("Error getting begin sentence state: %s", e.what());
-        return nullptr;
-    }
+LmContext TextInputEngine::GetLanguageContext()
+{
+#ifdef USE_KENLM
+    return m_languageContext.GetContext(static_cast<const lm::base::Model*>(m_kenLM));
 #else
-    return nullptr;
+    return m_languageContext.GetContext(nullptr);
 #endif
 }
 
@@ -381,23 +1031,72 @@ bool TextInputEngine::LoadSwipeEncoder(const wxString& modelPath)
         return false;
     }
 
-    try {
-        Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "HeyEyeUnified");
-        Ort::SessionOptions sess_opt;
-        sess_opt.SetLogSeverityLevel(4); // Minimal logging
-        sess_opt.DisableCpuMemArena(); // Avoiding crashes
-
-        // Convert wxString to wstring for ONNX
-        std::wstring modelPathW = modelPath.ToStdWstring();
-        m_swipeEncoder = new Ort::Session(env, modelPathW.c_str(), sess_opt);
-        m_memoryInfo = new Ort::MemoryInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault));
+    // Convert wxString to wstring for ONNX
+    std::wstring modelPathW = modelPath.ToStdWstring();
+    std::vector<std::string> available;
 
-        wxLogMessage("Swipe encoder loaded successfully");
-        return true;
+    try {
+        // One environment for the engine lifetime, sessions must not outlive it
+        if (!m_ortEnv) {
+            m_ortEnv = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "HeyEyeUnified");
+        }
+        available = Ort::GetAvailableProviders();
     } catch (const Ort::Exception& e) {
         wxLogError("ONNX exception during swipe encoder loading: %s", e.what());
         return false;
     }
+
+    // First provider that loads, binds and runs the model wins
+    for (EncoderProvider provider : provider_order(m_options.executionProvider)) {
+        if (provider != PROVIDER_CPU && !provider_available(provider, available)) {
+            wxLogMessage("Swipe encoder: %s execution provider not available in this ONNX Runtime build",
+                         provider_name(provider));
+            continue;
+        }
+
+        try {
+            Ort::SessionOptions sess_opt;
+            sess_opt.SetLogSeverityLevel(4); // Minimal logging
+            if (!m_options.cpuMemArena) {
+                sess_opt.DisableCpuMemArena(); // Avoiding crashes
+            }
+
+            // Per-machine tuning (settings /ml/)
+            if (m_options.intraOpThreads > 0) {
+                sess_opt.SetIntraOpNumThreads(m_options.intraOpThreads);
+            }
+            switch (m_options.graphOptimizationLevel) {
+                case 0:  sess_opt.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL); break;
+                case 1:  sess_opt.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_BASIC); break;
+                case 2:  sess_opt.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED); break;
+                default: sess_opt.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL); break;
+            }
+            append_provider(sess_opt, provider);
+
+            m_swipeEncoder = new Ort::Session(*m_ortEnv, modelPathW.c_str(), sess_opt);
+            if (!m_memoryInfo) {
+                m_memoryInfo = new Ort::MemoryInfo(Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault));
+            }
+
+            if (CreateEncoderContext() && WarmUpEncoder()) {
+                m_encoderProvider = provider_name(provider);
+                wxLogMessage("Swipe encoder loaded successfully (%s, intra-op threads: %d, graph optimization: %d, cpu arena: %s)",
+                             m_encoderProvider, m_options.intraOpThreads, m_options.graphOptimizationLevel,
+                             m_options.cpuMemArena ? "on" : "off");
+                return true;
+            }
+        } catch (const Ort::Exception& e) {
+            wxLogWarning("Swipe encoder: %s execution provider failed: %s", provider_name(provider), e.what());
+        }
+
+        delete m_encoderContext;
+        m_encoderContext = nullptr;
+        delete m_swipeEncoder;
+        m_swipeEncoder = nullptr;
+    }
+
+    wxLogError("Swipe encoder: no execution provider could run %s", modelPath);
+    return false;
 #else
     wxLogWarning("ONNX support not compiled");
     return false;
@@ -414,17 +1113,35 @@ bool TextInputEngine::LoadVocabulary(const wxString& vocabPath)
     }
 
     std::string vocabPathStr = vocabPath.ToStdString();
-    auto vocabPair = load_vocab(vocabPathStr);
-    m_vocab = vocabPair.first;
-    m_vocabKeys = vocabPair.second;
-
-    if (m_vocab && m_vocabKeys) {
-        wxLogMessage("Vocabulary loaded successfully with %zu entries", m_vocab->size());
-        return true;
+    Vocabulary* vocab = new Vocabulary();
+
+    bool loaded = false;
+    if (wxFileName(vocabPath).GetExt().IsSameAs(wxT("msgpck"), false)) {
+        // Legacy format: parse, then flatten into the same layout as vocab.bin
+        auto vocabPair = load_vocab(vocabPathStr);
+        if (vocabPair.first) {
+            loaded = vocab->Build(*vocabPair.first);
+        }
+        delete vocabPair.first;
+        delete vocabPair.second;
+        if (loaded) {
+            wxLogMessage("Vocabulary: convert %s with HeyEyeVocabConvert for faster startup", vocabPath);
+        }
     } else {
+        loaded = vocab->Open(vocabPathStr);
+    }
+
+    if (!loaded) {
+        delete vocab;
         wxLogError("Failed to load vocabulary");
         return false;
     }
+
+    m_vocab = vocab;
+    wxLogMessage("Vocabulary loaded successfully with %zu entries (%zu words, %s)",
+                 m_vocab->GetKeyCount(), m_vocab->GetWordCount(),
+                 m_vocab->IsMapped() ? "mapped" : "in memory");
+    return true;
 }
 
 bool TextInputEngine::LoadFaissIndex(const wxString& indexPath)
@@ -440,7 +1157,12 @@ bool TextInputEngine::LoadFaissIndex(const wxString& indexPath)
     m_faissIndex = load_faiss_index(indexPathStr);
 
     if (m_faissIndex) {
-        wxLogMessage("FAISS index loaded successfully");
+        wxLogMessage("FAISS index loaded successfully: %s", describe_faiss_index(m_faissIndex));
+        std::string searchParameters = set_faiss_search_parameters(
+            m_faissIndex, m_options.faissNprobe, m_options.faissEfSearch);
+        if (!searchParameters.empty()) {
+            wxLogMessage("FAISS approximate search: %s", searchParameters);
+        }
         return true;
     } else {
         wxLogError("Failed to load FAISS index");
@@ -454,9 +1176,25 @@ bool TextInputEngine::LoadKenLM(const wxString& modelPath)
 #ifdef USE_KENLM
     try {
         std::string path = modelPath.ToStdString();
-        lm::ngram::Model* model = new lm::ngram::Model(path.c_str());
+
+        // Binary models are memory-mapped lazily: pages are faulted in on use
+        // and shared between processes. ARPA files are still parsed.
+        lm::ngram::Config config;
+        config.load_method = util::LAZY;
+
+        lm::ngram::ModelType modelType;
+        bool isBinary = lm::ngram::RecognizeBinary(path.c_str(), modelType);
+
+        wxLongLong startTime = wxGetLocalTimeMillis();
+        lm::base::Model* model = lm::ngram::LoadVirtual(path.c_str(), config);
         m_kenLM = static_cast<void*>(model);
-        wxLogMessage("KenLM model loaded successfully");
+
+        wxLogMessage("KenLM model loaded successfully (%s, order %u) in %lld ms",
+                     isBinary ? "binary" : "ARPA", model->Order(),
+                     (wxGetLocalTimeMillis() - startTime).GetValue());
+        if (!isBinary) {
+            wxLogMessage("KenLM: convert the ARPA file to binary (build target convert_kenlm) for faster startup");
+        }
         return true;
     } catch (const std::exception& e) {
         wxLogError("Failed to load KenLM model: %s", e.what());
@@ -480,86 +1218,167 @@ bool TextInputEngine::LoadLightGBM(const wxString& modelPath)
     m_lightGBM = new LightGBMRanker();
     std::string modelPathStr = modelPath.ToStdString();
 
-    if (m_lightGBM->load_model(modelPathStr)) {
-        wxLogMessage("LightGBM model loaded successfully");
+    LightGBMRanker::Backend backend = static_cast<LightGBMRanker::Backend>(m_options.rankerBackend);
+    if (m_lightGBM->load_model(modelPathStr, backend)) {
+        wxLogMessage("LightGBM model loaded successfully (%s)", m_lightGBM->get_backend_name());
+        if (!m_lightGBM->get_load_message().empty()) {
+            wxLogMessage("LightGBM: %s", m_lightGBM->get_load_message());
+        }
         return true;
     } else {
-        wxLogError("Failed to load LightGBM model");
+        wxLogError("Failed to load LightGBM model: %s", m_lightGBM->get_load_message());
         delete m_lightGBM;
         m_lightGBM = nullptr;
         return false;
     }
 }
 
-std::vector<float> TextInputEngine::EncodeSwipe(const std::vector<std::pair<float, float>>& swipePath)
+bool TextInputEngine::CreateEncoderContext()
 {
 #ifdef USE_ONNX
-    if (!m_swipeEncoder || !m_memoryInfo) {
-        wxLogError("Swipe encoder not initialized");
-        return std::vector<float>();
-    }
+    try {
+        delete m_encoderContext;
+        m_encoderContext = new EncoderContext();
+        EncoderContext& ctx = *m_encoderContext;
+
+        // The bindings are float: quantized models keep float I/O, FP16
+        // conversions must be exported with keep_io_types
+        ONNXTensorElementDataType inputType = m_swipeEncoder->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType();
+        ONNXTensorElementDataType outputType = m_swipeEncoder->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType();
+        if (inputType != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT || outputType != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+            wxLogError("Swipe encoder: input/output element types %d/%d, expected float "
+                       "(convert FP16 models with keep_io_types)", (int)inputType, (int)outputType);
+            delete m_encoderContext;
+            m_encoderContext = nullptr;
+            return false;
+        }
 
-    if (swipePath.empty()) {
-        wxLogWarning("Empty swipe path");
-        return std::vector<float>();
+        // Short buckets need a dynamic time axis, otherwise only the full length is bound
+        std::vector<int64_t> input_shape = m_swipeEncoder->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        bool dynamicLength = input_shape.size() == 3 && input_shape[1] < 0;
+
+        for (int length : ENCODER_BUCKETS) {
+            if (!dynamicLength && length != MAX_LENGTH_SWIPE) {
+                continue;
+            }
+            ctx.buckets.emplace_back(new EncoderBucket(*m_swipeEncoder, length));
+            bind_encoder_bucket(*m_swipeEncoder, *m_memoryInfo, *ctx.buckets.back());
+        }
+
+        if (!ctx.buckets.back()->boundOutput) {
+            wxLogWarning("Swipe encoder output shape is dynamic, output will be allocated per run");
+        }
+
+        if (ctx.buckets.size() > 1) {
+            // Masked padding must not change the embedding: compare the shortest
+            // bucket with the padded baseline on a synthetic swipe
+            std::vector<std::pair<float, float>> probe = make_probe_swipe(48);
+
+            std::vector<float> shortEmbedding;
+            std::vector<float> paddedEmbedding;
+            run_encoder_bucket(*m_swipeEncoder, *ctx.buckets.front(), probe, shortEmbedding);
+            run_encoder_bucket(*m_swipeEncoder, *ctx.buckets.back(), probe, paddedEmbedding);
+
+            float maxDiff = 0.0f;
+            float maxValue = 0.0f;
+            bool sameSize = shortEmbedding.size() == paddedEmbedding.size() && !paddedEmbedding.empty();
+            for (size_t i = 0; sameSize && i < paddedEmbedding.size(); ++i) {
+                maxDiff = std::max(maxDiff, std::abs(shortEmbedding[i] - paddedEmbedding[i]));
+                maxValue = std::max(maxValue, std::abs(paddedEmbedding[i]));
+            }
+
+            // Quantization noise differs between shapes, reduced precision packs get more slack
+            const float tolerance = m_modelPack.IsReducedPrecision() ? 2e-2f : 1e-3f;
+            if (!sameSize || maxDiff > tolerance * std::max(1.0f, maxValue)) {
+                wxLogWarning("Swipe encoder: bucketed lengths differ from padded baseline (max diff %g), using %d only",
+                             maxDiff, MAX_LENGTH_SWIPE);
+                ctx.buckets.erase(ctx.buckets.begin(), ctx.buckets.end() - 1);
+            } else {
+                wxLogMessage("Swipe encoder: dynamic length, %zu buckets (max diff vs padded %g)",
+                             ctx.buckets.size(), maxDiff);
+            }
+        }
+
+        return true;
+    } catch (const Ort::Exception& e) {
+        wxLogError("ONNX exception while binding swipe encoder I/O: %s", e.what());
+        delete m_encoderContext;
+        m_encoderContext = nullptr;
+        return false;
     }
+#else
+    return false;
+#endif
+}
 
+bool TextInputEngine::WarmUpEncoder()
+{
+#ifdef USE_ONNX
+    typedef std::chrono::steady_clock Clock;
     try {
-        // Convert swipe path to flat vector
-        std::vector<float> all_points;
-        all_points.reserve(swipePath.size() * 2);
-        for (const auto& point : swipePath) {
-            all_points.push_back(point.first);
-            all_points.push_back(point.second);
-        }
-
-        // Prepare positions
-        std::vector<int64_t> positions;
-        positions.reserve(MAX_LENGTH_SWIPE);
-        for (int i = 0; i < MAX_LENGTH_SWIPE; ++i) {
-            positions.push_back(i);
-        }
-
-        // Prepare mask
-        std::vector<uint8_t> mask;
-        size_t keep_last = 2 * MAX_LENGTH_SWIPE;
-
-        if (all_points.size() > keep_last) {
-            // Crop to keep last MAX_LENGTH_SWIPE points
-            all_points.erase(all_points.begin(), all_points.end() - keep_last);
-            mask.resize(all_points.size() / 2, 0);
-        } else if (all_points.size() < keep_last) {
-            // Pad with -200
-            mask.resize(all_points.size() / 2, 0);
-            all_points.resize(keep_last, -200.0f);
-            mask.resize(all_points.size() / 2, 1);
-        } else {
-            mask.resize(all_points.size() / 2, 0);
+        // Each bound shape pays its initialization on its first run
+        EncoderContext& ctx = *m_encoderContext;
+        std::vector<float> embedding;
+        const Clock::time_point start = Clock::now();
+        for (const auto& bucket : ctx.buckets) {
+            run_encoder_bucket(*m_swipeEncoder, *bucket, make_probe_swipe(bucket->length), embedding);
         }
+        const double firstMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
 
-        // Create input tensors
-        std::array<int64_t, 3> input_shape{1, MAX_LENGTH_SWIPE, 2};
-        std::array<int64_t, 2> positions_shape{1, MAX_LENGTH_SWIPE};
-        std::array<int64_t, 2> mask_shape{1, MAX_LENGTH_SWIPE};
+        const Clock::time_point rerun = Clock::now();
+        run_encoder_bucket(*m_swipeEncoder, *ctx.buckets.back(), make_probe_swipe(MAX_LENGTH_SWIPE), embedding);
+        const double steadyMs = std::chrono::duration<double, std::milli>(Clock::now() - rerun).count();
 
-        std::vector<const char*> input_node_names = {"input", "positions", "mask"};
-        std::vector<const char*> output_node_names = {"output"};
+        if (embedding.empty()) {
+            wxLogWarning("Swipe encoder: warm-up run produced no embedding");
+            return false;
+        }
+        m_embeddingSize = embedding.size();
+        m_embedding.reserve(m_embeddingSize);
+        wxLogMessage("Swipe encoder: warm-up of %zu length(s) in %.1f ms, then %.1f ms per %d-point run",
+                     ctx.buckets.size(), firstMs, steadyMs, MAX_LENGTH_SWIPE);
+        return true;
+    } catch (const Ort::Exception& e) {
+        wxLogWarning("ONNX exception during swipe encoder warm-up: %s", e.what());
+        return false;
+    }
+#else
+    return false;
+#endif
+}
 
-        std::vector<Ort::Value> inputTensors;
-        inputTensors.emplace_back(Ort::Value::CreateTensor<float>(*m_memoryInfo, all_points.data(), all_points.size(), input_shape.data(), input_shape.size()));
-        inputTensors.emplace_back(Ort::Value::CreateTensor<int64_t>(*m_memoryInfo, positions.data(), positions.size(), positions_shape.data(), positions_shape.size()));
-        inputTensors.emplace_back(Ort::Value::CreateTensor<bool>(*m_memoryInfo, reinterpret_cast<bool*>(mask.data()), mask.size(), mask_shape.data(), mask_shape.size()));
+bool TextInputEngine::EncodeSwipe(const std::vector<std::pair<float, float>>& swipePath, std::vector<float>& embedding)
+{
+    TRACE_SCOPE("encode");
+    embedding.clear();
 
-        // Run inference
-        std::vector<Ort::Value> outputTensor = m_swipeEncoder->Run(Ort::RunOptions{nullptr}, input_node_names.data(), inputTensors.data(), inputTensors.size(), output_node_names.data(), 1);
+#ifdef USE_ONNX
+    if (!m_swipeEncoder || !m_encoderContext) {
+        wxLogError("Swipe encoder not initialized");
+        return false;
+    }
 
-        if (outputTensor.size() > 0) {
-            int nb_embedding = outputTensor[0].GetTensorTypeAndShapeInfo().GetShape()[1];
-            const float* output_data = outputTensor[0].GetTensorData<float>();
+    if (swipePath.empty()) {
+        wxLogWarning("Empty swipe path");
+        return false;
+    }
+
+    EncoderContext& ctx = *m_encoderContext;
+    std::lock_guard<std::mutex> lock(ctx.mutex);
 
-            std::vector<float> embedding(output_data, output_data + nb_embedding);
-            return embedding;
+    // Shortest bound length that holds the swipe (the last bucket crops to
+    // the last MAX_LENGTH_SWIPE points)
+    EncoderBucket* bucket = ctx.buckets.back().get();
+    for (const auto& candidate : ctx.buckets) {
+        if (static_cast<size_t>(candidate->length) >= swipePath.size()) {
+            bucket = candidate.get();
+            break;
         }
+    }
+
+    try {
+        run_encoder_bucket(*m_swipeEncoder, *bucket, swipePath, embedding);
+        return !embedding.empty();
     } catch (const Ort::Exception& e) {
         wxLogError("ONNX exception during swipe encoding: %s", e.what());
     }
@@ -568,11 +1387,12 @@ std::vector<float> TextInputEngine::EncodeSwipe(const std::vector<std::pair<floa
     wxLogWarning("ONNX support not compiled");
 #endif
 
-    return std::vector<float>();
+    return false;
 }
 
 std::map<faiss::idx_t, float> TextInputEngine::SearchVocabulary(const std::vector<float>& embedding, int topK)
 {
+    TRACE_SCOPE("search");
     if (!m_faissIndex) {
         wxLogError("FAISS index not initialized");
         return std::map<faiss::idx_t, float>();
@@ -583,177 +1403,167 @@ std::map<faiss::idx_t, float> TextInputEngine::SearchVocabulary(const std::vecto
         return std::map<faiss::idx_t, float>();
     }
 
-    std::vector<float> embedding_copy = embedding;
-    return search_faiss_index(&embedding_copy, m_faissIndex, topK);
+    return search_faiss_index(&embedding, m_faissIndex, topK);
 }
 
-std::string TextInputEngine::RankCandidates(
+std::vector<std::string> TextInputEngine::RankCandidates(
     const std::vector<std::pair<float, float>>& swipePath,
-    const std::map<faiss::idx_t, float>& candidates)
+    const std::map<faiss::idx_t, float>& candidates,
+    const LmContext& context,
+    size_t topK,
+    SwipeCache* cache)
 {
-    if (!m_vocab || !m_vocabKeys) {
+    TRACE_SCOPE("rank");
+    if (!m_vocab) {
         wxLogError("Vocabulary not initialized");
-        return "";
+        return std::vector<std::string>();
     }
 
     if (candidates.empty()) {
         wxLogWarning("No candidates to rank");
-        return "";
+        return std::vector<std::string>();
     }
 
-    // Step 1: Pre-compute initial LM state from current text
-    // This matches HeyEyeTracker behavior (gaze_track.cpp:169-183)
-    float initial_log_prob = 0.0f;
-    lm::ngram::State initial_state;
-    std::vector<wxString> context_words;
+    // Step 1: Collect all unique candidate words and compute LM scores. The
+    // context (<s> and the last 4 words of the text, same as HeyEyeTracker
+    // gaze_track.cpp:169-183) was scored as the text was typed.
+    std::vector<CandidateRef> candidate_refs = collect_candidates(candidates, *m_vocab);
+    std::vector<float> lm_scores(candidate_refs.size(), context.logProb);
 
 #ifdef USE_KENLM
     if (m_kenLM) {
-        lm::ngram::Model* model = static_cast<lm::ngram::Model*>(m_kenLM);
-        initial_state = model->BeginSentenceState();
-
-        // Extract word context from current text (split by spaces)
-        if (!m_currentText.IsEmpty()) {
-            wxArrayString all_words = wxSplit(m_currentText, ' ', '\0');
-            for (const wxString& word : all_words) {
-                if (!word.IsEmpty()) {
-                    context_words.push_back(word);
-                }
+        TRACE_SCOPE("lm");
+        const lm::base::Model* model = static_cast<const lm::base::Model*>(m_kenLM);
+        const lm::WordIndex endSentence = kenlm_end_sentence(model);
+        const lm::ngram::State initial_state = context.valid ? kenlm_from_lm_state(context.state)
+                                                             : kenlm_begin_state(model);
+
+        // Resolve the model index of every word (serial: Vocabulary::GetLmIndex
+        // is a lookup, the fallback a hash probe) and take the scores an
+        // earlier swipe computed in the same context state
+        enum { LM_PENDING, LM_CACHED, LM_COMPUTED, LM_FAILED };
+        std::vector<uint32_t> lm_index(candidate_refs.size());
+        std::vector<LmWordScore> lm_word_scores(candidate_refs.size());
+        std::vector<uint8_t> lm_status(candidate_refs.size(), LM_PENDING);
+        for (size_t i = 0; i < candidate_refs.size(); ++i) {
+            const uint32_t word_id = candidate_refs[i].word_id;
+            uint32_t wordIndex = m_vocab->GetLmIndex(word_id);
+            if (wordIndex == Vocabulary::NO_LM_INDEX) {
+                wordIndex = kenlm_index(model, std::string(m_vocab->GetWord(word_id)));
             }
-
-            // Keep only last 4 words for context (same as HeyEyeTracker)
-            if (context_words.size() > 4) {
-                context_words.erase(context_words.begin(), context_words.end() - 4);
-            }
-
-            // Pre-compute LM state for context words (optimization)
-            try {
-                lm::ngram::State out_state;
-                for (const wxString& context_word : context_words) {
-                    std::string stdWord = context_word.ToStdString();
-                    lm::WordIndex wordIndex = model->GetVocabulary().Index(stdWord);
-                    lm::FullScoreReturn ret = model->FullScore(initial_state, wordIndex, out_state);
-                    initial_log_prob += ret.prob;
-                    initial_state = out_state;
+            lm_index[i] = wordIndex;
+            if (cache && context.valid) {
+                LmScoreKey key{context.state, wordIndex};
+                if (cache->lmScores.Get(key, lm_word_scores[i])) {
+                    lm_status[i] = LM_CACHED;
                 }
-            } catch (const std::exception& e) {
-                wxLogWarning("Error pre-computing LM context: %s", e.what());
-                // Reset to begin state on error
-                initial_state = model->BeginSentenceState();
-                initial_log_prob = 0.0f;
             }
         }
-    }
-#endif
-
-    // Step 2: Collect all candidate words and compute LM scores
-    std::vector<std::string> candidate_words;
-    std::vector<float> lm_scores;
-    std::set<std::string> seen_words;
-
-    for (const auto& faiss_pair : candidates) {
-        int vocab_idx = faiss_pair.first;
-
-        if (m_vocab->find(vocab_idx) == m_vocab->end()) {
-            continue;
-        }
-
-        const std::vector<std::string>& words = m_vocab->at(vocab_idx);
 
-        for (const std::string& word : words) {
-            if (seen_words.count(word) > 0) {
-                continue;
-            }
-            seen_words.insert(word);
-
-            // Compute LM score starting from pre-computed context state
-            float lm_score = initial_log_prob;
-#ifdef USE_KENLM
-            if (m_kenLM) {
+        // KenLM queries are const and thread safe, every candidate owns its slot
+        auto score_candidates = [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                if (lm_status[i] == LM_CACHED) {
+                    continue;
+                }
                 try {
-                    lm::ngram::Model* model = static_cast<lm::ngram::Model*>(m_kenLM);
                     lm::ngram::State out_state;
 
                     // Score the candidate word (starting from context state)
-                    lm::WordIndex wordIndex = model->GetVocabulary().Index(word);
-                    lm::FullScoreReturn ret = model->FullScore(initial_state, wordIndex, out_state);
-                    lm_score += ret.prob;
+                    lm::FullScoreReturn ret = kenlm_full_score(model, initial_state, lm_index[i], out_state);
+                    lm_word_scores[i].word = ret.prob;
 
                     // Add end of sentence score
-                    lm::WordIndex endSentence = model->GetVocabulary().EndSentence();
-                    ret = model->FullScore(out_state, endSentence, out_state);
-                    lm_score += ret.prob;
+                    ret = kenlm_full_score(model, out_state, endSentence, out_state);
+                    lm_word_scores[i].endSentence = ret.prob;
+                    lm_status[i] = LM_COMPUTED;
                 } catch (const std::exception& e) {
-                    wxLogWarning("Error evaluating LM for word '%s': %s", word.c_str(), e.what());
+                    lm_status[i] = LM_FAILED;
+                    wxLogWarning("Error evaluating LM for word '%s': %s",
+                                 std::string(m_vocab->GetWord(candidate_refs[i].word_id)).c_str(), e.what());
                 }
             }
-#endif
+        };
+
+        if (m_rankingPool) {
+            m_rankingPool->ParallelFor(candidate_refs.size(), 64, score_candidates);
+        } else {
+            score_candidates(0, candidate_refs.size());
+        }
 
-            candidate_words.push_back(word);
-            lm_scores.push_back(lm_score);
+        // Same summation order as a fresh score, cached or not
+        for (size_t i = 0; i < candidate_refs.size(); ++i) {
+            if (lm_status[i] == LM_FAILED) {
+                continue;
+            }
+            lm_scores[i] = (context.logProb + lm_word_scores[i].word) + lm_word_scores[i].endSentence;
+            if (cache && context.valid && lm_status[i] == LM_COMPUTED) {
+                cache->lmScores.Put(LmScoreKey{context.state, lm_index[i]}, lm_word_scores[i]);
+            }
         }
     }
+#endif
 
-    if (candidate_words.empty()) {
+    if (candidate_refs.empty()) {
         wxLogWarning("No valid candidate words after processing");
-        return "";
+        return std::vector<std::string>();
     }
 
     // Step 2: Use LightGBM ranker if available
-    std::string selected_word = "";
+    std::vector<std::string> selected_words;
 
     if (m_lightGBM && m_lightGBM->is_model_loaded()) {
         try {
             // Compute all features
-            std::vector<CandidateFeatures> features = compute_all_features(
+            DtwOptions dtw_options;
+            dtw_options.window = m_options.dtwWindow;
+            dtw_options.prune_top_k = m_options.dtwPruneTopK;
+            CandidateBatch& batch = *m_candidateBatch;
+            compute_all_features(
                 swipePath,
-                candidates,
-                m_vocab,
-                m_vocabKeys,
+                *m_vocab,
+                candidate_refs,
                 lm_scores,
-                candidate_words
+                batch,
+                dtw_options,
+                m_rankingPool,
+                cache ? &cache->dtwRows : nullptr
             );
 
             // Rank candidates
-            std::vector<size_t> ranked_indices = m_lightGBM->rank_candidates(features);
-
-            if (!ranked_indices.empty()) {
-                selected_word = features[ranked_indices[0]].word;
+            {
+                TRACE_SCOPE("lightgbm");
+                m_lightGBM->rank_candidates(batch, m_rankOrder);
+            }
 
-                // Debug: Show top 5 predictions
-                wxLogMessage("LightGBM Top 5 predictions:");
-                for (size_t i = 0; i < std::min(size_t(5), ranked_indices.size()); ++i) {
-                    wxString word = wxString::FromUTF8(features[ranked_indices[i]].word.c_str());
-                    wxLogMessage("  %zu. %s", i + 1, word);
-                }
+            const size_t count = std::min(topK, m_rankOrder.size());
+            selected_words.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                selected_words.emplace_back(m_vocab->GetWord(batch.GetWordId(m_rankOrder[i])));
             }
         } catch (const std::exception& e) {
             wxLogError("Error during LightGBM ranking: %s", e.what());
         }
     } else {
-        // Fallback: simple scoring (LM score - 0.5 * FAISS distance)
-        wxLogMessage("Using fallback scoring (LightGBM not available)");
-        float max_score = -std::numeric_limits<float>::infinity();
-
-        for (size_t i = 0; i < candidate_words.size(); ++i) {
-            // Find corresponding FAISS distance
-            float faiss_distance = 0.0f;
-            for (const auto& faiss_pair : candidates) {
-                const auto& words = m_vocab->at(faiss_pair.first);
-                if (std::find(words.begin(), words.end(), candidate_words[i]) != words.end()) {
-                    faiss_distance = faiss_pair.second;
-                    break;
-                }
-            }
-
-            float score = lm_scores[i] - 0.5f * faiss_distance;
+        // Fallback: simple scoring (LM score - 0.5 * FAISS distance), the
+        // distance travels with each candidate so no lookup is needed
+        std::vector<float> scores(candidate_refs.size());
+        std::vector<size_t> order(candidate_refs.size());
+        for (size_t i = 0; i < candidate_refs.size(); ++i) {
+            scores[i] = lm_scores[i] - 0.5f * candidate_refs[i].faiss_distance;
+            order[i] = i;
+        }
 
-            if (score > max_score) {
-                max_score = score;
-                selected_word = candidate_words[i];
-            }
+        // Best first, ties keep the candidate order (first best word wins)
+        const size_t count = std::min(topK, order.size());
+        std::partial_sort(order.begin(), order.begin() + count, order.end(), [&scores](size_t a, size_t b) {
+            return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+        });
+        selected_words.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            selected_words.emplace_back(m_vocab->GetWord(candidate_refs[order[i]].word_id));
         }
     }
 
-    return selected_word;
+    return selected_words;
 }
@@ -0,0 +1,134 @@
+#include "threadpool.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : m_stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    TRACE_THREAD_NAME("pool worker");
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;  // Stopping and drained
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = (count + grain - 1) / grain;
+
+    std::atomic<size_t> nextChunk(0);
+    auto runChunks = [&]() {
+        for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+            size_t begin = chunk * grain;
+            body(begin, std::min(count, begin + grain));
+        }
+    };
+
+    // Helpers still queued when the caller is done never touch body or the
+    // counter (they live on this stack), so only the running ones are waited
+    // for: a caller on a worker cannot block on a helper queued behind it
+    struct HelperState {
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool closed = false;   // The caller stopped waiting for new helpers
+        size_t running = 0;
+        std::exception_ptr error;
+    };
+    std::shared_ptr<HelperState> state = std::make_shared<HelperState>();
+
+    const size_t helperCount = std::min(m_threads.size(), chunks - 1);
+    for (size_t i = 0; i < helperCount; ++i) {
+        Enqueue([state, &runChunks, &nextChunk, chunks]() {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->closed) {
+                    return;
+                }
+                ++state->running;
+            }
+            std::exception_ptr error;
+            try {
+                runChunks();
+            } catch (...) {
+                error = std::current_exception();
+                nextChunk = chunks;  // Stop handing out chunks
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (error && !state->error) {
+                state->error = error;
+            }
+            if (--state->running == 0) {
+                state->finished.notify_all();
+            }
+        });
+    }
+
+    std::exception_ptr error;
+    try {
+        runChunks();
+    } catch (...) {
+        error = std::current_exception();
+        nextChunk = chunks;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->closed = true;
+        state->finished.wait(lock, [&state] { return state->running == 0; });
+        if (!error) {
+            error = state->error;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
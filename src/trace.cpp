@@ -0,0 +1,206 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static void write_json_string(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+Tracer& Tracer::Get()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+uint64_t Tracer::Now()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()) + 1;
+}
+
+Tracer::Tracer()
+    : m_enabled(false)
+    , m_drainBuffer(THREAD_BUFFER_SIZE)
+    , m_historyNext(0)
+{
+    m_history.reserve(HISTORY_SIZE);
+}
+
+Tracer::ThreadBuffer* Tracer::GetThreadBuffer()
+{
+    // The rings live as long as the tracer, threads that exit simply stop pushing
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        created->id = static_cast<uint32_t>(m_threads.size() + 1);
+        buffer = created.get();
+        m_threads.push_back(std::move(created));
+    }
+    return buffer;
+}
+
+void Tracer::Record(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    TraceEvent event;
+    event.name = name;
+    event.start = start;
+    event.duration = end > start ? end - start : 0;
+    event.thread = buffer->id;
+    buffer->events.TryPush(event);
+}
+
+void Tracer::SetThreadName(const char* name)
+{
+    GetThreadBuffer()->name.store(name, std::memory_order_release);
+}
+
+void Tracer::Drain()
+{
+    // Threads registered after the copy are drained next time
+    std::vector<ThreadBuffer*> threads;
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        threads.reserve(m_threads.size());
+        for (const auto& thread : m_threads) {
+            threads.push_back(thread.get());
+        }
+    }
+
+    for (ThreadBuffer* thread : threads) {
+        size_t count = thread->events.PopBatch(m_drainBuffer.data(), m_drainBuffer.size());
+        for (size_t i = 0; i < count; ++i) {
+            Accumulate(m_drainBuffer[i]);
+        }
+    }
+}
+
+void Tracer::Accumulate(const TraceEvent& event)
+{
+    if (m_history.size() < HISTORY_SIZE) {
+        m_history.push_back(event);
+    } else {
+        m_history[m_historyNext] = event;
+    }
+    m_historyNext = (m_historyNext + 1) % HISTORY_SIZE;
+
+    // A handful of names: a linear scan beats hashing, same literal = same pointer
+    Window* window = nullptr;
+    for (Window& candidate : m_windows) {
+        if (candidate.name == event.name || std::strcmp(candidate.name, event.name) == 0) {
+            window = &candidate;
+            break;
+        }
+    }
+    if (!window) {
+        m_windows.push_back(Window{event.name, 0, 0.0, std::vector<float>()});
+        window = &m_windows.back();
+        window->durations.reserve(ROLLING_WINDOW);
+    }
+
+    const float milliseconds = event.duration / 1000.0f;
+    if (window->durations.size() < ROLLING_WINDOW) {
+        window->durations.push_back(milliseconds);
+    } else {
+        window->durations[window->count % ROLLING_WINDOW] = milliseconds;
+    }
+    window->count++;
+    window->lastMs = milliseconds;
+}
+
+std::vector<TraceStageStats> Tracer::GetStats() const
+{
+    std::vector<TraceStageStats> stats;
+    stats.reserve(m_windows.size());
+
+    std::vector<float> sorted;
+    for (const Window& window : m_windows) {
+        sorted = window.durations;
+        std::sort(sorted.begin(), sorted.end());
+
+        TraceStageStats stage;
+        stage.name = window.name;
+        stage.count = window.count;
+        stage.lastMs = window.lastMs;
+        stage.p50Ms = sorted[(sorted.size() - 1) / 2];
+        stage.p95Ms = sorted[(sorted.size() - 1) * 95 / 100];
+        stage.maxMs = sorted.back();
+        stats.push_back(stage);
+    }
+    return stats;
+}
+
+uint64_t Tracer::GetDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_threadsMutex);
+    uint64_t dropped = 0;
+    for (const auto& thread : m_threads) {
+        dropped += thread->events.GetDroppedCount();
+    }
+    return dropped;
+}
+
+bool Tracer::ExportChromeTrace(const std::string& filepath)
+{
+    Drain();
+
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to create trace file: " << filepath << std::endl;
+        return false;
+    }
+
+    // Oldest first, timestamps relative to the oldest event kept
+    const size_t count = m_history.size();
+    const size_t first = count < HISTORY_SIZE ? 0 : m_historyNext;
+    uint64_t origin = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const TraceEvent& event = m_history[(first + i) % HISTORY_SIZE];
+        if (origin == 0 || event.start < origin) {
+            origin = event.start;
+        }
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool separator = false;
+    {
+        std::lock_guard<std::mutex> lock(m_threadsMutex);
+        for (const auto& thread : m_threads) {
+            const char* name = thread->name.load(std::memory_order_acquire);
+            if (!name) {
+                continue;
+            }
+            file << (separator ? ",\n" : "") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                 << thread->id << ",\"args\":{\"name\":";
+            write_json_string(file, name);
+            file << "}}";
+            separator = true;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const TraceEvent& event = m_history[(first + i) % HISTORY_SIZE];
+        file << (separator ? ",\n" : "") << "{\"name\":";
+        write_json_string(file, event.name);
+        file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << (event.start - origin)
+             << ",\"dur\":" << event.duration << "}";
+        separator = true;
+    }
+    file << "\n]}\n";
+
+    if (!file.good()) {
+        std::cerr << "Failed to write trace file: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,298 @@
+#include "treeensemble.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// LightGBM drops |value| <= kZeroThreshold from dense rows (they read as 0)
+const double ZERO_THRESHOLD = 1e-35f;
+
+// decision_type bits (LightGBM tree.h)
+const int CATEGORICAL_MASK = 1;
+const int DEFAULT_LEFT_MASK = 2;
+
+const uint8_t MISSING_ZERO = 1;
+const uint8_t MISSING_NAN = 2;
+
+bool starts_with(const std::string& text, const char* prefix) {
+    return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+template <typename T>
+bool parse_list(const std::string& text, size_t expected, std::vector<T>& values) {
+    values.clear();
+    const char* cursor = text.c_str();
+    while (*cursor) {
+        char* end = nullptr;
+        double value = std::strtod(cursor, &end);
+        if (end == cursor) {
+            return false;
+        }
+        values.push_back(static_cast<T>(value));
+        cursor = end;
+        while (*cursor == ' ') {
+            ++cursor;
+        }
+    }
+    return values.size() == expected;
+}
+
+const std::string* find_field(const std::vector<std::pair<std::string, std::string>>& fields, const char* key) {
+    for (const auto& field : fields) {
+        if (field.first == key) {
+            return &field.second;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TreeEnsemble::TreeEnsemble()
+    : m_featureCount(0)
+    , m_sigmoid(0.0)
+{
+}
+
+void TreeEnsemble::Clear()
+{
+    m_featureCount = 0;
+    m_sigmoid = 0.0;
+    m_nodes.clear();
+    m_leaves.clear();
+    m_treeRoots.clear();
+    m_treeLeafBegin.clear();
+    m_treeSingleLeaf.clear();
+    m_featureThresholds.clear();
+}
+
+bool TreeEnsemble::Load(const std::string& filepath, std::string& error)
+{
+    std::ifstream ifs(filepath, std::ios::binary);
+    if (!ifs) {
+        error = "cannot open " + filepath;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << ifs.rdbuf();
+    return LoadFromString(buffer.str(), error);
+}
+
+bool TreeEnsemble::LoadFromString(const std::string& model, std::string& error)
+{
+    Clear();
+
+    std::istringstream lines(model);
+    std::string line;
+    std::vector<std::pair<std::string, std::string>> tree;
+    bool inTree = false;
+    bool objectiveSeen = false;
+
+    auto finishTree = [&]() {
+        bool ok = !inTree || ParseTree(tree, error);
+        tree.clear();
+        inTree = false;
+        return ok;
+    };
+
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (starts_with(line, "Tree=")) {
+            if (!finishTree()) {
+                Clear();
+                return false;
+            }
+            inTree = true;
+            continue;
+        }
+        if (line == "end of trees") {
+            break;
+        }
+
+        size_t equals = line.find('=');
+        std::string key = line.substr(0, equals);
+        std::string value = (equals == std::string::npos) ? std::string() : line.substr(equals + 1);
+
+        if (inTree) {
+            if (!line.empty()) {
+                tree.emplace_back(key, value);
+            }
+            continue;
+        }
+
+        // Model header
+        if (key == "num_class" || key == "num_tree_per_iteration") {
+            if (std::atoi(value.c_str()) != 1) {
+                error = "multiclass models are not supported";
+                return false;
+            }
+        } else if (key == "max_feature_idx") {
+            m_featureCount = std::atoi(value.c_str()) + 1;
+        } else if (key == "average_output") {
+            error = "random forest output averaging is not supported";
+            return false;
+        } else if (key == "objective") {
+            objectiveSeen = true;
+            std::istringstream parts(value);
+            std::string name, parameter;
+            parts >> name;
+            if (name == "binary") {
+                m_sigmoid = 1.0;
+                while (parts >> parameter) {
+                    if (starts_with(parameter, "sigmoid:")) {
+                        m_sigmoid = std::strtod(parameter.c_str() + 8, nullptr);
+                    }
+                }
+            } else if (name != "lambdarank" && name != "rank_xendcg" && name != "regression" &&
+                       name != "regression_l1" && name != "huber" && name != "fair" && name != "quantile") {
+                error = "objective '" + name + "' has an unsupported output transform";
+                return false;
+            }
+        }
+    }
+
+    if (!finishTree()) {
+        Clear();
+        return false;
+    }
+    if (!objectiveSeen || m_featureCount <= 0 || m_treeRoots.empty()) {
+        error = "not a LightGBM text model";
+        Clear();
+        return false;
+    }
+
+    for (std::vector<double>& thresholds : m_featureThresholds) {
+        std::sort(thresholds.begin(), thresholds.end());
+        thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    }
+    m_featureThresholds.resize(m_featureCount);
+    return true;
+}
+
+bool TreeEnsemble::ParseTree(const std::vector<std::pair<std::string, std::string>>& fields, std::string& error)
+{
+    const std::string* numLeavesText = find_field(fields, "num_leaves");
+    const std::string* leafValueText = find_field(fields, "leaf_value");
+    if (!numLeavesText || !leafValueText) {
+        error = "tree without num_leaves or leaf_value";
+        return false;
+    }
+    const std::string* numCat = find_field(fields, "num_cat");
+    const std::string* isLinear = find_field(fields, "is_linear");
+    if ((numCat && std::atoi(numCat->c_str()) != 0) || (isLinear && std::atoi(isLinear->c_str()) != 0)) {
+        error = "categorical splits and linear trees are not supported";
+        return false;
+    }
+
+    const size_t numLeaves = std::atoi(numLeavesText->c_str());
+    std::vector<double> leafValues;
+    if (numLeaves == 0 || !parse_list(*leafValueText, numLeaves, leafValues)) {
+        error = "malformed leaf_value";
+        return false;
+    }
+
+    m_treeRoots.push_back(static_cast<uint32_t>(m_nodes.size()));
+    m_treeLeafBegin.push_back(static_cast<uint32_t>(m_leaves.size()));
+    m_treeSingleLeaf.push_back(numLeaves == 1 ? 1 : 0);
+    m_leaves.insert(m_leaves.end(), leafValues.begin(), leafValues.end());
+    if (numLeaves == 1) {
+        return true;
+    }
+
+    const size_t numNodes = numLeaves - 1;
+    std::vector<int> splitFeature, decisionType, leftChild, rightChild;
+    std::vector<double> threshold;
+    const std::string* text[5] = {find_field(fields, "split_feature"), find_field(fields, "threshold"),
+                                  find_field(fields, "decision_type"), find_field(fields, "left_child"),
+                                  find_field(fields, "right_child")};
+    for (const std::string* field : text) {
+        if (!field) {
+            error = "tree without split arrays";
+            return false;
+        }
+    }
+    if (!parse_list(*text[0], numNodes, splitFeature) || !parse_list(*text[1], numNodes, threshold) ||
+        !parse_list(*text[2], numNodes, decisionType) || !parse_list(*text[3], numNodes, leftChild) ||
+        !parse_list(*text[4], numNodes, rightChild)) {
+        error = "malformed split arrays";
+        return false;
+    }
+
+    for (size_t i = 0; i < numNodes; ++i) {
+        if (decisionType[i] & CATEGORICAL_MASK) {
+            error = "categorical splits are not supported";
+            return false;
+        }
+        if (splitFeature[i] < 0 || leftChild[i] >= static_cast<int>(numNodes) || rightChild[i] >= static_cast<int>(numNodes) ||
+            ~leftChild[i] >= static_cast<int>(numLeaves) || ~rightChild[i] >= static_cast<int>(numLeaves)) {
+            error = "split references out of range";
+            return false;
+        }
+
+        Node node;
+        node.threshold = threshold[i];
+        node.feature = splitFeature[i];
+        node.child[0] = leftChild[i];
+        node.child[1] = rightChild[i];
+        node.missingType = static_cast<uint8_t>((decisionType[i] >> 2) & 3);
+        node.defaultLeft = (decisionType[i] & DEFAULT_LEFT_MASK) ? 1 : 0;
+        node.padding[0] = node.padding[1] = 0;
+        m_nodes.push_back(node);
+
+        if (static_cast<int>(m_featureThresholds.size()) <= node.feature) {
+            m_featureThresholds.resize(node.feature + 1);
+        }
+        m_featureThresholds[node.feature].push_back(node.threshold);
+        m_featureCount = std::max(m_featureCount, node.feature + 1);
+    }
+    return true;
+}
+
+void TreeEnsemble::Predict(const float* rows, size_t count, size_t stride, double* scores) const
+{
+    std::fill(scores, scores + count, 0.0);
+
+    // Tree-major: same per-row summation order as LightGBM (tree 0 first)
+    for (size_t t = 0; t < m_treeRoots.size(); ++t) {
+        const double* leaves = &m_leaves[m_treeLeafBegin[t]];
+        if (m_treeSingleLeaf[t]) {
+            for (size_t r = 0; r < count; ++r) {
+                scores[r] += leaves[0];
+            }
+            continue;
+        }
+
+        const Node* nodes = &m_nodes[m_treeRoots[t]];
+        for (size_t r = 0; r < count; ++r) {
+            const float* row = rows + r * stride;
+            int32_t index = 0;
+            while (index >= 0) {
+                const Node& node = nodes[index];
+                double value = row[node.feature];
+
+                // NumericalDecision() of LightGBM, after its dense row conversion
+                const bool isNan = std::isnan(value);
+                if (isNan ? node.missingType != MISSING_NAN : std::fabs(value) <= ZERO_THRESHOLD) {
+                    value = 0.0;
+                }
+                const bool useDefault = (node.missingType == MISSING_ZERO && value == 0.0) ||
+                                        (node.missingType == MISSING_NAN && isNan);
+                const int right = useDefault ? !node.defaultLeft : !(value <= node.threshold);
+                index = node.child[right];
+            }
+            scores[r] += leaves[~index];
+        }
+    }
+
+    if (m_sigmoid > 0.0) {
+        for (size_t r = 0; r < count; ++r) {
+            scores[r] = 1.0f / (1.0f + std::exp(-m_sigmoid * scores[r]));
+        }
+    }
+}
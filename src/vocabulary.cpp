@@ -0,0 +1,305 @@
+#include "vocabulary.h"
+#include "ranking_features.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+const char VOCAB_MAGIC[8] = {'H', 'E', 'Y', 'V', 'O', 'C', 'A', 'B'};
+const uint32_t VOCAB_VERSION = 1;
+const uint32_t VOCAB_FLAG_LM_INDEX = 1u << 0;
+
+// Words checked against the model before trusting stored LM indices
+const size_t LM_INDEX_SAMPLES = 64;
+
+struct VocabFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t keyCount;
+    uint32_t wordCount;
+    uint32_t pointCount;
+    uint32_t reserved;
+    uint64_t stringPoolSize;
+    uint64_t layoutHash;  // keyboard_layout_hash() when the paths were written
+};
+
+// FNV-1a over the keyboard coordinate table, paths depend on nothing else
+uint64_t keyboard_layout_hash() {
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    for (const auto& entry : keyboard_coord) {
+        mix(&entry.first, sizeof(entry.first));
+        mix(&entry.second.first, sizeof(float));
+        mix(&entry.second.second, sizeof(float));
+    }
+    return hash;
+}
+
+template <typename T>
+void append_array(std::vector<char>& out, const std::vector<T>& values) {
+    const char* bytes = reinterpret_cast<const char*>(values.data());
+    out.insert(out.end(), bytes, bytes + values.size() * sizeof(T));
+}
+
+void append_path(std::vector<float>& points, const std::string& word) {
+    for (const auto& point : get_word_path(word)) {
+        points.push_back(point.first);
+        points.push_back(point.second);
+    }
+}
+
+} // namespace
+
+Vocabulary::Vocabulary()
+    : m_keyCount(0)
+    , m_wordCount(0)
+    , m_keyWordBegin(nullptr)
+    , m_keyPathBegin(nullptr)
+    , m_wordStringBegin(nullptr)
+    , m_wordLmIndex(nullptr)
+    , m_points(nullptr)
+    , m_strings(nullptr)
+{
+}
+
+void Vocabulary::Clear()
+{
+    m_file.Close();
+    m_ownedData.clear();
+    m_ownedKeyPathBegin.clear();
+    m_ownedPoints.clear();
+    m_ownedLmIndex.clear();
+    m_wordCanonical.clear();
+
+    m_keyCount = 0;
+    m_wordCount = 0;
+    m_keyWordBegin = nullptr;
+    m_keyPathBegin = nullptr;
+    m_wordStringBegin = nullptr;
+    m_wordLmIndex = nullptr;
+    m_points = nullptr;
+    m_strings = nullptr;
+}
+
+bool Vocabulary::Open(const std::string& filepath)
+{
+    Clear();
+
+    if (!m_file.Open(filepath)) {
+        std::cerr << "Failed to map vocabulary: " << filepath << std::endl;
+        return false;
+    }
+
+    if (!Attach(m_file.GetData(), m_file.GetSize())) {
+        std::cerr << "Invalid vocabulary file: " << filepath << std::endl;
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+bool Vocabulary::Build(const std::map<int, std::vector<std::string>>& entries)
+{
+    Clear();
+
+    m_ownedData = Serialize(entries, nullptr);
+    if (!Attach(m_ownedData.data(), m_ownedData.size())) {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+bool Vocabulary::Write(const std::string& filepath,
+                       const std::map<int, std::vector<std::string>>& entries,
+                       const LmIndexFunction& lmIndex)
+{
+    std::vector<char> data = Serialize(entries, lmIndex);
+
+    std::ofstream ofs(filepath, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+        std::cerr << "Failed to create file: " << filepath << std::endl;
+        return false;
+    }
+    ofs.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(ofs);
+}
+
+std::vector<char> Vocabulary::Serialize(const std::map<int, std::vector<std::string>>& entries,
+                                        const LmIndexFunction& lmIndex)
+{
+    // FAISS ids are dense from 0, missing ones get an empty range
+    uint32_t keyCount = 0;
+    if (!entries.empty() && entries.rbegin()->first >= 0) {
+        keyCount = static_cast<uint32_t>(entries.rbegin()->first) + 1;
+    }
+
+    std::vector<uint32_t> keyWordBegin(keyCount + 1, 0);
+    std::vector<uint32_t> keyPathBegin(keyCount + 1, 0);
+    std::vector<uint32_t> wordStringBegin(1, 0);
+    std::vector<uint32_t> wordLmIndex;
+    std::vector<float> points;
+    std::string strings;
+
+    auto entry = entries.lower_bound(0);
+    for (uint32_t key = 0; key < keyCount; ++key) {
+        keyWordBegin[key] = static_cast<uint32_t>(wordStringBegin.size() - 1);
+        keyPathBegin[key] = static_cast<uint32_t>(points.size() / 2);
+
+        if (entry != entries.end() && entry->first == static_cast<int>(key)) {
+            const std::vector<std::string>& words = entry->second;
+            for (const std::string& word : words) {
+                strings += word;
+                wordStringBegin.push_back(static_cast<uint32_t>(strings.size()));
+                if (lmIndex) {
+                    wordLmIndex.push_back(lmIndex(word));
+                }
+            }
+            if (!words.empty()) {
+                append_path(points, words[0]);  // First word is the canonical form
+            }
+            ++entry;
+        }
+    }
+    keyWordBegin[keyCount] = static_cast<uint32_t>(wordStringBegin.size() - 1);
+    keyPathBegin[keyCount] = static_cast<uint32_t>(points.size() / 2);
+
+    VocabFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, VOCAB_MAGIC, sizeof(header.magic));
+    header.version = VOCAB_VERSION;
+    header.flags = lmIndex ? VOCAB_FLAG_LM_INDEX : 0;
+    header.keyCount = keyCount;
+    header.wordCount = static_cast<uint32_t>(wordStringBegin.size() - 1);
+    header.pointCount = static_cast<uint32_t>(points.size() / 2);
+    header.stringPoolSize = strings.size();
+    header.layoutHash = keyboard_layout_hash();
+
+    std::vector<char> out(reinterpret_cast<const char*>(&header),
+                          reinterpret_cast<const char*>(&header) + sizeof(header));
+    append_array(out, keyWordBegin);
+    append_array(out, keyPathBegin);
+    append_array(out, wordStringBegin);
+    append_array(out, wordLmIndex);
+    append_array(out, points);
+    out.insert(out.end(), strings.begin(), strings.end());
+    return out;
+}
+
+bool Vocabulary::Attach(const char* data, size_t size)
+{
+    if (size < sizeof(VocabFileHeader)) {
+        return false;
+    }
+
+    VocabFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, VOCAB_MAGIC, sizeof(header.magic)) != 0 || header.version != VOCAB_VERSION) {
+        return false;
+    }
+
+    const bool hasLmIndex = (header.flags & VOCAB_FLAG_LM_INDEX) != 0;
+    const uint64_t expected = sizeof(VocabFileHeader)
+        + 2 * (uint64_t(header.keyCount) + 1) * sizeof(uint32_t)
+        + (uint64_t(header.wordCount) + 1) * sizeof(uint32_t)
+        + (hasLmIndex ? uint64_t(header.wordCount) * sizeof(uint32_t) : 0)
+        + uint64_t(header.pointCount) * 2 * sizeof(float)
+        + header.stringPoolSize;
+    if (expected != size) {
+        return false;
+    }
+
+    const char* cursor = data + sizeof(VocabFileHeader);
+    m_keyCount = header.keyCount;
+    m_wordCount = header.wordCount;
+    m_keyWordBegin = reinterpret_cast<const uint32_t*>(cursor);
+    cursor += (m_keyCount + 1) * sizeof(uint32_t);
+    m_keyPathBegin = reinterpret_cast<const uint32_t*>(cursor);
+    cursor += (m_keyCount + 1) * sizeof(uint32_t);
+    m_wordStringBegin = reinterpret_cast<const uint32_t*>(cursor);
+    cursor += (m_wordCount + 1) * sizeof(uint32_t);
+    m_wordLmIndex = hasLmIndex ? reinterpret_cast<const uint32_t*>(cursor) : nullptr;
+    cursor += hasLmIndex ? m_wordCount * sizeof(uint32_t) : 0;
+    m_points = reinterpret_cast<const float*>(cursor);
+    cursor += size_t(header.pointCount) * 2 * sizeof(float);
+    m_strings = cursor;
+
+    // The ranges are trusted from here on, check that they close correctly
+    if (m_keyWordBegin[m_keyCount] != m_wordCount || m_keyPathBegin[m_keyCount] != header.pointCount ||
+        m_wordStringBegin[m_wordCount] != header.stringPoolSize) {
+        return false;
+    }
+
+    if (header.layoutHash != keyboard_layout_hash()) {
+        std::cerr << "Vocabulary: keyboard layout changed, recomputing word paths" << std::endl;
+        RebuildPaths();
+    }
+
+    BuildCanonicalWords();
+    return true;
+}
+
+void Vocabulary::BuildCanonicalWords()
+{
+    std::unordered_map<std::string_view, uint32_t> firstOccurrence;
+    firstOccurrence.reserve(m_wordCount);
+
+    m_wordCanonical.resize(m_wordCount);
+    for (uint32_t wordId = 0; wordId < m_wordCount; ++wordId) {
+        // Views point into the string pool, which outlives the map
+        m_wordCanonical[wordId] = firstOccurrence.emplace(GetWord(wordId), wordId).first->second;
+    }
+}
+
+void Vocabulary::RebuildPaths()
+{
+    m_ownedKeyPathBegin.assign(m_keyCount + 1, 0);
+    m_ownedPoints.clear();
+
+    for (size_t key = 0; key < m_keyCount; ++key) {
+        m_ownedKeyPathBegin[key] = static_cast<uint32_t>(m_ownedPoints.size() / 2);
+        if (m_keyWordBegin[key] != m_keyWordBegin[key + 1]) {
+            append_path(m_ownedPoints, std::string(GetWord(m_keyWordBegin[key])));
+        }
+    }
+    m_ownedKeyPathBegin[m_keyCount] = static_cast<uint32_t>(m_ownedPoints.size() / 2);
+
+    m_keyPathBegin = m_ownedKeyPathBegin.data();
+    m_points = m_ownedPoints.data();
+}
+
+bool Vocabulary::BindLanguageModel(const LmIndexFunction& lmIndex)
+{
+    if (!IsLoaded() || !lmIndex) {
+        return false;
+    }
+
+    if (m_wordLmIndex) {
+        // Indices depend on the exact model build, spot check evenly spaced words
+        bool matches = true;
+        const size_t step = std::max<size_t>(1, m_wordCount / LM_INDEX_SAMPLES);
+        for (size_t wordId = 0; wordId < m_wordCount && matches; wordId += step) {
+            matches = (lmIndex(std::string(GetWord(static_cast<uint32_t>(wordId)))) == m_wordLmIndex[wordId]);
+        }
+        if (matches) {
+            return true;
+        }
+        std::cerr << "Vocabulary: LM indices do not match the language model, recomputing" << std::endl;
+    }
+
+    m_ownedLmIndex.resize(m_wordCount);
+    for (size_t wordId = 0; wordId < m_wordCount; ++wordId) {
+        m_ownedLmIndex[wordId] = lmIndex(std::string(GetWord(static_cast<uint32_t>(wordId))));
+    }
+    m_wordLmIndex = m_ownedLmIndex.data();
+    return false;
+}
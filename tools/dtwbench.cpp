@@ -0,0 +1,301 @@
+// Micro-benchmark of DtwEngine against the reference dtw_multivariate().
+//
+// Usage: HeyEyeDtwBench [swipes] [candidates per swipe] [prune top k] [threads]
+//
+// Checks that the unbounded engine distance is bit-identical to the
+// reference, that banded distances match a full-matrix banded DP, and that
+// the lower bounds never exceed the distance. Also times the whole candidate
+// stage (compute_all_features) serially and on a thread pool and checks both
+// give the same features, and that the final features of a swipe computed
+// on top of partial predictions (DtwPrefixCache) are the same too. Exits with
+// 1 on a mismatch.
+
+#include "dtwengine.h"
+#include "dtwprefixcache.h"
+#include "ranking_features.h"
+#include "threadpool.h"
+#include "vocabulary.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::vector<std::pair<float, float>> Path;
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static std::vector<float> interleave(const Path& path) {
+    std::vector<float> points;
+    for (const auto& point : path) {
+        points.push_back(point.first);
+        points.push_back(point.second);
+    }
+    return points;
+}
+
+// Full-matrix banded DTW, the textbook definition the band mode must match
+static float reference_banded(const Path& a, const Path& b, int window) {
+    const int n = a.size(), m = b.size();
+    const int band = std::max(window, std::abs(n - m));
+    std::vector<float> cost((n + 1) * (m + 1), DtwEngine::INF);
+    cost[0] = 0.0f;
+    for (int i = 1; i <= n; ++i) {
+        for (int j = std::max(1, i - band); j <= std::min(m, i + band); ++j) {
+            float dx = a[i-1].first - b[j-1].first;
+            float dy = a[i-1].second - b[j-1].second;
+            float best = std::min(std::min(cost[(i-1)*(m+1) + j], cost[i*(m+1) + j-1]), cost[(i-1)*(m+1) + j-1]);
+            cost[i*(m+1) + j] = std::sqrt(dx*dx + dy*dy) + best;
+        }
+    }
+    return cost[n*(m+1) + m];
+}
+
+// Noisy walk through the keys of a word, like a gaze swipe sampled at 120 Hz
+static Path make_swipe(const Path& word, std::mt19937& rng) {
+    std::normal_distribution<float> noise(0.0f, 4.0f);
+    std::uniform_int_distribution<int> samplesPerKey(6, 30);
+    Path swipe;
+    for (size_t k = 0; k + 1 < word.size(); ++k) {
+        int samples = samplesPerKey(rng);
+        for (int s = 0; s < samples; ++s) {
+            float t = static_cast<float>(s) / samples;
+            swipe.push_back({word[k].first + t * (word[k+1].first - word[k].first) + noise(rng),
+                             word[k].second + t * (word[k+1].second - word[k].second) + noise(rng)});
+        }
+    }
+    swipe.push_back(word.back());
+    return swipe;
+}
+
+static std::string random_word(std::mt19937& rng) {
+    static const char letters[] = "azertyuiopqsdfghjklmwxcvbn";
+    std::uniform_int_distribution<int> length(2, 12);
+    std::uniform_int_distribution<int> letter(0, 25);
+    std::string word(length(rng), 'a');
+    for (char& c : word) {
+        c = letters[letter(rng)];
+    }
+    return word;
+}
+
+static bool same_features(const std::vector<CandidateFeatures>& a, const std::vector<CandidateFeatures>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].word != b[i].word || a[i].dtw_rank != b[i].dtw_rank ||
+            std::memcmp(&a[i].dtw_distance, &b[i].dtw_distance, sizeof(float)) != 0 ||
+            std::memcmp(&a[i].dtw_zscore, &b[i].dtw_zscore, sizeof(float)) != 0 ||
+            std::memcmp(&a[i].lm_percentile, &b[i].lm_percentile, sizeof(float)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const int swipes = argc > 1 ? std::atoi(argv[1]) : 200;
+    const int candidatesPerSwipe = argc > 2 ? std::atoi(argv[2]) : 300;
+    const size_t pruneTopK = argc > 3 ? std::atoi(argv[3]) : 20;
+    const size_t threads = argc > 4 ? std::atoi(argv[4]) : 0;  // 0 = one per core
+
+    init_keyboard_coords();
+    std::mt19937 rng(1234);
+
+    std::vector<Path> queries;
+    std::vector<std::vector<Path>> candidates(swipes);
+    for (int s = 0; s < swipes; ++s) {
+        queries.push_back(make_swipe(get_word_path(random_word(rng)), rng));
+        for (int c = 0; c < candidatesPerSwipe; ++c) {
+            candidates[s].push_back(get_word_path(random_word(rng)));
+        }
+    }
+    std::vector<std::vector<std::vector<float>>> packed(swipes);
+    for (int s = 0; s < swipes; ++s) {
+        for (const Path& candidate : candidates[s]) {
+            packed[s].push_back(interleave(candidate));
+        }
+    }
+
+    std::printf("DTW kernel: %s, %d swipes x %d candidates\n", DtwEngine::GetKernelName(), swipes, candidatesPerSwipe);
+
+    // Reference
+    std::vector<float> reference;
+    Clock::time_point start = Clock::now();
+    for (int s = 0; s < swipes; ++s) {
+        for (const Path& candidate : candidates[s]) {
+            reference.push_back(dtw_multivariate(queries[s], candidate));
+        }
+    }
+    double referenceMs = elapsed_ms(start);
+
+    // Engine, unbounded: must be bit-identical
+    DtwEngine engine;
+    std::vector<float> results;
+    start = Clock::now();
+    for (int s = 0; s < swipes; ++s) {
+        engine.SetQuery(queries[s]);
+        for (const std::vector<float>& candidate : packed[s]) {
+            results.push_back(engine.Distance(candidate.data(), static_cast<int>(candidate.size() / 2)));
+        }
+    }
+    double engineMs = elapsed_ms(start);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (std::memcmp(&results[i], &reference[i], sizeof(float)) != 0) {
+            mismatches++;
+        }
+    }
+    std::printf("reference  %8.2f ms\n", referenceMs);
+    std::printf("engine     %8.2f ms  (x%.2f)  bit mismatches: %zu\n", engineMs, referenceMs / engineMs, mismatches);
+
+    // Lower bounds must never exceed the distance
+    size_t boundViolations = 0;
+    size_t index = 0;
+    for (int s = 0; s < swipes; ++s) {
+        engine.SetQuery(queries[s]);
+        for (const std::vector<float>& candidate : packed[s]) {
+            int m = static_cast<int>(candidate.size() / 2);
+            float distance = results[index++];
+            if (engine.LowerBoundKim(candidate.data(), m) > distance ||
+                engine.LowerBoundKeogh(candidate.data(), m) > distance) {
+                boundViolations++;
+            }
+        }
+    }
+    std::printf("lower bound violations: %zu\n", boundViolations);
+
+    // Banded mode against the full-matrix banded definition
+    const int window = 20;
+    size_t bandMismatches = 0;
+    start = Clock::now();
+    for (int s = 0; s < swipes; ++s) {
+        engine.SetQuery(queries[s], window);
+        for (size_t c = 0; c < packed[s].size(); ++c) {
+            float distance = engine.Distance(packed[s][c].data(), static_cast<int>(packed[s][c].size() / 2));
+            float expected = reference_banded(queries[s], candidates[s][c], window);
+            if (std::memcmp(&distance, &expected, sizeof(float)) != 0) {
+                bandMismatches++;
+            }
+        }
+    }
+    std::printf("band %-3d   %8.2f ms  (incl. reference)  mismatches: %zu\n", window, elapsed_ms(start), bandMismatches);
+
+    // Top-k search with lower bounds and early abandoning
+    engine.ResetStats();
+    size_t topKMismatches = 0;
+    start = Clock::now();
+    for (int s = 0; s < swipes; ++s) {
+        engine.SetQuery(queries[s]);
+        std::priority_queue<float> best;
+        for (const std::vector<float>& candidate : packed[s]) {
+            int m = static_cast<int>(candidate.size() / 2);
+            float threshold = best.size() >= pruneTopK ? best.top() : DtwEngine::INF;
+            float distance = engine.DistanceIfBelow(candidate.data(), m, threshold);
+            if (distance < DtwEngine::INF) {
+                best.push(distance);
+                if (best.size() > pruneTopK) {
+                    best.pop();
+                }
+            }
+        }
+
+        // Same k-th best as the exhaustive search
+        std::vector<float> exhaustive(reference.begin() + s * candidatesPerSwipe,
+                                      reference.begin() + (s + 1) * candidatesPerSwipe);
+        std::sort(exhaustive.begin(), exhaustive.end());
+        if (!best.empty() && best.top() != exhaustive[std::min(pruneTopK, exhaustive.size()) - 1]) {
+            topKMismatches++;
+        }
+    }
+    double pruneMs = elapsed_ms(start);
+    const DtwEngine::Stats& stats = engine.GetStats();
+    std::printf("top-%-3zu    %8.2f ms  (x%.2f)  computed %zu, LB_Kim %zu, LB_Keogh %zu, abandoned %zu, mismatches: %zu\n",
+                pruneTopK, pruneMs, referenceMs / pruneMs, stats.computed, stats.prunedKim, stats.prunedKeogh,
+                stats.abandoned, topKMismatches);
+
+    // Candidate stage: every candidate is its own vocabulary key
+    std::map<int, std::vector<std::string>> entries;
+    std::vector<std::map<faiss::idx_t, float>> faissResults(swipes);
+    std::uniform_real_distribution<float> score(2.0f, 12.0f);
+    for (int s = 0; s < swipes; ++s) {
+        for (int c = 0; c < candidatesPerSwipe; ++c) {
+            int key = static_cast<int>(entries.size());
+            entries[key] = {random_word(rng)};
+            faissResults[s][key] = score(rng);
+        }
+    }
+    Vocabulary vocab;
+    vocab.Build(entries);
+
+    std::vector<std::vector<CandidateRef>> stageCandidates(swipes);
+    std::vector<std::vector<float>> stageLm(swipes);
+    for (int s = 0; s < swipes; ++s) {
+        stageCandidates[s] = collect_candidates(faissResults[s], vocab);
+        for (size_t c = 0; c < stageCandidates[s].size(); ++c) {
+            stageLm[s].push_back(-score(rng));
+        }
+    }
+
+    size_t stageMismatches = 0;
+    for (int prune = 0; prune <= 1; ++prune) {
+        DtwOptions options;
+        options.prune_top_k = prune ? static_cast<int>(pruneTopK) : 0;
+
+        std::vector<std::vector<CandidateFeatures>> serial(swipes);
+        start = Clock::now();
+        for (int s = 0; s < swipes; ++s) {
+            serial[s] = compute_all_features(queries[s], vocab, stageCandidates[s], stageLm[s], options);
+        }
+        double serialMs = elapsed_ms(start);
+
+        ThreadPool pool(threads);
+        start = Clock::now();
+        for (int s = 0; s < swipes; ++s) {
+            if (!same_features(serial[s], compute_all_features(queries[s], vocab, stageCandidates[s],
+                                                               stageLm[s], options, &pool))) {
+                stageMismatches++;
+            }
+        }
+        double poolMs = elapsed_ms(start);
+        std::printf("features %-7s serial %8.2f ms, %zu threads %8.2f ms  (x%.2f)  mismatches: %zu\n",
+                    prune ? "top-k" : "exact", serialMs, pool.GetThreadCount(), poolMs, serialMs / poolMs,
+                    stageMismatches);
+
+        // Partial predictions every 24 points during the gesture, then the
+        // final one, which only runs the rows of the last points
+        const size_t partialInterval = 24;
+        double finalMs = 0.0;
+        size_t prefixMismatches = 0;
+        for (int s = 0; s < swipes; ++s) {
+            DtwPrefixCache cache;
+            for (size_t points = partialInterval; points < queries[s].size(); points += partialInterval) {
+                Path prefix(queries[s].begin(), queries[s].begin() + points);
+                compute_all_features(prefix, vocab, stageCandidates[s], stageLm[s], options, nullptr, &cache);
+            }
+            start = Clock::now();
+            std::vector<CandidateFeatures> finalFeatures = compute_all_features(queries[s], vocab, stageCandidates[s],
+                                                                        stageLm[s], options, nullptr, &cache);
+            finalMs += elapsed_ms(start);
+            if (!same_features(serial[s], finalFeatures)) {
+                prefixMismatches++;
+            }
+        }
+        std::printf("features %-7s after partials  %8.2f ms  (x%.2f)  mismatches: %zu\n",
+                    prune ? "top-k" : "exact", finalMs, serialMs / finalMs, prefixMismatches);
+        stageMismatches += prefixMismatches;
+    }
+
+    return (mismatches || boundViolations || bandMismatches || topKMismatches || stageMismatches) ? 1 : 0;
+}
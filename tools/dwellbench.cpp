@@ -0,0 +1,156 @@
+// Micro-benchmark of DwellDetector against the history vectors it replaced.
+//
+// Usage: HeyEyeDwellBench [seconds of gaze] [sample rate Hz] [wait ms]...
+//
+// Synthesizes a gaze stream (jittered fixations of 0.2 to 6 s joined by
+// saccades) at the given rate, 250 Hz by default, and feeds it to both the
+// former EyeOverlay::UpdateDwellDetection algorithm (vectors trimmed with
+// erase(begin()) and a min/max rescan of the window per sample) and a
+// DwellDetector sized with CapacityFor, for each wait time (800 ms to 5 s by
+// default). Reports the time per sample of both and the speedup. Exits with
+// 1 if the two ever disagree on whether the window is stable.
+
+#include "dwelldetector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct GazePoint {
+    float x;
+    float y;
+    uint64_t timestamp;  // Microseconds
+};
+
+// Fixations with a few pixels of jitter, separated by 30-300 px saccades
+static std::vector<GazePoint> make_gaze(double seconds, double rateHz, std::mt19937& rng) {
+    std::normal_distribution<float> jitter(0.0f, 3.0f);
+    std::uniform_real_distribution<double> fixationSeconds(0.2, 6.0);
+    std::uniform_real_distribution<float> saccade(-300.0f, 300.0f);
+
+    const size_t count = static_cast<size_t>(seconds * rateHz);
+    std::vector<GazePoint> gaze;
+    gaze.reserve(count);
+    float centerX = 960.0f, centerY = 540.0f;
+    size_t fixationEnd = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i >= fixationEnd) {
+            fixationEnd = i + static_cast<size_t>(fixationSeconds(rng) * rateHz);
+            centerX = std::min(1900.0f, std::max(20.0f, centerX + saccade(rng)));
+            centerY = std::min(1060.0f, std::max(20.0f, centerY + saccade(rng)));
+        }
+        GazePoint point;
+        point.x = centerX + jitter(rng);
+        point.y = centerY + jitter(rng);
+        point.timestamp = static_cast<uint64_t>(i * 1e6 / rateHz);
+        gaze.push_back(point);
+    }
+    return gaze;
+}
+
+// The history vectors of EyeOverlay before DwellDetector, kept as reference
+class LegacyDwell
+{
+public:
+    LegacyDwell(uint64_t windowUs, float radius) : m_windowUs(windowUs), m_radius(radius) {}
+
+    bool AddSample(float x, float y, uint64_t timestamp) {
+        m_positions.push_back(std::make_pair(x, y));
+        m_timestamps.push_back(timestamp);
+        while (!m_timestamps.empty() && (timestamp - m_timestamps.front()) >= m_windowUs) {
+            m_positions.erase(m_positions.begin());
+            m_timestamps.erase(m_timestamps.begin());
+        }
+
+        float minX = 1e15f, maxX = 0.0f, minY = 1e15f, maxY = 0.0f;
+        for (const auto& point : m_positions) {
+            if (point.first < minX) minX = point.first;
+            if (point.first > maxX) maxX = point.first;
+            if (point.second < minY) minY = point.second;
+            if (point.second > maxY) maxY = point.second;
+        }
+        return (maxX - minX) < m_radius && (maxY - minY) < m_radius && m_timestamps.size() > 2;
+    }
+
+private:
+    std::vector<std::pair<float, float>> m_positions;
+    std::vector<uint64_t> m_timestamps;
+    uint64_t m_windowUs;
+    float m_radius;
+};
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 120.0;
+    const double rateHz = argc > 2 ? std::atof(argv[2]) : 250.0;
+    std::vector<int> waitTimes;
+    for (int i = 3; i < argc; ++i) {
+        waitTimes.push_back(std::atoi(argv[i]));
+    }
+    if (waitTimes.empty()) {
+        waitTimes = {800, 1500, 3000, 5000};
+    }
+    if (seconds <= 0.0 || rateHz <= 0.0) {
+        std::fprintf(stderr, "usage: HeyEyeDwellBench [seconds] [rate Hz] [wait ms]...\n");
+        return 2;
+    }
+
+    std::mt19937 rng(1234);
+    const std::vector<GazePoint> gaze = make_gaze(seconds, rateHz, rng);
+    const float radius = 30.0f;
+
+    std::printf("%zu gaze samples at %.0f Hz, times in us per sample\n", gaze.size(), rateHz);
+    std::printf("  %8s  %8s  %8s  %12s  %12s  %8s\n", "wait ms", "window", "capacity",
+                "legacy us", "detector us", "speedup");
+
+    size_t mismatches = 0;
+    for (int waitMs : waitTimes) {
+        const uint64_t windowUs = static_cast<uint64_t>(waitMs) * 1000;
+
+        LegacyDwell legacy(windowUs, radius);
+        std::vector<char> expected(gaze.size());
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < gaze.size(); ++i) {
+            expected[i] = legacy.AddSample(gaze[i].x, gaze[i].y, gaze[i].timestamp);
+        }
+        const double legacyMs = elapsed_ms(start);
+
+        DwellDetector detector(DwellDetector::CapacityFor(windowUs, static_cast<float>(rateHz)));
+        detector.SetWindow(windowUs);
+        detector.SetRadius(radius);
+        std::vector<char> stable(gaze.size());
+        start = Clock::now();
+        for (size_t i = 0; i < gaze.size(); ++i) {
+            detector.AddSample(gaze[i].x, gaze[i].y, gaze[i].timestamp);
+            stable[i] = detector.IsStable();
+        }
+        const double detectorMs = elapsed_ms(start);
+
+        size_t differ = 0;
+        for (size_t i = 0; i < gaze.size(); ++i) {
+            differ += expected[i] != stable[i];
+        }
+        mismatches += differ;
+
+        const double perSample = 1000.0 / gaze.size();
+        std::printf("  %8d  %8zu  %8zu  %12.4f  %12.4f  %7.1fx%s\n", waitMs,
+                    static_cast<size_t>(windowUs / 1e6 * rateHz), detector.GetCapacity(),
+                    legacyMs * perSample, detectorMs * perSample,
+                    detectorMs > 0.0 ? legacyMs / detectorMs : 0.0,
+                    differ ? "  MISMATCH" : "");
+    }
+
+    if (mismatches) {
+        std::printf("%zu answers differ from the legacy detector\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Recall / latency benchmark of approximate FAISS indexes against the exact
+// flat index the vocabulary search was built with.
+//
+// Usage: HeyEyeFaissBench <flat index> <index file | factory string> [queries] [k] [output]
+//
+// The second argument is either an index file (IVF, PQ, HNSW, SQ, ...) or a
+// faiss::index_factory description such as "IVF1024,Flat", "IVF1024,PQ32",
+// "IVF1024,SQ8" or "HNSW32,Flat"; a factory index is trained on and filled
+// with the vectors of the flat index, and written to [output] if given, ready
+// to be shipped as assets/index.faiss.
+//
+// Queries are vocabulary vectors with noise, searched one at a time like the
+// prediction does. Reports recall@k (fraction of the exact top k found) and
+// the latency for a sweep of nprobe (IVF) or efSearch (HNSW) values, plus the
+// serialized size of both indexes.
+
+#include "ml_helpers.h"
+#include <faiss/IndexFlat.h>
+#include <faiss/IndexHNSW.h>
+#include <faiss/IndexIVF.h>
+#include <faiss/impl/io.h>
+#include <faiss/index_factory.h>
+#include <faiss/index_io.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static size_t serialized_size(const faiss::Index* index) {
+    faiss::VectorIOWriter writer;
+    faiss::write_index(index, &writer);
+    return writer.data.size();
+}
+
+static bool file_exists(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return ifs.good();
+}
+
+// Mean recall@k and search time per query, queries searched one by one
+static void measure(faiss::Index* index, const std::vector<float>& queries, size_t queryCount, int k,
+                    const std::vector<faiss::idx_t>& truth, double& recall, double& msPerQuery) {
+    const size_t d = index->d;
+    std::vector<faiss::idx_t> labels(k);
+    std::vector<float> distances(k);
+    size_t found = 0;
+
+    Clock::time_point start = Clock::now();
+    for (size_t q = 0; q < queryCount; ++q) {
+        index->search(1, &queries[q * d], k, distances.data(), labels.data());
+        std::unordered_set<faiss::idx_t> exact(truth.begin() + q * k, truth.begin() + (q + 1) * k);
+        for (faiss::idx_t label : labels) {
+            found += (label >= 0 && exact.count(label)) ? 1 : 0;
+        }
+    }
+    msPerQuery = elapsed_ms(start) / queryCount;
+    recall = static_cast<double>(found) / (queryCount * k);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s <flat index> <index file | factory string> [queries] [k] [output]\n", argv[0]);
+        return 1;
+    }
+    const std::string flatPath = argv[1];
+    const std::string candidate = argv[2];
+    const size_t queryCount = argc > 3 ? std::atoi(argv[3]) : 1000;
+    const int k = argc > 4 ? std::atoi(argv[4]) : 100;
+    const std::string outputPath = argc > 5 ? argv[5] : "";
+
+    std::unique_ptr<faiss::Index> flat(load_faiss_index(flatPath));
+    if (!flat || !dynamic_cast<faiss::IndexFlat*>(flat.get())) {
+        std::fprintf(stderr, "%s is not a flat index\n", flatPath.c_str());
+        return 1;
+    }
+    const size_t d = flat->d;
+    const size_t n = flat->ntotal;
+    std::vector<float> vectors(n * d);
+    flat->reconstruct_n(0, n, vectors.data());
+
+    std::unique_ptr<faiss::Index> index;
+    if (file_exists(candidate)) {
+        index.reset(load_faiss_index(candidate));
+        if (!index || static_cast<size_t>(index->d) != d || static_cast<size_t>(index->ntotal) != n) {
+            std::fprintf(stderr, "%s does not index the same vectors\n", candidate.c_str());
+            return 1;
+        }
+    } else {
+        Clock::time_point start = Clock::now();
+        index.reset(faiss::index_factory(d, candidate.c_str(), flat->metric_type));
+        index->train(n, vectors.data());
+        index->add(n, vectors.data());
+        std::printf("built %s in %.0f ms\n", candidate.c_str(), elapsed_ms(start));
+        if (!outputPath.empty()) {
+            faiss::write_index(index.get(), outputPath.c_str());
+            std::printf("written to %s\n", outputPath.c_str());
+        }
+    }
+
+    std::printf("flat:      %s, %.1f MB\n", describe_faiss_index(flat.get()).c_str(), serialized_size(flat.get()) / 1048576.0);
+    std::printf("candidate: %s, %.1f MB\n", describe_faiss_index(index.get()).c_str(), serialized_size(index.get()) / 1048576.0);
+
+    // Vocabulary vectors with noise, renormalized for inner product indexes
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    std::normal_distribution<float> noise(0.0f, 0.3f / std::sqrt(static_cast<float>(d)));
+    std::vector<float> queries(queryCount * d);
+    for (size_t q = 0; q < queryCount; ++q) {
+        const float* source = &vectors[pick(rng) * d];
+        float* query = &queries[q * d];
+        float norm = 0.0f;
+        for (size_t i = 0; i < d; ++i) {
+            query[i] = source[i] + noise(rng);
+            norm += query[i] * query[i];
+        }
+        if (flat->metric_type == faiss::METRIC_INNER_PRODUCT && norm > 0.0f) {
+            for (size_t i = 0; i < d; ++i) {
+                query[i] /= std::sqrt(norm);
+            }
+        }
+    }
+
+    std::vector<faiss::idx_t> truth(queryCount * k);
+    std::vector<float> truthDistances(queryCount * k);
+    flat->search(queryCount, queries.data(), k, truthDistances.data(), truth.data());
+
+    double recall, msPerQuery;
+    measure(flat.get(), queries, queryCount, k, truth, recall, msPerQuery);
+    std::printf("%zu queries, recall@%d\n", queryCount, k);
+    std::printf("%8.3f ms/query  recall 1.0000  flat\n", msPerQuery);
+
+    // Sweep the search parameter of the index type
+    std::vector<int> sweep;
+    const faiss::IndexIVF* ivf = faiss::try_extract_index_ivf(index.get());
+    if (ivf) {
+        for (int nprobe = 1; nprobe <= static_cast<int>(ivf->nlist) && nprobe <= 256; nprobe *= 2) {
+            sweep.push_back(nprobe);
+        }
+    } else if (dynamic_cast<faiss::IndexHNSW*>(index.get())) {
+        for (int efSearch = 16; efSearch <= 512; efSearch *= 2) {
+            sweep.push_back(std::max(efSearch, k));
+        }
+        sweep.erase(std::unique(sweep.begin(), sweep.end()), sweep.end());
+    } else {
+        sweep.push_back(0);
+    }
+
+    for (int value : sweep) {
+        std::string applied = set_faiss_search_parameters(index.get(), ivf ? value : 0, ivf ? 0 : value);
+        measure(index.get(), queries, queryCount, k, truth, recall, msPerQuery);
+        std::printf("%8.3f ms/query  recall %.4f  %s\n", msPerQuery, recall, applied.empty() ? "exact" : applied.c_str());
+    }
+    return 0;
+}
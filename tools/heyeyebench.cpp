@@ -0,0 +1,506 @@
+// Deterministic replay of recorded sessions (/debug/record_session, see
+// SessionRecorder) through the prediction pipeline, without a tracker.
+//
+// Usage: HeyEyeBench <assets dir> <session.heyes> [more sessions] [--k N] [--wait ms] [--hold ms]
+//                    [--resample-step S] [--fixation-radius R] [--pack NAME]... [--verbose]
+//
+// Gaze samples are replayed with their recorded timestamps: while the
+// keyboard was shown they go to a hidden KeyboardView (same keyboard-local
+// mapping as EyeOverlay), otherwise through the DwellDetector/DwellProgress
+// steps of EyeOverlay::UpdateDwellDetection, with every DwellDetector
+// answer checked against a brute-force scan of the same window. The swipes the keyboard
+// detects are matched to the recorded ones by the gaze sample they completed
+// on, and checked against them. Every recorded swipe is
+// then predicted with its recorded text as context. With --resample-step or
+// --fixation-radius the keyboard captures with those SwipePathFilter
+// settings and the replayed paths are predicted instead of the recorded
+// ones, to compare capture settings on the same sessions; recorded swipes
+// the replay did not reproduce are counted and left out.
+//
+// Reports p50/p95/p99 latency per stage, swipes per second and top-1 /
+// top-k accuracy against the word the user committed. Run it on two builds or
+// two assets directories to compare them.
+//
+// Each --pack loads the engine again with that model pack (see ModelPack,
+// "default" = the FP32 files of the assets directory) and replays every
+// session through it; with more than one pack an accuracy-vs-latency table
+// of the packs closes the report.
+
+#include "dwelldetector.h"
+#include "keyboardview.h"
+#include "modelpack.h"
+#include "sessionrecorder.h"
+#include "textinputengine.h"
+#include <wx/wx.h>
+#include <wx/filename.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static double file_size_mb(const std::string& path) {
+    wxULongLong size = wxFileName::GetSize(wxString::FromUTF8(path.c_str()));
+    return size == wxInvalidSize ? 0.0 : size.ToDouble() / (1024.0 * 1024.0);
+}
+
+// Latency samples of one stage, in milliseconds
+struct StageStats {
+    const char* name;
+    std::vector<double> samples;
+
+    explicit StageStats(const char* stageName) : name(stageName) {}
+
+    double Percentile(double p) const {
+        if (samples.empty()) return 0.0;
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    void Clear() { samples.clear(); }
+
+    double Sum() const {
+        double sum = 0.0;
+        for (double sample : samples) sum += sample;
+        return sum;
+    }
+
+    void Print() const {
+        std::printf("  %-10s %8zu  %10.4f  %10.4f  %10.4f  %10.4f\n", name, samples.size(),
+                    Percentile(50.0), Percentile(95.0), Percentile(99.0),
+                    samples.empty() ? 0.0 : Sum() / samples.size());
+    }
+};
+
+struct BenchOptions {
+    wxString assetsPath;
+    std::vector<std::string> sessions;
+    int k;
+    int waitMs;
+    int holdMs;
+    bool verbose;
+    SwipePathFilterOptions swipeFilter;
+    bool predictReplayed;  // A filter option was given: predict the replayed paths
+    std::vector<std::string> packs;  // --pack, in order; none = the engine's default files
+
+    BenchOptions() : k(5), waitMs(800), holdMs(800), verbose(false), predictReplayed(false) {}
+};
+
+// DwellDetector::IsStable by scanning the whole window
+static bool brute_force_stable(const std::deque<const SessionData::Gaze*>& window, float radius) {
+    if (window.size() <= 2) {
+        return false;
+    }
+    float minX = window.front()->x, maxX = minX;
+    float minY = window.front()->y, maxY = minY;
+    for (const SessionData::Gaze* gaze : window) {
+        minX = std::min(minX, gaze->x);
+        maxX = std::max(maxX, gaze->x);
+        minY = std::min(minY, gaze->y);
+        maxY = std::max(maxY, gaze->y);
+    }
+    return (maxX - minX) < radius && (maxY - minY) < radius;
+}
+
+// One line of the model pack comparison
+struct PackResult {
+    ModelPack pack;
+    double encoderMb;
+    double indexMb;
+    double encodeP50, encodeP95;
+    double searchP50, searchP95;
+    double predictP50, predictP95;
+    size_t labeled;  // Swipes with a committed word
+    double top1;     // < 0 = no labeled swipes
+    double topK;
+};
+
+class BenchApp : public wxApp
+{
+public:
+    BenchApp()
+        : m_engine(nullptr)
+        , m_frame(nullptr)
+        , m_keyboardStats("keyboard")
+        , m_dwellStats("dwell")
+        , m_encodeStats("encode")
+        , m_searchStats("search")
+        , m_rankStats("rank")
+        , m_totalStats("predict")
+        , m_recordedSwipes(0)
+        , m_replayedSwipes(0)
+        , m_matchingSwipes(0)
+        , m_unmatchedSwipes(0)
+        , m_missedSwipes(0)
+        , m_dwellMismatches(0)
+        , m_predictedPoints(0)
+        , m_labeledSwipes(0)
+        , m_top1(0)
+        , m_topK(0)
+    {}
+
+    // Arguments are parsed in OnRun, wxApp's own parser would reject them
+    bool OnInit() override { return true; }
+    int OnRun() override;
+
+private:
+    bool ParseArguments(BenchOptions& options);
+    bool RunPack(const std::vector<SessionData>& sessions, const BenchOptions& options,
+                 const std::string& packName, PackResult& result);
+    void ResetStats();
+    void ReplayGaze(const SessionData& session, const BenchOptions& options);
+    void PredictSwipes(const SessionData& session, const BenchOptions& options);
+
+    TextInputEngine* m_engine;
+    wxFrame* m_frame;  // Hidden parent of the replay keyboards
+
+    StageStats m_keyboardStats;  // KeyboardView::UpdateGazePosition per sample
+    StageStats m_dwellStats;     // Dwell detection per sample
+    StageStats m_encodeStats;
+    StageStats m_searchStats;
+    StageStats m_rankStats;
+    StageStats m_totalStats;     // Whole PredictTopKFromSwipe call
+
+    // Current session, per recorded swipe: the path the keyboard completed on
+    // the same gaze sample, empty = none did
+    std::vector<std::vector<std::pair<float, float>>> m_replayedPaths;
+
+    size_t m_recordedSwipes;
+    size_t m_replayedSwipes;
+    size_t m_matchingSwipes;  // Keyboard found the recorded path point for point
+    size_t m_unmatchedSwipes; // Replayed swipes completed where no recorded one did
+    size_t m_missedSwipes;    // Recorded swipes without a replayed one (not predicted with the filter options)
+    size_t m_dwellMismatches; // DwellDetector::IsStable differing from the brute-force window scan
+    size_t m_predictedPoints; // Path points sent to the engine (encoder and DTW length)
+    size_t m_labeledSwipes;
+    size_t m_top1;
+    size_t m_topK;
+};
+
+wxIMPLEMENT_APP_CONSOLE(BenchApp);
+
+bool BenchApp::ParseArguments(BenchOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        wxString arg = argv[i];
+        if (arg == wxT("--k") && i + 1 < argc) {
+            options.k = wxAtoi(argv[++i]);
+        } else if (arg == wxT("--wait") && i + 1 < argc) {
+            options.waitMs = wxAtoi(argv[++i]);
+        } else if (arg == wxT("--hold") && i + 1 < argc) {
+            options.holdMs = wxAtoi(argv[++i]);
+        } else if (arg == wxT("--resample-step") && i + 1 < argc) {
+            options.swipeFilter.resampleStep = static_cast<float>(wxAtof(argv[++i]));
+            options.predictReplayed = true;
+        } else if (arg == wxT("--fixation-radius") && i + 1 < argc) {
+            options.swipeFilter.fixationRadius = static_cast<float>(wxAtof(argv[++i]));
+            options.predictReplayed = true;
+        } else if (arg == wxT("--pack") && i + 1 < argc) {
+            options.packs.push_back(std::string(wxString(argv[++i]).ToUTF8()));
+        } else if (arg == wxT("--verbose")) {
+            options.verbose = true;
+        } else if (options.assetsPath.IsEmpty()) {
+            options.assetsPath = arg;
+        } else {
+            options.sessions.push_back(std::string(arg.ToUTF8()));
+        }
+    }
+    return !options.assetsPath.IsEmpty() && !options.sessions.empty() && options.k > 0;
+}
+
+int BenchApp::OnRun()
+{
+    BenchOptions options;
+    if (!ParseArguments(options)) {
+        std::fprintf(stderr, "Usage: HeyEyeBench <assets dir> <session.heyes> [more sessions] "
+                             "[--k N] [--wait ms] [--hold ms] [--resample-step S] [--fixation-radius R] "
+                             "[--pack NAME]... [--verbose]\n");
+        return 1;
+    }
+
+    // Engine messages would be timed with the stages
+    wxLog::SetActiveTarget(new wxLogStderr());
+    wxLog::SetLogLevel(options.verbose ? wxLOG_Info : wxLOG_Warning);
+
+    // Sessions are loaded once and replayed through every pack
+    std::vector<SessionData> sessions;
+    for (const std::string& path : options.sessions) {
+        SessionData session;
+        std::string error;
+        if (!SessionRecorder::Load(path, session, error)) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+            continue;
+        }
+        std::printf("%s: %zu gaze samples, %zu swipes\n", path.c_str(), session.gaze.size(), session.swipes.size());
+        sessions.push_back(std::move(session));
+    }
+
+    std::vector<std::string> packs = options.packs;
+    if (packs.empty()) {
+        packs.push_back(std::string());
+    }
+
+    m_frame = new wxFrame(nullptr, wxID_ANY, wxT("HeyEyeBench"));
+
+    std::vector<PackResult> results;
+    for (const std::string& pack : packs) {
+        PackResult result;
+        if (!RunPack(sessions, options, pack == "default" ? std::string() : pack, result)) {
+            m_frame->Destroy();
+            return 1;
+        }
+        results.push_back(result);
+    }
+
+    // Accuracy is against the words the users committed, not against the
+    // predictions of the pack that recorded
+    if (results.size() > 1) {
+        std::printf("\naccuracy vs latency (ms, accuracy against %zu committed words)\n", results.front().labeled);
+        std::printf("  %-14s %-13s %-10s %7s %7s %8s %8s %8s %8s %8s %8s %7s %7s\n", "pack", "precision", "embeddings",
+                    "enc MB", "idx MB", "enc p50", "enc p95", "srch p50", "srch p95", "pred p50", "pred p95",
+                    "top-1", ("top-" + std::to_string(options.k)).c_str());
+        for (const PackResult& result : results) {
+            std::printf("  %-14s %-13s %-10s %7.1f %7.1f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f",
+                        result.pack.name.c_str(), result.pack.precision.c_str(), result.pack.embeddings.c_str(),
+                        result.encoderMb, result.indexMb, result.encodeP50, result.encodeP95,
+                        result.searchP50, result.searchP95, result.predictP50, result.predictP95);
+            if (result.top1 >= 0.0) {
+                std::printf(" %7.4f %7.4f\n", result.top1, result.topK);
+            } else {
+                std::printf(" %7s %7s\n", "-", "-");
+            }
+        }
+    }
+
+    m_frame->Destroy();
+    return 0;
+}
+
+void BenchApp::ResetStats()
+{
+    for (StageStats* stats : {&m_keyboardStats, &m_dwellStats, &m_encodeStats, &m_searchStats,
+                              &m_rankStats, &m_totalStats}) {
+        stats->Clear();
+    }
+    m_recordedSwipes = 0;
+    m_replayedSwipes = 0;
+    m_matchingSwipes = 0;
+    m_unmatchedSwipes = 0;
+    m_missedSwipes = 0;
+    m_dwellMismatches = 0;
+    m_predictedPoints = 0;
+    m_labeledSwipes = 0;
+    m_top1 = 0;
+    m_topK = 0;
+}
+
+bool BenchApp::RunPack(const std::vector<SessionData>& sessions, const BenchOptions& options,
+                       const std::string& packName, PackResult& result)
+{
+    ResetStats();
+
+    m_engine = new TextInputEngine();
+    TextInputEngineOptions engineOptions;
+    engineOptions.candidateCount = options.k;
+    engineOptions.modelPack = packName;
+    m_engine->SetOptions(engineOptions);
+
+    Clock::time_point start = Clock::now();
+    if (!m_engine->Initialize(options.assetsPath)) {
+        std::fprintf(stderr, "Cannot load the assets in %s (model pack %s)\n",
+                     static_cast<const char*>(options.assetsPath.ToUTF8()),
+                     packName.empty() ? "default" : packName.c_str());
+        delete m_engine;
+        m_engine = nullptr;
+        return false;
+    }
+
+    // A pack that failed to load falls back to the default files, report what actually ran
+    const ModelPack& pack = m_engine->GetModelPack();
+    if (!packName.empty() && pack.name != packName) {
+        std::fprintf(stderr, "Model pack %s not loaded, see the warnings above\n", packName.c_str());
+        delete m_engine;
+        m_engine = nullptr;
+        return false;
+    }
+    std::printf("\nmodel pack %s %s (%s encoder, %s index)\n", pack.name.c_str(), pack.version.c_str(),
+                pack.precision.c_str(), pack.embeddings.c_str());
+    std::printf("engine loaded in %.0f ms (encoder on %s)\n", elapsed_ms(start), m_engine->GetEncoderProvider());
+
+    for (const SessionData& session : sessions) {
+        ReplayGaze(session, options);
+        PredictSwipes(session, options);
+    }
+
+    std::printf("\nlatency (ms)      count         p50         p95         p99        mean\n");
+    for (const StageStats* stats : {&m_keyboardStats, &m_dwellStats, &m_encodeStats, &m_searchStats,
+                                    &m_rankStats, &m_totalStats}) {
+        stats->Print();
+    }
+
+    const double predictMs = m_totalStats.Sum();
+    std::printf("\nswipes: %zu recorded, %zu detected on replay (%zu identical, %zu at no recorded swipe), "
+                "%zu not replayed\n",
+                m_recordedSwipes, m_replayedSwipes, m_matchingSwipes, m_unmatchedSwipes, m_missedSwipes);
+    std::printf("dwell: %zu of %zu samples differ from the brute-force window\n",
+                m_dwellMismatches, m_dwellStats.samples.size());
+    std::printf("path length: %.1f points per predicted swipe\n",
+                m_totalStats.samples.empty() ? 0.0 : static_cast<double>(m_predictedPoints) / m_totalStats.samples.size());
+    std::printf("throughput: %.1f swipes/s\n", predictMs > 0.0 ? m_totalStats.samples.size() * 1000.0 / predictMs : 0.0);
+    if (m_labeledSwipes > 0) {
+        std::printf("accuracy: top-1 %.4f, top-%d %.4f (%zu labeled swipes)\n",
+                    static_cast<double>(m_top1) / m_labeledSwipes, options.k,
+                    static_cast<double>(m_topK) / m_labeledSwipes, m_labeledSwipes);
+    } else {
+        std::printf("accuracy: no labeled swipes\n");
+    }
+
+    result.pack = pack;
+    result.encoderMb = file_size_mb(pack.encoderPath);
+    result.indexMb = file_size_mb(pack.indexPath);
+    result.encodeP50 = m_encodeStats.Percentile(50.0);
+    result.encodeP95 = m_encodeStats.Percentile(95.0);
+    result.searchP50 = m_searchStats.Percentile(50.0);
+    result.searchP95 = m_searchStats.Percentile(95.0);
+    result.predictP50 = m_totalStats.Percentile(50.0);
+    result.predictP95 = m_totalStats.Percentile(95.0);
+    result.labeled = m_labeledSwipes;
+    result.top1 = m_labeledSwipes > 0 ? static_cast<double>(m_top1) / m_labeledSwipes : -1.0;
+    result.topK = m_labeledSwipes > 0 ? static_cast<double>(m_topK) / m_labeledSwipes : -1.0;
+
+    delete m_engine;
+    m_engine = nullptr;
+    return true;
+}
+
+void BenchApp::ReplayGaze(const SessionData& session, const BenchOptions& options)
+{
+    const SessionGeometry& geometry = session.geometry;
+
+    KeyboardView* keyboard = new KeyboardView(m_frame);
+    keyboard->SetSize(static_cast<int>(geometry.keyboardWidth), static_cast<int>(geometry.keyboardHeight));
+    keyboard->Show(false);
+    keyboard->SetSwipeFilterOptions(options.swipeFilter);
+
+    // Swipes the keyboard detects, paired with the recorded swipe that
+    // completed on the same gaze sample (Swipe::gazeIndex counts the samples
+    // recorded before it, the current one included)
+    size_t cursor = 0;
+    size_t nextSwipe = 0;
+    m_replayedPaths.assign(session.swipes.size(), std::vector<std::pair<float, float>>());
+    keyboard->OnSwipeCompleted = [&](const std::vector<std::pair<float, float>>& path) {
+        m_replayedSwipes++;
+        while (nextSwipe < session.swipes.size() && session.swipes[nextSwipe].gazeIndex < cursor + 1) {
+            nextSwipe++;
+        }
+        if (nextSwipe == session.swipes.size() || session.swipes[nextSwipe].gazeIndex != cursor + 1) {
+            m_unmatchedSwipes++;
+            return;
+        }
+        m_replayedPaths[nextSwipe] = path;
+        if (session.swipes[nextSwipe].path == path) {
+            m_matchingSwipes++;
+        }
+        nextSwipe++;
+    };
+
+    // Same control button row as EyeOverlay (not forwarded to the keyboard)
+    const int controlWidth = 3 * 150 + 2 * 20;
+    const float controlX = (geometry.overlayWidth - controlWidth) / 2.0f;
+    const float controlY = 50 + 80 + 30;
+
+    DwellDetector detector;
+    DwellProgress progress;
+    detector.SetWindow(static_cast<uint64_t>(options.waitMs) * 1000);
+    std::deque<const SessionData::Gaze*> window;  // Brute-force reference of the detector window
+
+    for (cursor = 0; cursor < session.gaze.size(); ++cursor) {
+        const SessionData::Gaze& gaze = session.gaze[cursor];
+        Clock::time_point start = Clock::now();
+        if (gaze.keyboardVisible) {
+            bool overControls = gaze.y >= controlY && gaze.y < controlY + 60 &&
+                                gaze.x >= controlX && gaze.x < controlX + controlWidth;
+            if (!overControls) {
+                keyboard->UpdateGazePosition(gaze.x - geometry.keyboardX, gaze.y - geometry.keyboardY, gaze.timestamp);
+            }
+            m_keyboardStats.samples.push_back(elapsed_ms(start));
+        } else {
+            detector.AddSample(gaze.x, gaze.y, gaze.timestamp);
+            if (detector.IsStable()) {
+                progress.Advance(static_cast<float>(detector.GetLastDelta()), options.holdMs * 1000.0f);
+                if (progress.IsComplete()) {
+                    progress.Reset();
+                }
+            } else {
+                progress.Reset();
+            }
+            m_dwellStats.samples.push_back(elapsed_ms(start));
+
+            window.push_back(&gaze);
+            while (!window.empty() && gaze.timestamp - window.front()->timestamp >= detector.GetWindow()) {
+                window.pop_front();
+            }
+            if (detector.IsStable() != brute_force_stable(window, detector.GetRadius())) {
+                m_dwellMismatches++;
+            }
+        }
+    }
+
+    keyboard->Destroy();
+}
+
+void BenchApp::PredictSwipes(const SessionData& session, const BenchOptions& options)
+{
+    for (size_t i = 0; i < session.swipes.size(); ++i) {
+        const SessionData::Swipe& swipe = session.swipes[i];
+        m_recordedSwipes++;
+        if (m_replayedPaths[i].empty()) {
+            m_missedSwipes++;
+            if (options.predictReplayed) {
+                continue;
+            }
+        }
+
+        // Recorded path, or the one captured again with the options under test
+        const std::vector<std::pair<float, float>>& path = options.predictReplayed ? m_replayedPaths[i] : swipe.path;
+
+        // Same language context as when the swipe was made
+        m_engine->Clear();
+        m_engine->AppendText(wxString::FromUTF8(swipe.context.c_str()));
+
+        m_predictedPoints += path.size();
+        PredictionTimings timings;
+        Clock::time_point start = Clock::now();
+        std::vector<wxString> words = m_engine->PredictTopKFromSwipe(path, options.k, &timings);
+        m_totalStats.samples.push_back(elapsed_ms(start));
+        m_encodeStats.samples.push_back(timings.encodeMs);
+        m_searchStats.samples.push_back(timings.searchMs);
+        m_rankStats.samples.push_back(timings.rankMs);
+
+        if (swipe.word.empty()) {
+            continue;
+        }
+        m_labeledSwipes++;
+        wxString expected = wxString::FromUTF8(swipe.word.c_str());
+        auto found = std::find(words.begin(), words.end(), expected);
+        if (found == words.begin() && !words.empty()) {
+            m_top1++;
+        }
+        if (found != words.end()) {
+            m_topK++;
+        }
+        if (options.verbose) {
+            std::printf("  %-20s -> %s\n", swipe.word.c_str(),
+                        words.empty() ? "(none)" : static_cast<const char*>(words[0].ToUTF8()));
+        }
+    }
+}
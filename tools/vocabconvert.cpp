@@ -0,0 +1,67 @@
+// Converts the msgpack vocabulary (vocab.msgpck) to the memory-mappable
+// vocab.bin format read by Vocabulary::Open().
+//
+// Usage: HeyEyeVocabConvert <vocab.msgpck> <vocab.bin> [kenlm model]
+//
+// With a KenLM model (ARPA or binary) the WordIndex of every word is stored
+// too. Use the same model file as the application, the indices are checked
+// at startup and recomputed when they do not match.
+
+#include "ml_helpers.h"
+#include "ranking_features.h"
+#include "vocabulary.h"
+#include <iostream>
+#include <memory>
+
+#ifdef USE_KENLM
+#include "lm/model.hh"
+#endif
+
+int main(int argc, char** argv) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <vocab.msgpck> <vocab.bin> [kenlm model]" << std::endl;
+        return 1;
+    }
+
+    // Word paths are precomputed from the keyboard table
+    init_keyboard_coords();
+
+    auto vocabPair = load_vocab(argv[1]);
+    std::unique_ptr<std::map<int, std::vector<std::string>>> entries(vocabPair.first);
+    std::unique_ptr<std::vector<std::string>> keys(vocabPair.second);
+    if (!entries) {
+        std::cerr << "Failed to read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    Vocabulary::LmIndexFunction lmIndex;
+#ifdef USE_KENLM
+    std::unique_ptr<lm::base::Model> model;
+    if (argc == 4) {
+        lm::ngram::Config config;
+        config.load_method = util::LAZY;
+        model.reset(lm::ngram::LoadVirtual(argv[3], config));
+        const lm::base::Model* lm = model.get();
+        lmIndex = [lm](const std::string& word) {
+            return static_cast<uint32_t>(lm->BaseVocabulary().Index(word));
+        };
+    }
+#else
+    if (argc == 4) {
+        std::cerr << "Built without KenLM, LM indices are not stored" << std::endl;
+    }
+#endif
+
+    if (!Vocabulary::Write(argv[2], *entries, lmIndex)) {
+        return 1;
+    }
+
+    Vocabulary check;
+    if (!check.Open(argv[2])) {
+        return 1;
+    }
+    std::cout << "Wrote " << argv[2] << ": " << check.GetKeyCount() << " keys, "
+              << check.GetWordCount() << " words"
+              << (check.HasLmIndices() ? ", with LM indices" : "") << std::endl;
+    return 0;
+}